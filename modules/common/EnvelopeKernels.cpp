@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "common/EnvelopeKernels.h"
+
+namespace
+{
+    //Values reduced side by side, enough to fill two AVX registers of doubles so the lanes of the
+    //reductions are independent of each other
+    const int numLanes = 8;
+
+    //Sum and sum of squares of a channel, each lane sums every numLanes-th value and the lanes are added
+    //pairwise at the end, so the order of the sums only depends on the length of the channel
+    void LaneSums(const double* data, size_t numValues, double& sum, double& sumSquares)
+    {
+        double laneSum[numLanes] = {0.0};
+        double laneSquares[numLanes] = {0.0};
+
+        size_t numBlocks = numValues / numLanes;
+        for (size_t block = 0; block < numBlocks; block++)
+        {
+            const double* blockData = &data[block * numLanes];
+#pragma omp simd
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                laneSum[lane] += blockData[lane];
+                laneSquares[lane] += blockData[lane] * blockData[lane];
+            }
+        }
+
+        for (size_t i = numBlocks * numLanes; i < numValues; i++)
+        {
+            laneSum[i % numLanes] += data[i];
+            laneSquares[i % numLanes] += data[i] * data[i];
+        }
+
+        for (int width = numLanes / 2; width > 0; width /= 2)
+        {
+            for (int lane = 0; lane < width; lane++)
+            {
+                laneSum[lane] += laneSum[lane + width];
+                laneSquares[lane] += laneSquares[lane + width];
+            }
+        }
+
+        sum = laneSum[0];
+        sumSquares = laneSquares[0];
+    }
+}
+
+void EnvelopeKernels::Peak(const double* values, const size_t* channelStart, int numChannels, double* peaks)
+{
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        const double* data = &values[channelStart[channel]];
+        size_t numValues = channelStart[channel + 1] - channelStart[channel];
+
+        //A NaN is never greater than the lane peak, so it is skipped as by a scalar comparison
+        double lanePeak[numLanes] = {0.0};
+        size_t numBlocks = numValues / numLanes;
+        for (size_t block = 0; block < numBlocks; block++)
+        {
+            const double* blockData = &data[block * numLanes];
+#pragma omp simd
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                double absValue = std::fabs(blockData[lane]);
+                lanePeak[lane] = (absValue > lanePeak[lane]) ? absValue : lanePeak[lane];
+            }
+        }
+
+        double peak = 0.0;
+        for (int lane = 0; lane < numLanes; lane++)
+            peak = std::max(peak, lanePeak[lane]);
+        for (size_t i = numBlocks * numLanes; i < numValues; i++)
+        {
+            double absValue = std::fabs(data[i]);
+            if (absValue > peak)
+                peak = absValue;
+        }
+
+        peaks[channel] = peak;
+    }
+}
+
+void EnvelopeKernels::Mean(const double* values, const size_t* channelStart, int numChannels, double* means)
+{
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        size_t numValues = channelStart[channel + 1] - channelStart[channel];
+        double sum, sumSquares;
+        LaneSums(&values[channelStart[channel]], numValues, sum, sumSquares);
+        means[channel] = (numValues > 0) ? sum / numValues : 0.0;
+    }
+}
+
+void EnvelopeKernels::Rms(const double* values, const size_t* channelStart, int numChannels, double* rms)
+{
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        size_t numValues = channelStart[channel + 1] - channelStart[channel];
+        double sum, sumSquares;
+        LaneSums(&values[channelStart[channel]], numValues, sum, sumSquares);
+        rms[channel] = (numValues > 0) ? std::sqrt(sumSquares / numValues) : 0.0;
+    }
+}
+
+void EnvelopeKernels::AbsPercentile(const double* values, const size_t* channelStart, int numChannels,
+                                    double percentile, double* percentiles)
+{
+    percentile = std::min(100.0, std::max(0.0, percentile));
+
+#pragma omp parallel
+    {
+        //The absolute values of a channel are partially sorted in a buffer of each thread
+        std::vector<double> absValues;
+
+#pragma omp for schedule(dynamic, 16)
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            const double* data = &values[channelStart[channel]];
+            size_t numValues = channelStart[channel + 1] - channelStart[channel];
+            if (numValues == 0)
+            {
+                percentiles[channel] = 0.0;
+                continue;
+            }
+
+            //A NaN has no rank, the percentile of a channel holding one is NaN as with numpy.percentile
+            absValues.resize(numValues);
+            bool hasNaN = false;
+            for (size_t i = 0; i < numValues; i++)
+            {
+                absValues[i] = std::fabs(data[i]);
+                hasNaN = hasNaN || std::isnan(absValues[i]);
+            }
+            if (hasNaN)
+            {
+                percentiles[channel] = std::numeric_limits<double>::quiet_NaN();
+                continue;
+            }
+
+            //The two values closest in rank to the percentile are found without sorting the channel
+            double rank = percentile / 100.0 * (numValues - 1);
+            size_t below = (size_t)std::floor(rank);
+            double fraction = rank - below;
+
+            std::nth_element(absValues.begin(), absValues.begin() + below, absValues.end());
+            double valueBelow = absValues[below];
+            double valueAbove = valueBelow;
+            if (fraction > 0.0 && below + 1 < numValues)
+                valueAbove = *std::min_element(absValues.begin() + below + 1, absValues.end());
+
+            percentiles[channel] = valueBelow + fraction * (valueAbove - valueBelow);
+        }
+    }
+}
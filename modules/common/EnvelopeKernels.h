@@ -0,0 +1,30 @@
+#ifndef ENVELOPE_KERNELS_H
+#define ENVELOPE_KERNELS_H
+
+#include <cstddef>
+
+//Kernels computing the envelopes of many response or ground motion histories at once. The histories,
+//or channels, are stored one after the other in a single contiguous array, channel c holding
+//values[channelStart[c]] to values[channelStart[c+1]-1], so records of different lengths are handled
+//without padding. Each channel is reduced in fixed lanes the compiler maps to SIMD registers, and the
+//channels are processed in parallel when OpenMP is available, with results identical for any number of
+//threads. An empty channel has all envelopes equal to 0, a channel holding a NaN has a NaN mean, rms and
+//percentile, as with numpy
+namespace EnvelopeKernels
+{
+    //Largest absolute value of each channel, NaN values are ignored
+    void Peak(const double* values, const size_t* channelStart, int numChannels, double* peaks);
+
+    //Mean of each channel
+    void Mean(const double* values, const size_t* channelStart, int numChannels, double* means);
+
+    //Root mean square of each channel
+    void Rms(const double* values, const size_t* channelStart, int numChannels, double* rms);
+
+    //Percentile, from 0 to 100, of the absolute values of each channel, interpolated linearly between the
+    //closest ranks like numpy.percentile does. Percentile 100 is the peak
+    void AbsPercentile(const double* values, const size_t* channelStart, int numChannels,
+                       double percentile, double* percentiles);
+}
+
+#endif
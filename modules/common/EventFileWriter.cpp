@@ -0,0 +1,168 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "common/EventFileWriter.h"
+
+namespace
+{
+//Formats a real the way jansson does, 17 significant digits, always with a dot or an exponent so the
+//value is read back as a real, and with no '+' or leading zeros in the exponent
+int FormatReal(char* buffer, size_t size, double value)
+{
+    int length = snprintf(buffer, size, "%.17g", value);
+    if (length < 0 || (size_t)length >= size)
+        return -1;
+
+    if (std::strchr(buffer, '.') == NULL && std::strchr(buffer, 'e') == NULL)
+    {
+        buffer[length++] = '.';
+        buffer[length++] = '0';
+        buffer[length] = '\0';
+    }
+
+    char* start = std::strchr(buffer, 'e');
+    if (start != NULL)
+    {
+        start++;
+        char* end = start + 1;
+        if (*start == '-')
+            start++;
+        while (*end == '0')
+            end++;
+        if (end != start)
+        {
+            std::memmove(start, end, length - (end - buffer) + 1);
+            length -= (int)(end - start);
+        }
+    }
+
+    return length;
+}
+
+bool WriteText(const char* text, size_t length, FILE* file)
+{
+    return std::fwrite(text, 1, length, file) == length;
+}
+}
+
+const double* EventFileWriter::Keep(std::vector<double>&& values)
+{
+    keptValues.push_back(std::move(values));
+    return keptValues.back().data();
+}
+
+json_t* EventFileWriter::Values(const double* values, size_t numValues)
+{
+    json_t* array = json_array();
+    valueArrays[array] = ValueArray{values, numValues};
+    return array;
+}
+
+bool EventFileWriter::Write(const json_t* root, const char* filename) const
+{
+    FILE* file = fopen(filename, "w");
+    if (file == NULL)
+        return false;
+
+    //Large buffer as the time series make up most of the file
+    std::vector<char> buffer(1 << 20);
+    setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+
+    bool written = WriteValue(root, file);
+
+    if (fclose(file) != 0)
+        written = false;
+
+    return written;
+}
+
+bool EventFileWriter::WriteValue(const json_t* value, FILE* file) const
+{
+    if (json_is_object(value))
+    {
+        if (!WriteText("{", 1, file))
+            return false;
+
+        const char* key;
+        json_t* member;
+        bool first = true;
+        json_object_foreach(const_cast<json_t*>(value), key, member)
+        {
+            if (!first && !WriteText(", ", 2, file))
+                return false;
+            first = false;
+
+            json_t* keyString = json_string(key);
+            bool written = WriteScalar(keyString, file);
+            json_decref(keyString);
+
+            if (!written || !WriteText(": ", 2, file) || !WriteValue(member, file))
+                return false;
+        }
+
+        return WriteText("}", 1, file);
+    }
+    else if (json_is_array(value))
+    {
+        auto valueArray = valueArrays.find(value);
+        if (valueArray != valueArrays.end())
+            return WriteValues(valueArray->second, file);
+
+        if (!WriteText("[", 1, file))
+            return false;
+
+        for (size_t i = 0; i < json_array_size(value); i++)
+        {
+            if (i > 0 && !WriteText(", ", 2, file))
+                return false;
+            if (!WriteValue(json_array_get(value, i), file))
+                return false;
+        }
+
+        return WriteText("]", 1, file);
+    }
+
+    return WriteScalar(value, file);
+}
+
+bool EventFileWriter::WriteScalar(const json_t* value, FILE* file) const
+{
+    char* text = json_dumps(value, JSON_ENCODE_ANY);
+    if (text == NULL)
+        return false;
+
+    bool written = WriteText(text, std::strlen(text), file);
+    free(text);
+
+    return written;
+}
+
+bool EventFileWriter::WriteValues(const ValueArray& array, FILE* file) const
+{
+    if (!WriteText("[", 1, file))
+        return false;
+
+    char buffer[64];
+    bool first = true;
+    for (size_t i = 0; i < array.numValues; i++)
+    {
+        //json_real does not accept nan or inf, so these values never made it into the array
+        if (!std::isfinite(array.values[i]))
+            continue;
+
+        int length = FormatReal(buffer, sizeof(buffer), array.values[i]);
+        if (length < 0)
+            return false;
+
+        if (!first && !WriteText(", ", 2, file))
+            return false;
+        first = false;
+
+        if (!WriteText(buffer, length, file))
+            return false;
+    }
+
+    return WriteText("]", 1, file);
+}
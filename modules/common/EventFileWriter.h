@@ -0,0 +1,43 @@
+#ifndef EVENT_FILE_WRITER_H
+#define EVENT_FILE_WRITER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+#include <jansson.h>
+
+//The EventFileWriter class writes an event file in the same format as json_dump_file with no flags,
+//but the values of large time series are written straight from their arrays instead of being added
+//to the json document one json_real at a time. Only the small part of the event describing the time
+//series is kept as json, so the memory used to write the file does not grow with the number of steps.
+class EventFileWriter
+{
+public:
+    //Keeps the values until the file is written and returns a pointer to them
+    const double* Keep(std::vector<double>&& values);
+
+    //Returns an empty array to put in the event in place of the values, the values are written in
+    //its place when the file is written and must stay valid until then
+    json_t* Values(const double* values, size_t numValues);
+
+    //Writes the document to file, returns false if the file could not be written
+    bool Write(const json_t* root, const char* filename) const;
+
+private:
+    struct ValueArray
+    {
+        const double* values;
+        size_t numValues;
+    };
+
+    bool WriteValue(const json_t* value, FILE* file) const;
+    bool WriteScalar(const json_t* value, FILE* file) const;
+    bool WriteValues(const ValueArray& array, FILE* file) const;
+
+    std::vector<std::vector<double>> keptValues;
+    std::map<const json_t*, ValueArray> valueArrays;
+};
+
+#endif
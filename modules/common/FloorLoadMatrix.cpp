@@ -0,0 +1,58 @@
+#include <algorithm>
+
+#include "common/FloorLoadMatrix.h"
+
+void FloorLoadMatrix::Assemble(int numFloors, int numTaps, const double* const* tapWeights, const std::vector<bool>& useTap)
+{
+    this->numFloors = numFloors;
+    rowStart.assign(1, 0);
+    taps.clear();
+    weights.clear();
+
+    for (int floor = 0; floor < numFloors; floor++)
+    {
+        for (int tap = 0; tap < numTaps; tap++)
+        {
+            double weight = tapWeights[tap][floor];
+            if (useTap[tap] && weight != 0.0)
+            {
+                taps.push_back(tap);
+                weights.push_back(weight);
+            }
+        }
+        rowStart.push_back(taps.size());
+    }
+}
+
+void FloorLoadMatrix::Multiply(const double* const* tapData, int numSteps, double factor, double* floorLoads) const
+{
+    //Steps are processed in blocks so the floor loads being accumulated stay in cache while the
+    //contributions of all taps of the floor are added. Floors are independent of each other, so they
+    //are computed in parallel without changing the order of the sums
+    const int blockSize = 2048;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int floor = 0; floor < numFloors; floor++)
+    {
+        double* loads = &floorLoads[(size_t)floor * numSteps];
+
+        for (int first = 0; first < numSteps; first += blockSize)
+        {
+            int last = std::min(numSteps, first + blockSize);
+
+            for (int j = first; j < last; j++)
+                loads[j] = 0.0;
+
+            for (int entry = rowStart[floor]; entry < rowStart[floor + 1]; entry++)
+            {
+                const double* data = tapData[taps[entry]];
+                double weight = weights[entry];
+                for (int j = first; j < last; j++)
+                    loads[j] = loads[j] + weight * data[j];
+            }
+
+            for (int j = first; j < last; j++)
+                loads[j] = factor * loads[j];
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef FLOOR_LOAD_MATRIX_H
+#define FLOOR_LOAD_MATRIX_H
+
+#include <vector>
+
+//The FloorLoadMatrix class maps the pressure coefficient histories of the taps to the load histories
+//of the floors. Only the nonzero tap weights of each floor are stored, so all floor load histories are
+//computed as a single sparse matrix product over the block of Cp histories.
+class FloorLoadMatrix
+{
+public:
+    //Assembles the matrix from the weights of each tap, tapWeights[tap][floor], for the taps with
+    //useTap set. Taps without useTap set and zero weights do not contribute to the floor loads
+    void Assemble(int numFloors, int numTaps, const double* const* tapWeights, const std::vector<bool>& useTap);
+
+    //Computes the load histories of all floors, floorLoads[floor*numSteps + step], from the Cp histories
+    //of the taps, tapData[tap][step], scaled by factor. For each value the tap contributions are summed
+    //in tap order, so results are identical to summing over the taps one step at a time
+    void Multiply(const double* const* tapData, int numSteps, double factor, double* floorLoads) const;
+
+    int NumFloors() const { return numFloors; }
+
+private:
+    int numFloors = 0;
+
+    //Compressed rows, row f holds entries rowStart[f] to rowStart[f+1]-1
+    std::vector<int> rowStart;
+    std::vector<int> taps;
+    std::vector<double> weights;
+};
+
+#endif
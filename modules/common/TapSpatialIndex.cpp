@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "common/TapSpatialIndex.h"
+
+void TapSpatialIndex::AddTap(int face, double locX, double locY, int tap)
+{
+    FaceGrid& grid = faces[face];
+    grid.locX.push_back(locX);
+    grid.locY.push_back(locY);
+    grid.taps.push_back(tap);
+}
+
+void TapSpatialIndex::Build()
+{
+    for (auto& entry : faces)
+    {
+        FaceGrid& grid = entry.second;
+        int numTaps = grid.taps.size();
+
+        double maxX = grid.locX[0], maxY = grid.locY[0];
+        grid.minX = grid.locX[0];
+        grid.minY = grid.locY[0];
+        for (int i = 1; i < numTaps; i++)
+        {
+            grid.minX = std::min(grid.minX, grid.locX[i]);
+            grid.minY = std::min(grid.minY, grid.locY[i]);
+            maxX = std::max(maxX, grid.locX[i]);
+            maxY = std::max(maxY, grid.locY[i]);
+        }
+
+        //Choose the number of cells in each direction following the aspect ratio of the taps,
+        //so that there is about one tap per cell
+        double lengthX = maxX - grid.minX;
+        double lengthY = maxY - grid.minY;
+        if (lengthX > 0.0 && lengthY > 0.0)
+        {
+            double cellSize = std::sqrt(lengthX * lengthY / numTaps);
+            grid.numCellsX = std::max(1, std::min(numTaps, (int)std::ceil(lengthX / cellSize)));
+            grid.numCellsY = std::max(1, std::min(numTaps, (int)std::ceil(lengthY / cellSize)));
+        }
+        else
+        {
+            grid.numCellsX = lengthX > 0.0 ? numTaps : 1;
+            grid.numCellsY = lengthY > 0.0 ? numTaps : 1;
+        }
+        grid.cellSizeX = lengthX > 0.0 ? lengthX / grid.numCellsX : 1.0;
+        grid.cellSizeY = lengthY > 0.0 ? lengthY / grid.numCellsY : 1.0;
+
+        //Counting sort of the taps into cells, keeping taps in each cell in their original order
+        int numCells = grid.numCellsX * grid.numCellsY;
+        std::vector<int> tapCell(numTaps);
+        grid.cellStart.assign(numCells + 1, 0);
+        for (int i = 0; i < numTaps; i++)
+        {
+            tapCell[i] = grid.CellY(grid.locY[i]) * grid.numCellsX + grid.CellX(grid.locX[i]);
+            grid.cellStart[tapCell[i] + 1]++;
+        }
+        for (int c = 0; c < numCells; c++)
+            grid.cellStart[c + 1] += grid.cellStart[c];
+
+        std::vector<int> next(grid.cellStart.begin(), grid.cellStart.end() - 1);
+        grid.cellEntries.resize(numTaps);
+        for (int i = 0; i < numTaps; i++)
+            grid.cellEntries[next[tapCell[i]]++] = i;
+    }
+}
+
+int TapSpatialIndex::FindNearest(int face, double locX, double locY) const
+{
+    auto entry = faces.find(face);
+    if (entry == faces.end())
+        return -1;
+
+    const FaceGrid& grid = entry->second;
+    int cellX = grid.CellX(locX);
+    int cellY = grid.CellY(locY);
+
+    int nearestTap = -1;
+    double nearestDistance = std::numeric_limits<double>::max();
+
+    //Search rings of cells of increasing size around the cell containing the point until no
+    //tap outside the searched block can be closer than the nearest tap found
+    for (int ring = 0;; ring++)
+    {
+        int firstX = cellX - ring, lastX = cellX + ring;
+        int firstY = cellY - ring, lastY = cellY + ring;
+
+        for (int j = std::max(firstY, 0); j <= std::min(lastY, grid.numCellsY - 1); j++)
+        {
+            bool edgeRow = (j == firstY || j == lastY);
+            for (int i = std::max(firstX, 0); i <= std::min(lastX, grid.numCellsX - 1); i++)
+            {
+                if (!edgeRow && i != firstX && i != lastX)
+                    continue;
+
+                int cell = j * grid.numCellsX + i;
+                for (int k = grid.cellStart[cell]; k < grid.cellStart[cell + 1]; k++)
+                {
+                    int entryIndex = grid.cellEntries[k];
+                    double deltaX = grid.locX[entryIndex] - locX;
+                    double deltaY = grid.locY[entryIndex] - locY;
+                    double dist = deltaX * deltaX + deltaY * deltaY;
+                    int tap = grid.taps[entryIndex];
+                    if (dist < nearestDistance || (dist == nearestDistance && tap < nearestTap))
+                    {
+                        nearestTap = tap;
+                        nearestDistance = dist;
+                    }
+                }
+            }
+        }
+
+        //Distance from the point to the nearest side of the block that still has cells beyond it,
+        //reduced slightly so rounding in the cell assignment can never end the search early
+        bool cellsBeyond = false;
+        double bound = std::numeric_limits<double>::max();
+        if (firstX > 0)
+        {
+            cellsBeyond = true;
+            bound = std::min(bound, locX - (grid.minX + firstX * grid.cellSizeX));
+        }
+        if (lastX < grid.numCellsX - 1)
+        {
+            cellsBeyond = true;
+            bound = std::min(bound, grid.minX + (lastX + 1) * grid.cellSizeX - locX);
+        }
+        if (firstY > 0)
+        {
+            cellsBeyond = true;
+            bound = std::min(bound, locY - (grid.minY + firstY * grid.cellSizeY));
+        }
+        if (lastY < grid.numCellsY - 1)
+        {
+            cellsBeyond = true;
+            bound = std::min(bound, grid.minY + (lastY + 1) * grid.cellSizeY - locY);
+        }
+
+        if (!cellsBeyond)
+            break;
+
+        bound -= 1.0e-9 * std::max(grid.cellSizeX, grid.cellSizeY);
+        if (nearestTap >= 0 && bound > 0.0 && nearestDistance < bound * bound)
+            break;
+    }
+
+    return nearestTap;
+}
+
+int TapSpatialIndex::FaceGrid::CellX(double x) const
+{
+    double cell = std::floor((x - minX) / cellSizeX);
+    if (!(cell > 0.0))
+        return 0;
+    return cell < numCellsX - 1 ? (int)cell : numCellsX - 1;
+}
+
+int TapSpatialIndex::FaceGrid::CellY(double y) const
+{
+    double cell = std::floor((y - minY) / cellSizeY);
+    if (!(cell > 0.0))
+        return 0;
+    return cell < numCellsY - 1 ? (int)cell : numCellsY - 1;
+}
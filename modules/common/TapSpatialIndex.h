@@ -0,0 +1,49 @@
+#ifndef TAP_SPATIAL_INDEX_H
+#define TAP_SPATIAL_INDEX_H
+
+#include <map>
+#include <vector>
+
+//The TapSpatialIndex class finds the pressure tap nearest to a point on a building face.
+//Taps of each face are bucketed into a uniform grid sized to hold about one tap per cell,
+//so a query only visits the cells around the point instead of scanning every tap.
+class TapSpatialIndex
+{
+public:
+    //Adds a tap at location (locX, locY) on a face, tap is the index of the tap in the caller's array
+    void AddTap(int face, double locX, double locY, int tap);
+
+    //Builds the grids of all faces, must be called after all taps are added and before any query
+    void Build();
+
+    //Returns the index of the tap on the face nearest to (locX, locY), -1 if the face has no taps.
+    //Ties are resolved to the lowest tap index, matching a linear scan over the taps
+    int FindNearest(int face, double locX, double locY) const;
+
+private:
+    //Grid over the taps of a single face
+    struct FaceGrid
+    {
+        std::vector<double> locX;
+        std::vector<double> locY;
+        std::vector<int> taps;
+
+        double minX = 0.0;
+        double minY = 0.0;
+        double cellSizeX = 1.0;
+        double cellSizeY = 1.0;
+        int numCellsX = 1;
+        int numCellsY = 1;
+
+        //Start of each cell in cellEntries, cell c holds entries cellStart[c] to cellStart[c+1]-1
+        std::vector<int> cellStart;
+        std::vector<int> cellEntries;
+
+        int CellX(double x) const;
+        int CellY(double y) const;
+    };
+
+    std::map<int, FaceGrid> faces;
+};
+
+#endif
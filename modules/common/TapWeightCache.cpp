@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "common/TapWeightCache.h"
+
+namespace
+{
+//The last character is the format version, which is also raised when the weights are computed
+//differently so older files are replaced
+const char CacheMagic[8] = {'T', 'A', 'P', 'W', 'G', 'T', 'S', '2'};
+
+//64 bit FNV-1a hash
+uint64_t Hash(uint64_t hash, const void* bytes, size_t size)
+{
+    const unsigned char* data = static_cast<const unsigned char*>(bytes);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t Checksum(const double* forces, const double* moments, size_t size)
+{
+    uint64_t checksum = Hash(14695981039346656037ULL, forces, size * sizeof(double));
+    return Hash(checksum, moments, size * sizeof(double));
+}
+}
+
+void TapWeightCache::Add(double value)
+{
+    AddBytes(&value, sizeof(value));
+}
+
+void TapWeightCache::Add(int value)
+{
+    AddBytes(&value, sizeof(value));
+}
+
+void TapWeightCache::AddBytes(const void* bytes, size_t size)
+{
+    //The hash names the file and the bytes themselves are stored in it, so files are only used for
+    //exactly the same key
+    key = Hash(key, bytes, size);
+    const unsigned char* data = static_cast<const unsigned char*>(bytes);
+    keyBytes.insert(keyBytes.end(), data, data + size);
+}
+
+std::string TapWeightCache::Filename(const char* name) const
+{
+#ifdef _WIN32
+    //The local application data folder is private to the user
+    const char* base = std::getenv("LOCALAPPDATA");
+    if (base == nullptr || base[0] == '\0')
+        return "";
+
+    std::string directory = std::string(base) + "\\SimCenter";
+    _mkdir(directory.c_str());
+    struct _stat status;
+    if (_stat(directory.c_str(), &status) != 0 || (status.st_mode & _S_IFDIR) == 0)
+        return "";
+#else
+    std::string directory;
+    const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    if (cacheHome != nullptr && cacheHome[0] == '/')
+        directory = cacheHome;
+    else if (home != nullptr && home[0] == '/')
+        directory = std::string(home) + "/.cache";
+    else
+        return "";
+
+    mkdir(directory.c_str(), 0700);
+    directory += "/SimCenter";
+    mkdir(directory.c_str(), 0700);
+
+    //The directory has to be a real directory of the user that nobody else can write to, otherwise
+    //another user could plant weights in it
+    struct stat status;
+    if (lstat(directory.c_str(), &status) != 0 || !S_ISDIR(status.st_mode) || status.st_uid != geteuid())
+        return "";
+    if ((status.st_mode & 0077) != 0 && chmod(directory.c_str(), 0700) != 0)
+        return "";
+#endif
+
+    std::ostringstream filename;
+    filename << directory << "/" << name << "-" << std::hex << key << ".bin";
+    return filename.str();
+}
+
+bool TapWeightCache::Load(const std::string& filename, double* forces, double* moments, size_t size) const
+{
+    if (filename.empty())
+        return false;
+
+#ifndef _WIN32
+    struct stat status;
+    if (lstat(filename.c_str(), &status) != 0 || !S_ISREG(status.st_mode) || status.st_uid != geteuid())
+        return false;
+#endif
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    char magic[sizeof(CacheMagic)];
+    uint64_t fileKeySize = 0, fileSize = 0, fileChecksum = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&fileKeySize), sizeof(fileKeySize));
+
+    bool valid = file && std::memcmp(magic, CacheMagic, sizeof(CacheMagic)) == 0 && fileKeySize == keyBytes.size();
+    if (valid)
+    {
+        std::vector<unsigned char> fileKeyBytes(keyBytes.size());
+        file.read(reinterpret_cast<char*>(fileKeyBytes.data()), fileKeyBytes.size());
+        file.read(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
+        file.read(reinterpret_cast<char*>(&fileChecksum), sizeof(fileChecksum));
+        valid = file && fileKeyBytes == keyBytes && fileSize == size;
+    }
+
+    //Weights are only copied out once the whole file has been read and checked
+    std::vector<double> weights(valid ? 2 * size : 0);
+    if (valid)
+    {
+        file.read(reinterpret_cast<char*>(weights.data()), weights.size() * sizeof(double));
+        valid = file && file.peek() == std::ifstream::traits_type::eof() &&
+                Checksum(weights.data(), weights.data() + size, size) == fileChecksum;
+    }
+    file.close();
+
+    if (!valid)
+    {
+        std::remove(filename.c_str());
+        return false;
+    }
+
+    std::copy(weights.begin(), weights.begin() + size, forces);
+    std::copy(weights.begin() + size, weights.end(), moments);
+
+    return true;
+}
+
+bool TapWeightCache::Save(const std::string& filename, const double* forces, const double* moments, size_t size) const
+{
+    if (filename.empty())
+        return false;
+
+    std::string partFilename = filename + "." + std::to_string(std::random_device()()) + ".part";
+    std::ofstream file(partFilename, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    uint64_t keySize = keyBytes.size(), fileSize = size, checksum = Checksum(forces, moments, size);
+    file.write(CacheMagic, sizeof(CacheMagic));
+    file.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+    file.write(reinterpret_cast<const char*>(keyBytes.data()), keyBytes.size());
+    file.write(reinterpret_cast<const char*>(&fileSize), sizeof(fileSize));
+    file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+    file.write(reinterpret_cast<const char*>(forces), size * sizeof(double));
+    file.write(reinterpret_cast<const char*>(moments), size * sizeof(double));
+    file.close();
+
+    //Renaming fails on Windows when another run already wrote the file, which then holds the same weights
+    if (!file || std::rename(partFilename.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(partFilename.c_str());
+        return false;
+    }
+
+    return true;
+}
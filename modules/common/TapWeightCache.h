@@ -0,0 +1,42 @@
+#ifndef TAP_WEIGHT_CACHE_H
+#define TAP_WEIGHT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//The TapWeightCache class stores the floor force and moment weights of the taps on disk, keyed by the
+//building geometry, mesh and tap layout they were computed for, so repeated runs with the same layout
+//can skip integrating the faces
+class TapWeightCache
+{
+public:
+    //Adds a value describing the geometry or tap layout to the key
+    void Add(double value);
+    void Add(int value);
+
+    //Returns the location of the cache file for the current key in the cache directory of the user,
+    //SimCenter in XDG_CACHE_HOME or ~/.cache, or in LOCALAPPDATA on Windows, so runs in different
+    //working directories share it. The directory is created private to the user. Returns an empty
+    //string, which disables the cache, when there is no such directory or another user can write to it
+    std::string Filename(const char* name) const;
+
+    //Reads the weights from file, returns false if the file is missing, is not a regular file owned by
+    //the user, was written for another key or its weights do not match their checksum. Such files are
+    //removed so the next Save replaces them
+    bool Load(const std::string& filename, double* forces, double* moments, size_t size) const;
+
+    //Writes the weights to file with the full key and a checksum of the weights, returns false if the
+    //file could not be written. The file is written under a unique name and then renamed, so runs in
+    //parallel never read a partly written file
+    bool Save(const std::string& filename, const double* forces, const double* moments, size_t size) const;
+
+private:
+    void AddBytes(const void* bytes, size_t size);
+
+    uint64_t key = 14695981039346656037ULL;
+    std::vector<unsigned char> keyBytes;
+};
+
+#endif
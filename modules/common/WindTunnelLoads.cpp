@@ -0,0 +1,308 @@
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "common/TapSpatialIndex.h"
+#include "common/TapWeightCache.h"
+#include "common/WindTunnelLoads.h"
+
+int WindTunnelLoads::LoadTaps(const json_t* tapData, int numSteps,
+                              double height, double breadth, double depth,
+                              double modelHeight, double modelBreadth, double modelDepth,
+                              bool scaleTaps)
+{
+    json_t* tapLocations = json_object_get(tapData, "tapLocations");
+    json_t* tapCpRecords = json_object_get(tapData, "pressureCoefficients");
+
+    this->numSteps = numSteps;
+    numTaps = json_array_size(tapLocations);
+
+    //Index the Cp records by tap id so each tap finds its record in constant time,
+    //if an id is repeated the first record is used
+    int numCp = json_array_size(tapCpRecords);
+    std::unordered_map<int, const json_t*> cpRecords;
+    cpRecords.reserve(numCp);
+    for (int j = 0; j < numCp; j++)
+    {
+        json_t* jsonCp = json_array_get(tapCpRecords, j);
+        int tapId = json_integer_value(json_object_get(jsonCp, "id"));
+        cpRecords.emplace(tapId, jsonCp);
+    }
+
+    tapFace.assign(numTaps, 0);
+    tapLocX.assign(numTaps, 0.0);
+    tapLocY.assign(numTaps, 0.0);
+    tapCp.assign((size_t)numTaps * numSteps, 0.0);
+
+    //The json document is only read here, so the taps can be loaded in parallel
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int i = 0; i < numTaps; i++)
+    {
+        json_t* jsonTap = json_array_get(tapLocations, i);
+        int face = json_integer_value(json_object_get(jsonTap, "face"));
+        int tapId = json_integer_value(json_object_get(jsonTap, "id"));
+        double locX = json_number_value(json_object_get(jsonTap, "xLoc"));
+        double locY = json_number_value(json_object_get(jsonTap, "yLoc"));
+
+        //Scale the tap position to the building (prototype) dimensions, faces 1 to 4 are the walls
+        //and anything else the roof
+        if (scaleTaps)
+        {
+            if (face == 1 || face == 3)
+            {
+                locX = locX * breadth / modelBreadth;
+                locY = locY * height / modelHeight;
+            }
+            else if (face == 2 || face == 4)
+            {
+                locX = locX * depth / modelDepth;
+                locY = locY * height / modelHeight;
+            }
+            else
+            {
+                locX = locX * breadth / modelBreadth;
+                locY = locY * height / modelDepth;
+            }
+        }
+
+        tapFace[i] = face;
+        tapLocX[i] = locX;
+        tapLocY[i] = locY;
+
+        auto cpRecord = cpRecords.find(tapId);
+        if (cpRecord != cpRecords.end())
+        {
+            json_t* arrayData = json_object_get(cpRecord->second, "data");
+            int numData = json_array_size(arrayData);
+            if (numData > numSteps)
+                numData = numSteps;
+            double* data = &tapCp[(size_t)i * numSteps];
+            for (int k = 0; k < numData; k++)
+                data[k] = json_real_value(json_array_get(arrayData, k));
+        }
+    }
+
+    return numTaps;
+}
+
+void WindTunnelLoads::ComputeWeights(double height, double breadth, double depth, int numFloors,
+                                     int numDivisionX, int numDivisionY, CellSplit split, const char* cacheName)
+{
+    this->numFloors = numFloors;
+    size_t numWeights = (size_t)numTaps * numFloors;
+    tapForces.assign(numWeights, 0.0);
+    tapMoments.assign(numWeights, 0.0);
+
+    //The weights only depend on the building geometry, mesh and tap layout, so they are cached in
+    //the temporary directory and repeated runs with the same layout, such as the samples of a
+    //study, skip meshing the faces
+    TapWeightCache weightCache;
+    weightCache.Add(height);
+    weightCache.Add(breadth);
+    weightCache.Add(depth);
+    weightCache.Add(numFloors);
+    weightCache.Add(numDivisionX);
+    weightCache.Add(numDivisionY);
+    weightCache.Add((int)split);
+    for (int i = 0; i < numTaps; i++)
+    {
+        weightCache.Add(tapFace[i]);
+        weightCache.Add(tapLocX[i]);
+        weightCache.Add(tapLocY[i]);
+    }
+
+    std::string cacheFile = weightCache.Filename(cacheName);
+    if (!weightCache.Load(cacheFile, tapForces.data(), tapMoments.data(), numWeights))
+    {
+        //Index the taps of each face once so the nearest tap to each mesh cell is found without
+        //scanning all taps
+        TapSpatialIndex tapIndex;
+        for (int i = 0; i < numTaps; i++)
+            tapIndex.AddTap(tapFace[i], tapLocX[i], tapLocY[i], i);
+        tapIndex.Build();
+
+        //Each face only adds to the weights of its own taps, so the faces are meshed in parallel
+        const double faceLength[4] = {breadth, depth, breadth, depth};
+#pragma omp parallel for
+        for (int face = 1; face <= 4; face++)
+            AddFaceWeights(tapIndex, height, faceLength[face - 1], numDivisionX, numDivisionY, face, split);
+
+        weightCache.Save(cacheFile, tapForces.data(), tapMoments.data(), numWeights);
+    }
+
+    //Forces in x come from the taps on faces 1 and 3, forces in y from faces 2 and 4,
+    //and moments about z from all taps
+    std::vector<const double*> forceWeights(numTaps), momentWeights(numTaps);
+    std::vector<bool> xFaceTap(numTaps), yFaceTap(numTaps), anyFaceTap(numTaps, true);
+    for (int i = 0; i < numTaps; i++)
+    {
+        forceWeights[i] = &tapForces[(size_t)i * numFloors];
+        momentWeights[i] = &tapMoments[(size_t)i * numFloors];
+        xFaceTap[i] = (tapFace[i] == 1 || tapFace[i] == 3);
+        yFaceTap[i] = (tapFace[i] == 2 || tapFace[i] == 4);
+    }
+
+    forceX.Assemble(numFloors, numTaps, forceWeights.data(), xFaceTap);
+    forceY.Assemble(numFloors, numTaps, forceWeights.data(), yFaceTap);
+    momentZ.Assemble(numFloors, numTaps, momentWeights.data(), anyFaceTap);
+}
+
+//
+// The face is divided into numFloors stories, and each story into numDivisionX x numDivisionY cells. The
+// load on each cell is taken as a point load at its center, equal in magnitude to the cell area, and is
+// split between the floors below and above it using the simply supported beam formula. The distance of
+// the cell center from the center line of the face gives the moments on the floors. The forces and
+// moments are added to the weights of the tap nearest to the cell center.
+//
+
+void WindTunnelLoads::AddFaceWeights(const TapSpatialIndex& tapIndex, double height, double length,
+                                     int numDivisionX, int numDivisionY, int face, CellSplit split)
+{
+    double heightStory = height / (1.0 * numFloors);
+    double dY = heightStory / numDivisionY;
+    double dX = length / numDivisionX;
+    double centerLine = length / 2.0;
+    double A = dY * dX;
+    double locY = dY / 2.0;
+
+    //Pressure on faces 3 and 4 acts in the negative x and y directions
+    bool positiveFace = (face == 1 || face == 2);
+
+    for (int i = 0; i < numFloors; i++)
+    {
+        for (int j = 0; j < numDivisionY; j++)
+        {
+            double locX = dX / 2.0;
+            double Rabove, Rbelow;
+            if (split == AboveGround)
+            {
+                Rabove = locY * A / heightStory;
+                Rbelow = (heightStory - locY) * A / heightStory;
+            }
+            else
+            {
+                Rabove = (locY - i * heightStory) / heightStory * A;
+                Rbelow = (heightStory - (locY - i * heightStory)) / heightStory * A;
+            }
+
+            for (int k = 0; k < numDivisionX; k++)
+            {
+                double Mabove = Rabove * (locX - centerLine);
+                double Mbelow = Rbelow * (locX - centerLine);
+
+                int tap = tapIndex.FindNearest(face, locX, locY);
+                if (tap >= 0)
+                {
+                    double* forces = &tapForces[(size_t)tap * numFloors];
+                    double* moments = &tapMoments[(size_t)tap * numFloors];
+
+                    //No load is added to the ground floor
+                    if (i != 0)
+                    {
+                        if (positiveFace)
+                            forces[i - 1] = forces[i - 1] + Rbelow;
+                        else
+                            forces[i - 1] = forces[i - 1] - Rbelow;
+
+                        moments[i - 1] = moments[i - 1] + Mbelow;
+                    }
+
+                    if (positiveFace)
+                        forces[i] = forces[i] + Rabove;
+                    else
+                        forces[i] = forces[i] - Rabove;
+
+                    moments[i] = moments[i] + Mabove;
+                }
+                locX += dX;
+            }
+            locY += dY;
+        }
+    }
+}
+
+void WindTunnelLoads::ComputeFloorLoads(double factor, std::vector<double>& floorFx,
+                                        std::vector<double>& floorFy, std::vector<double>& floorMz) const
+{
+    std::vector<const double*> tapHistories(numTaps);
+    for (int i = 0; i < numTaps; i++)
+        tapHistories[i] = &tapCp[(size_t)i * numSteps];
+
+    size_t numValues = (size_t)numFloors * numSteps;
+    floorFx.resize(numValues);
+    floorFy.resize(numValues);
+    floorMz.resize(numValues);
+
+    forceX.Multiply(tapHistories.data(), numSteps, factor, floorFx.data());
+    forceY.Multiply(tapHistories.data(), numSteps, factor, floorFy.data());
+    momentZ.Multiply(tapHistories.data(), numSteps, factor, floorMz.data());
+}
+
+void WindTunnelLoads::AddToEvent(json_t* outputEvent, double factor, double dT, EventFileWriter& eventWriter) const
+{
+    std::vector<double> floorFx, floorFy, floorMz;
+    ComputeFloorLoads(factor, floorFx, floorFy, floorMz);
+
+    //The floor load histories are written straight to the event file by the event writer instead of
+    //being added to the json document one value at a time
+    const double* loadsX = eventWriter.Keep(std::move(floorFx));
+    const double* loadsY = eventWriter.Keep(std::move(floorFy));
+    const double* loadsRZ = eventWriter.Keep(std::move(floorMz));
+
+    json_t* timeSeriesArray = json_array();
+    json_t* patternArray = json_array();
+    json_t* pressureArray = json_array();
+
+    //Forces in x and y and moments about z of each floor, with the load pattern applying them
+    const char* seriesNames[3] = {"Fx_%d", "Fy_%d", "Mz_%d"};
+    const double* seriesLoads[3] = {loadsX, loadsY, loadsRZ};
+    const int seriesDof[3] = {1, 2, 6};
+
+    for (int i = 0; i < numFloors; i++)
+    {
+        std::string floor = std::to_string(i + 1);
+        char name[50];
+
+        for (int series = 0; series < 3; series++)
+        {
+            sprintf(name, seriesNames[series], i + 1);
+
+            json_t* timeSeries = json_object();
+            json_object_set_new(timeSeries, "name", json_string(name));
+            json_object_set_new(timeSeries, "dT", json_real(dT));
+            json_object_set_new(timeSeries, "type", json_string("Value"));
+            json_object_set_new(timeSeries, "data", eventWriter.Values(&seriesLoads[series][(size_t)i * numSteps], numSteps));
+            json_array_append_new(timeSeriesArray, timeSeries);
+
+            json_t* pattern = json_object();
+            json_object_set_new(pattern, "name", json_string(name));
+            json_object_set_new(pattern, "timeSeries", json_string(name));
+            json_object_set_new(pattern, "type", json_string("WindFloorLoad"));
+            json_object_set_new(pattern, "floor", json_string(floor.c_str()));
+            json_object_set_new(pattern, "dof", json_integer(seriesDof[series]));
+            json_array_append_new(patternArray, pattern);
+        }
+
+        //Story pressures are not computed, the story is named after the last time series of the floor
+        json_t* pressureObject = json_object();
+        json_t* pressureStoryArray = json_array();
+        json_array_append_new(pressureStoryArray, json_real(0.0));
+        json_array_append_new(pressureStoryArray, json_real(0.0));
+        json_object_set_new(pressureObject, "pressure", pressureStoryArray);
+        json_object_set_new(pressureObject, "story", json_string(name));
+        json_array_append_new(pressureArray, pressureObject);
+    }
+
+    json_t* units = json_object();
+    json_object_set_new(units, "force", json_string("KN"));
+    json_object_set_new(units, "length", json_string("m"));
+    json_object_set_new(units, "time", json_string("sec"));
+    json_object_set_new(outputEvent, "units", units);
+
+    json_object_set_new(outputEvent, "timeSeries", timeSeriesArray);
+    json_object_set_new(outputEvent, "pattern", patternArray);
+    json_object_set_new(outputEvent, "pressure", pressureArray);
+    json_object_set_new(outputEvent, "dT", json_real(dT));
+    json_object_set_new(outputEvent, "numSteps", json_integer(numSteps));
+}
@@ -0,0 +1,77 @@
+#ifndef WIND_TUNNEL_LOADS_H
+#define WIND_TUNNEL_LOADS_H
+
+#include <vector>
+
+#include <jansson.h>
+
+#include "common/EventFileWriter.h"
+#include "common/FloorLoadMatrix.h"
+
+class TapSpatialIndex;
+
+//The WindTunnelLoads class computes the floor load histories of a building from the pressure coefficient
+//histories measured at the taps of a wind tunnel model. It is the engine shared by the HighRiseTPU,
+//LowRiseTPU, NonIsolatedLowRiseTPU and WindTunnelExperiment applications: the taps are loaded once,
+//each face is meshed and every mesh cell is assigned to its nearest tap, and the floor loads are computed
+//as sparse matrix products over the Cp histories. Loading, meshing and the products run in parallel when
+//OpenMP is available, with results identical for any number of threads.
+class WindTunnelLoads
+{
+public:
+    //How the load on a mesh cell is split between the floors below and above the cell
+    enum CellSplit
+    {
+        //In proportion to the height of the cell above the ground, as the TPU high rise, non isolated
+        //low rise and wind tunnel experiment events have always done
+        AboveGround,
+        //In proportion to the height of the cell above the floor below, as the TPU low rise event does
+        AboveFloor
+    };
+
+    //Reads the taps and their Cp histories from the tapLocations and pressureCoefficients of the
+    //experiment data. If scaleTaps is set the tap positions are scaled from the model to the building,
+    //otherwise the model positions are used. Taps without a Cp record are given a zero history.
+    //Returns the number of taps
+    int LoadTaps(const json_t* tapData, int numSteps,
+                 double height, double breadth, double depth,
+                 double modelHeight, double modelBreadth, double modelDepth,
+                 bool scaleTaps);
+
+    //Computes the force and moment weights of the taps at each floor for a mesh of numDivisionX by
+    //numDivisionY cells per story and face. The weights are read from the cache file named after
+    //cacheName in the temporary directory when it was written for the same geometry, mesh and tap
+    //layout, and are written to it otherwise
+    void ComputeWeights(double height, double breadth, double depth, int numFloors,
+                        int numDivisionX, int numDivisionY, CellSplit split, const char* cacheName);
+
+    //Computes the load histories of all floors, floorFx[floor*numSteps + step] and likewise for the
+    //force in y and moment about z, from the Cp histories scaled by factor
+    void ComputeFloorLoads(double factor, std::vector<double>& floorFx,
+                           std::vector<double>& floorFy, std::vector<double>& floorMz) const;
+
+    //Computes the floor loads and adds their units, time series, load patterns and pressures to the
+    //output event, the floor load histories are handed to the event writer to be written to file
+    void AddToEvent(json_t* outputEvent, double factor, double dT, EventFileWriter& eventWriter) const;
+
+private:
+    void AddFaceWeights(const TapSpatialIndex& tapIndex, double height, double length,
+                        int numDivisionX, int numDivisionY, int face, CellSplit split);
+
+    int numTaps = 0;
+    int numSteps = 0;
+    int numFloors = 0;
+
+    std::vector<int> tapFace;
+    std::vector<double> tapLocX;
+    std::vector<double> tapLocY;
+
+    //Cp histories, forces and moments of the taps, one row per tap
+    std::vector<double> tapCp;
+    std::vector<double> tapForces;
+    std::vector<double> tapMoments;
+
+    FloorLoadMatrix forceX, forceY, momentZ;
+};
+
+#endif
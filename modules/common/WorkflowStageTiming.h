@@ -0,0 +1,20 @@
+#ifndef WORKFLOW_STAGE_TIMING_H
+#define WORKFLOW_STAGE_TIMING_H
+
+//Bash functions a workflow driver writes before the stages of a sample when stageTiming is set. After
+//each stage the driver calls simCenterTime with the name of the stage, which appends the wall time of
+//the stage to workflow.timing in the sample directory. The stages still run one after the other, the
+//times only show where a sample spends its time
+static const char* const stageTimingFunctions = R"(rm -f workflow.timing
+simCenterNow() {
+  if [ -n "$EPOCHREALTIME" ]; then echo "${EPOCHREALTIME/,/.}"; else date +%s; fi
+}
+simCenterTime() {
+  local now=$(simCenterNow)
+  awk -v stage="$1" -v start="$simCenterStart" -v end="$now" 'BEGIN { printf "%s %.3f\n", stage, end - start }' >> workflow.timing
+  simCenterStart=$now
+}
+simCenterStart=$(simCenterNow)
+)";
+
+#endif
@@ -10,27 +10,16 @@
 
 #include <jansson.h>
 #include <common/Units.h>
+#include <common/EventFileWriter.h>
+#include <common/WindTunnelLoads.h>
 
 //#include <python2.7/Python.h>
 
-typedef struct tapData {
-  double locX;
-  double locY;
-  int face;
-  int id;
-  double *forces;
-  double *moments;
-  double *data;
-} TAP;
-
-
 //
 // some functions define at end of file
 //
 
-TAP *findNearestTAP(TAP *, int numTaps,  double locX, double locY, int face);
-int addForcesFace(TAP *theTAPS, int numTaps, double height, double length, int numDivisonX, int numDivisonY, int face, int numFloors);
-int addEvent(json_t *input, json_t *currentEvent, json_t *outputEvent, bool getRV);
+int addEvent(json_t *input, json_t *currentEvent, json_t *outputEvent, bool getRV, EventFileWriter &eventWriter);
 
 int 
 callLowRise_TPU(const char *shape,   
@@ -79,6 +68,9 @@ main(int argc, char **argv) {
   json_t *outputEventsArray = json_array(); 
   json_t *rvArray = json_array(); 
 
+  // time series of the floor loads are written to file by the event writer
+  EventFileWriter eventWriter;
+
   //
   // load INPUT file, loop over events
   //
@@ -129,7 +121,7 @@ main(int argc, char **argv) {
       json_object_set(outputEvent,"units",units);
 
       // call function to fill in event details .. depends on getRV flag what is actually done
-      addEvent(generalInformation, inputEvent, outputEvent, doRV);
+      addEvent(generalInformation, inputEvent, outputEvent, doRV, eventWriter);
 
       json_array_append(outputEventsArray, outputEvent);
     }
@@ -141,13 +133,16 @@ main(int argc, char **argv) {
   json_object_set(rootEvent,"Events",outputEventsArray);
 
   // dump the event file
-  json_dump_file(rootEvent,filenameEVENT,0);
+  if (!eventWriter.Write(rootEvent,filenameEVENT)) {
+    std::cerr << "FATAL ERROR - could not write event file " << filenameEVENT << "\n";
+    exit(-1);
+  }
 
   // done
   return 0;
 }
 
-int addEvent(json_t *generalInfo, json_t *currentEvent, json_t *outputEvent, bool getRV) {
+int addEvent(json_t *generalInfo, json_t *currentEvent, json_t *outputEvent, bool getRV, EventFileWriter &eventWriter) {
 
     if (getRV == false) {
 
@@ -268,227 +263,43 @@ int addEvent(json_t *generalInfo, json_t *currentEvent, json_t *outputEvent, boo
       // for each tap we want to calculate some factors for applying loads at the floors
       //
 
-      // load tap data from the file
-      json_t *tapLocations = json_object_get(tapData,"tapLocations");
-      json_t *tapCp = json_object_get(tapData,"pressureCoefficients");
-
-      
-      int numTaps = json_array_size(tapLocations);
+      // load the taps and their Cp histories, tap positions are only scaled to the building
+      // dimensions for the supported roof types
+      WindTunnelLoads windLoads;
+      bool scaleTaps = (strcmp(roofType,"Flat") == 0) || (strcmp(roofType,"Gable") == 0);
+      int numTaps = windLoads.LoadTaps(tapData, numSteps, height, breadth, depth,
+				       modelHeight, modelBreadth, modelDepth, scaleTaps);
       if (numTaps == 0) {
 	std::cerr << "FATAL ERROR - no tapLocations or tapLocations empty\n";
 	exit(-1);
       }
 
-      TAP *theTAPS = new TAP[numTaps];
-      for (int i=0; i<numTaps; i++) {
-	json_t *jsonTap = json_array_get(tapLocations, i);
-	int face = json_integer_value(json_object_get(jsonTap,"face"));
-	theTAPS[i].face = face;
-	theTAPS[i].id = json_integer_value(json_object_get(jsonTap,"id"));
-	double locX = json_number_value(json_object_get(jsonTap,"xLoc"));
-	double locY = json_number_value(json_object_get(jsonTap,"yLoc"));
-
-	// want to scale tap position to building(prototype) dimensions
-	if ((strcmp(roofType,"Flat") == 0) || (strcmp(roofType,"Gable") == 0)) { 
-	  if (face == 1 || face == 3) {
-	    locX = locX*breadth/modelBreadth;
-	    locY = locY*height/modelHeight;
-	  } else if (face == 2 || face == 4) {
-	    locX = locX*depth/modelDepth;
-	    locY = locY*height/modelHeight;
-	  } else {
-	    locX = locX*breadth/modelBreadth;
-	    locY = locY*height/modelDepth;
-	  }
-	  theTAPS[i].locX = locX;
-	  theTAPS[i].locY = locY;
-	}
-
-	double *forces = new double[numFloors];
-	double *moments = new double[numFloors];
-	double *data = new double[numSteps];
-
-	for (int j=0; j<numFloors; j++) {
-	  forces[j]=0.0;
-	  moments[j]=0.0;
-	}
-
-	bool found = false;
-	for (int j=0; j<numTaps; j++) {
-	  json_t *jsonCP = json_array_get(tapCp, j);
-	  int tapID = json_integer_value(json_object_get(jsonCP,"id"));
-	  if (theTAPS[i].id == tapID) {
-	    json_t *arrayData = json_object_get(jsonCP,"data");
-	    for (int k=0; k<numSteps; k++) {
-	      data[k] = json_real_value(json_array_get(arrayData, k));
-	    }	    
-	    j = numTaps;
-	    found = true;
-	  }
-	}
-	if (found == false) {
-	  for (int j=0; j<numSteps; j++) {
-	    data[j]=0.0;
-	  }
-	}
-
-	theTAPS[i].forces = forces;
-	theTAPS[i].moments = moments;
-	theTAPS[i].data = data;
-      }
-
       //
-      // for each tap determine factors fr moments and forces for the building assuming a mesh discretization
+      // for each tap determine factors for moments and forces for the building assuming a mesh discretization
       //
 
+      // the mesh resolution defaults to 10x10 cells per story and face
       int numDivisionX = 10;
       int numDivisionY = 10;
+      json_t *numDivisionXJO = json_object_get(currentEvent,"numDivisionX");
+      json_t *numDivisionYJO = json_object_get(currentEvent,"numDivisionY");
+      if (numDivisionXJO != NULL)
+	numDivisionX = json_integer_value(numDivisionXJO);
+      if (numDivisionYJO != NULL)
+	numDivisionY = json_integer_value(numDivisionYJO);
+      if (numDivisionX < 1 || numDivisionY < 1) {
+	std::cerr << "FATAL ERROR - numDivisionX and numDivisionY must be positive\n";
+	exit(-1);
+      }
 
-      addForcesFace(theTAPS, numTaps, height, breadth, numDivisionX, numDivisionY, 1, numFloors);
-      addForcesFace(theTAPS, numTaps, height, depth, numDivisionX, numDivisionY, 2, numFloors);
-      addForcesFace(theTAPS, numTaps, height, breadth, numDivisionX, numDivisionY, 3, numFloors);
-      addForcesFace(theTAPS, numTaps, height, depth, numDivisionX, numDivisionY, 4, numFloors);
+      windLoads.ComputeWeights(height, breadth, depth, numFloors, numDivisionX, numDivisionY,
+			       WindTunnelLoads::AboveFloor, "SimCenterLowRiseTPUWeights");
 
       //
-      // write out the forces to the event file
+      // compute the floor loads and write them out to the event
       //
 
-
-      // fill in a blank event for floor loads
-      json_t *timeSeriesArray = json_array();
-      json_t *patternArray = json_array();
-      json_t *pressureArray = json_array();
-
-      for (int i = 0; i < numFloors; i++) {
-	
-				// create and fill in a time series object
-				char floor[10];
-				char name[50];
-
-				sprintf(floor,"%d",i+1);
-
-				//
-				// forces in x direction
-				//
-
-				sprintf(name,"Fx_%d",i+1);
-				json_t *timeSeriesX = json_object();     
-				json_object_set(timeSeriesX,"name",json_string(name));    
-				json_object_set(timeSeriesX,"dT",json_real(dT));
-				json_object_set(timeSeriesX,"type",json_string("Value"));
-				json_t *dataFloorX = json_array();   
-				double maxPressureX = 0.0;
-				double minPressureX = 0.0;
-
-				for (int j=0; j<numSteps; j++) {
-				  double value = 0.0;
-				  for (int k=0; k<numTaps; k++) {
-				    if (theTAPS[k].face == 1 || theTAPS[k].face == 3)
-				      value = value + theTAPS[k].forces[i] * theTAPS[k].data[j];
-				  }
-				  value = loadFactor * value;
-				  json_array_append(dataFloorX,json_real(value));
-				}
-				json_object_set(timeSeriesX,"data",dataFloorX);
-
-				json_t *patternX = json_object();
-				json_object_set(patternX,"name",json_string(name));        
-				json_object_set(patternX,"timeSeries",json_string(name));        
-				json_object_set(patternX,"type",json_string("WindFloorLoad"));        
-
-				json_object_set(patternX,"floor",json_string(floor));        
-				json_object_set(patternX,"dof",json_integer(1));        
-				json_array_append(patternArray,patternX);
-
-				//
-				// forces y direction
-				//
-
-				sprintf(name,"Fy_%d",i+1);
-				json_t *timeSeriesY = json_object();     
-				json_object_set(timeSeriesY,"name",json_string(name));    
-				json_object_set(timeSeriesY,"dT",json_real(dT));
-				json_object_set(timeSeriesY,"type",json_string("Value"));
-				json_t *dataFloorY = json_array();   
-				double maxPressureY = 0.0;
-				double minPressureY = 0.0;
-
-				for (int j=0; j<numSteps; j++) {
-				  double value = 0.0;
-				  for (int k=0; k<numTaps; k++) {
-				    if (theTAPS[k].face == 2 || theTAPS[k].face == 4)
-				      value = value + theTAPS[k].forces[i] * theTAPS[k].data[j];
-				  }
-				  value = loadFactor * value;
-				  json_array_append(dataFloorY,json_real(value));
-				}
-
-				json_object_set(timeSeriesY,"data",dataFloorY);
-
-				json_t *patternY = json_object();
-				json_object_set(patternY,"name",json_string(name));        
-				json_object_set(patternY,"timeSeries",json_string(name));        
-				json_object_set(patternY,"type",json_string("WindFloorLoad"));        
-				json_object_set(patternY,"floor",json_string(floor));        
-				json_object_set(patternY,"dof",json_integer(2));        
-				json_array_append(patternArray,patternY);
-
-				//
-				// moments about z
-				//
-
-				sprintf(name,"Mz_%d",i+1);
-				json_t *timeSeriesRZ = json_object();     
-				json_object_set(timeSeriesRZ,"name",json_string(name));    
-				json_object_set(timeSeriesRZ,"dT",json_real(dT));
-				json_object_set(timeSeriesRZ,"type",json_string("Value"));
-				json_t *dataFloorRZ = json_array();   
-
-				for (int j=0; j<numSteps; j++) {
-				  double value = 0.0;
-				  for (int k=0; k<numTaps; k++) {
-				    value = value + theTAPS[k].moments[i] * theTAPS[k].data[j];
-				  }
-				  value = loadFactor * value;
-				  json_array_append(dataFloorRZ,json_real(value));
-				}
-				json_object_set(timeSeriesRZ,"data",dataFloorRZ);
-
-				json_t *patternRZ = json_object();
-				json_object_set(patternRZ,"name",json_string(name));        
-				json_object_set(patternRZ,"timeSeries",json_string(name));        
-				json_object_set(patternRZ,"type",json_string("WindFloorLoad"));        
-				json_object_set(patternRZ,"floor",json_string(floor));        
-				json_object_set(patternRZ,"dof",json_integer(6));        
-				json_array_append(patternArray,patternRZ);
-				
-				json_t *pressureObject = json_object();
-				json_t *pressureStoryArray = json_array();
-				
-				json_array_append(pressureStoryArray, json_real(minPressureX));
-				json_array_append(pressureStoryArray, json_real(maxPressureX));
-				json_object_set(pressureObject,"pressure",pressureStoryArray);
-				json_object_set(pressureObject,"story",json_string(name));
-				
-				json_array_append(pressureArray, pressureObject);
-				
-				// add object to timeSeries array
-				json_array_append(timeSeriesArray,timeSeriesX);
-				json_array_append(timeSeriesArray,timeSeriesY);
-				json_array_append(timeSeriesArray,timeSeriesRZ);
-      }
-      
-      json_t *units = json_object();
-      json_object_set(units,"force",json_string("KN"));
-      json_object_set(units,"length",json_string("m"));
-      json_object_set(units,"time",json_string("sec"));
-      json_object_set(outputEvent,"units",units);
-      
-      json_object_set(outputEvent,"timeSeries",timeSeriesArray);
-      json_object_set(outputEvent,"pattern",patternArray);
-      json_object_set(outputEvent,"pressure",pressureArray);
-      json_object_set(outputEvent,"dT",json_real(dT));
-      json_object_set(outputEvent,"numSteps",json_integer(numSteps));
+      windLoads.AddToEvent(outputEvent, loadFactor, dT, eventWriter);
 
     } else {
 
@@ -643,120 +454,3 @@ int addEvent(json_t *generalInfo, json_t *currentEvent, json_t *outputEvent, boo
     }
     return 0;
 }
-
-
-//
-// function to add factors for forces and moment contribution coefficients for taps to building floor
-// determine coefficients for each tap for a building face. This is done by going over each story of 
-// For each story break into numDiv X numDiv segments. For each segment assume point load at center 
-// segment and equal in mag to area of segment and using simply supported beam formula determine force 
-// at floor below and floor above. based on distance from center line of story determine actibg moments 
-// on floors.
-//
-// inputs: height: height of building
-//         length: length of building face (width, depth) depending on side
-//         numDivisionX: number of elements in mesh along length
-//         numDivisionY: number of elements in mesh over building height
-//         face: faceID 
-//         numFloors: number of floors
-// output: 0 ok, -1 error
-// 
-
-int addForcesFace(TAP *theTaps, int numTaps, 
-		  double height, double length, 
-		  int numDivisionX, int numDivisionY, 
-		  int face, 
-		  int numFloors) {
-  
-
-
-  double heightStory = height/(1.0*numFloors);
-  double dY = heightStory/numDivisionY;
-  double dX = length/numDivisionX;
-  double centerLine = length/2.0;
-  double A = dY*dX;
-  double locY = dY/2.0;
-
-  for (int i = 0; i <numFloors; i++) {
-  
-    for (int j=0; j<numDivisionY; j++) {
-      
-      double locX = dX/2.0;
-      //double Rabove = locY*A/heightStory;
-      //double Rbelow = (heightStory-locY)*A/heightStory;
-      double Rabove = (locY-i*heightStory)/heightStory*A;
-      double Rbelow = (heightStory-(locY-i*heightStory))/heightStory*A;
-      
-      /*
-      for (int k=0; k<numTaps; k++) {
-			TAP *theTap = &theTaps[k];
-			if (theTap->face == 1)
-	  	std::cerr << theTap->id << " " << theTap->forces[0] << "\n";
-      }
-      */
-            
-  		for (int k=0; k<numDivisionX; k++) {
-	
-				double Mabove = Rabove*(locX-centerLine);
-				double Mbelow = Rbelow*(locX-centerLine);
-	
-				// find nearestTAP
-				TAP *theTap = findNearestTAP(theTaps, numTaps, locX, locY, face);
-	
-				// add force coefficients
-				if (theTap != NULL) {
-	  
-		  		if (i != 0) { // don;t add to ground floor
-		    		if (face == 1 || face == 2) // pressure on face 3 and 4 are negative to pos x & y dirn
-		      		theTap->forces[i-1] = theTap->forces[i-1] + Rbelow;
-		    		else
-		      		theTap->forces[i-1] = theTap->forces[i-1] - Rbelow;
-		    		theTap->moments[i-1] = theTap->moments[i-1] + Mbelow;
-		  		}
-	  
-	  			if (face == 1 || face == 2) // pressure on face 3 and 4 are negative to pos x & y dirn
-	    			theTap->forces[i] = theTap->forces[i] + Rabove;
-	  			else
-	    			theTap->forces[i] = theTap->forces[i] - Rabove;
-	  
-	  			theTap->moments[i] = theTap->moments[i] + Mabove;
-	  
-	  		//	  std::cerr << theTap->id << " " << locX << " " << locY << " " << theTap->locX << " " << theTap->locY << " " << theTap->forces[i] << " " << i << " " << j << "\n";
-	  
-				}	    
-			locX += dX;
-  		}
-  	locY += dY;
-  	}
-  }
-
-  return 0;
-}
-
-//
-// function to fnd nearest tap
-// inputs: theTAPS: array of Taps, 
-//         numTaps: number of taps in array
-//         xLoc, yLoc: is location of Inuit point
-//         face: if of face
-// output: pointer to nearest TAp in the array, NULL if no taps with face
-// 
-
-TAP *findNearestTAP(TAP *theTAPS, int numTaps, double locX, double locY, int face) {
-  TAP *theRes = NULL;
-  double nearestDistance = 1e100; // something large!
-  for (int i=0; i<numTaps; i++) {
-    TAP *theTap = &theTAPS[i];
-    if (theTap->face == face) {
-      double deltaX = theTap->locX - locX;
-      double deltaY = theTap->locY - locY;
-      double dist = deltaX*deltaX + deltaY*deltaY;
-      if (dist < nearestDistance) {
-	theRes = theTap;
-	nearestDistance = dist;
-      }
-    }
-  }
-  
-  return theRes;
-}
@@ -0,0 +1,279 @@
+#include <cmath>
+#include <complex>
+#include <sstream>
+#include <string>
+#include <vector>
+// Boost random generator
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+// Eigen dense matrices
+#include <Eigen/Dense>
+// Google Benchmark
+#include <benchmark/benchmark.h>
+
+#include "configure.h"
+#include "dabaghi_der_kiureghian.h"
+#include "filter.h"
+#include "json_object.h"
+#include "json_stream_writer.h"
+#include "numeric_utils.h"
+#include "vlachos_et_al.h"
+#include "wittig_sinha.h"
+
+namespace {
+const int SEED = 100; /**< Seed used for all benchmark inputs */
+const unsigned int RECORD_LENGTH = 4000; /**< Length of records written */
+
+/**
+ * Generate vector of standard normal random values
+ * @param[in] size Number of values
+ * @return Vector of random values
+ */
+std::vector<double> random_values(std::size_t size) {
+  boost::random::mt19937 generator(SEED);
+  boost::random::normal_distribution<> distribution(0.0, 1.0);
+  boost::random::variate_generator<boost::random::mt19937&,
+                                   boost::random::normal_distribution<>>
+      normal_gen(generator, distribution);
+
+  std::vector<double> values(size);
+  for (auto& value : values) {
+    value = normal_gen();
+  }
+  return values;
+}
+
+/**
+ * Benchmark real-to-complex FFT for the input number of samples
+ */
+void fft(benchmark::State& state) {
+  std::vector<double> values = random_values(state.range(0));
+  Eigen::VectorXd input =
+      Eigen::Map<const Eigen::VectorXd>(values.data(), values.size());
+  Eigen::VectorXcd output;
+
+  for (auto _ : state) {
+    numeric_utils::fft(input, output);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Benchmark spectral representation of a single Vlachos et al. time history
+ * for the input number of time steps, using 250 frequencies
+ */
+void vlachos_simulate_time_history(benchmark::State& state) {
+  stochastic::VlachosEtAl model(6.5, 30.0, 500.0, 0.0, 1, 1, SEED);
+  const unsigned int num_freqs = 250;
+
+  // Smooth spectrum that decays with frequency and is modulated in time
+  Eigen::MatrixXd power_spectrum(state.range(0), num_freqs);
+  for (unsigned int i = 0; i < power_spectrum.rows(); ++i) {
+    double modulation = std::sin(M_PI * i / power_spectrum.rows());
+    for (unsigned int j = 0; j < num_freqs; ++j) {
+      power_spectrum(i, j) = modulation * std::exp(-0.1 * j);
+    }
+  }
+
+  std::vector<double> time_history;
+  for (auto _ : state) {
+    model.simulate_time_history(time_history, power_spectrum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * num_freqs);
+}
+
+/**
+ * Benchmark generation of complex random numbers for Wittig & Sinha wind
+ * velocities for the input number of floors over 10 minutes
+ */
+void wittig_sinha_complex_random_numbers(benchmark::State& state) {
+  stochastic::WittigSinha model("C", 100.0, 3.0 * state.range(0),
+                                state.range(0), 600.0, SEED);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(model.complex_random_numbers());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Benchmark modulated filtered white noise of Dabaghi & Der Kiureghian
+ * model for the input number of ground motions
+ */
+void ddk_simulate_white_noise(benchmark::State& state) {
+  stochastic::DabaghiDerKiureghian model(
+      stochastic::FaultType::StrikeSlip, stochastic::SimulationType::NoPulse,
+      7.0, 0.0, 10.0, 400.0, 20.0, 10.0, 1, 1, true, SEED);
+
+  // Arias intensity (cm/s), D5-95, D0-5 and D5-30 (s)
+  Eigen::VectorXd q_params(4);
+  q_params << 100.0, 10.0, 1.0, 3.0;
+  Eigen::VectorXd modulating_params =
+      model.backcalculate_modulating_params(q_params, 0.0);
+
+  // Mid frequency (Hz), frequency slope (Hz/s) and damping ratio
+  Eigen::VectorXd filter_params(3);
+  filter_params << 5.0, -0.1, 0.3;
+
+  const unsigned int num_steps = RECORD_LENGTH;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(model.simulate_white_noise(
+        modulating_params, filter_params, num_steps, state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * num_steps);
+}
+
+/**
+ * Benchmark baseline correction of acceleration time history with the input
+ * number of time steps
+ */
+void ddk_baseline_correct_time_history(benchmark::State& state) {
+  stochastic::DabaghiDerKiureghian model(
+      stochastic::FaultType::StrikeSlip, stochastic::SimulationType::NoPulse,
+      7.0, 0.0, 10.0, 400.0, 20.0, 10.0, 1, 1, true, SEED);
+  const std::vector<double> input = random_values(state.range(0));
+  std::vector<double> time_history;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    time_history = input;
+    state.ResumeTiming();
+    model.baseline_correct_time_history(time_history, 981.0, 5);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Benchmark highpass Butterworth filtering of the input number of records,
+ * one record at a time
+ */
+void iir_filter_records(benchmark::State& state) {
+  auto coeffs = signal_processing::hp_butterworth()(4, 0.004);
+  const std::vector<double> input = random_values(state.range(0) * RECORD_LENGTH);
+  std::vector<double> output(input.size());
+
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+      signal_processing::iir_filter(coeffs[0], coeffs[1],
+                                    input.data() + i * RECORD_LENGTH,
+                                    output.data() + i * RECORD_LENGTH,
+                                    RECORD_LENGTH);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * RECORD_LENGTH);
+}
+
+/**
+ * Benchmark highpass Butterworth filtering of the input number of records
+ * as a single batch
+ */
+void iir_filter_batch(benchmark::State& state) {
+  auto coeffs = signal_processing::hp_butterworth()(4, 0.004);
+  const std::vector<double> input = random_values(state.range(0) * RECORD_LENGTH);
+  std::vector<double> output(input.size());
+
+  for (auto _ : state) {
+    signal_processing::iir_filter_batch(coeffs[0], coeffs[1], input.data(),
+                                        output.data(), RECORD_LENGTH,
+                                        state.range(0));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * RECORD_LENGTH);
+}
+
+/**
+ * Build event in the layout used by the stochastic models, with two time
+ * series per record
+ * @param[in] history Time history data used for every time series
+ * @param[in] num_records Number of records
+ * @return Vector of events
+ */
+std::vector<utilities::JsonObject> build_events(
+    const std::vector<double>& history, unsigned int num_records) {
+  std::vector<utilities::JsonObject> events(num_records);
+  for (auto& event : events) {
+    std::vector<utilities::JsonObject> time_series(2);
+    for (unsigned int i = 0; i < time_series.size(); ++i) {
+      time_series[i].add_value("name", "accel_" + std::to_string(i));
+      time_series[i].add_value("type", "Value");
+      time_series[i].add_value("dT", 0.01);
+      time_series[i].add_array("data", history.data(), history.size());
+    }
+    event.add_value("type", "Seismic");
+    event.add_value("timeSeries", std::move(time_series));
+  }
+  return events;
+}
+
+/**
+ * Benchmark JSON output through the in-memory JsonObject for the input
+ * number of records
+ */
+void json_output_object(benchmark::State& state) {
+  const std::vector<double> history = random_values(RECORD_LENGTH);
+
+  for (auto _ : state) {
+    utilities::JsonObject output;
+    output.add_value("Events", build_events(history, state.range(0)));
+    std::ostringstream stream;
+    stream << output;
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2 *
+                            RECORD_LENGTH);
+}
+
+/**
+ * Benchmark JSON output through the streaming writer for the input number of
+ * records
+ */
+void json_output_stream(benchmark::State& state) {
+  const std::vector<double> history = random_values(RECORD_LENGTH);
+
+  for (auto _ : state) {
+    std::ostringstream stream;
+    utilities::JsonStreamWriter writer(stream);
+    writer.start_object();
+    writer.start_array("Events");
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+      writer.start_object();
+      writer.add_value("type", "Seismic");
+      writer.start_array("timeSeries");
+      for (unsigned int j = 0; j < 2; ++j) {
+        writer.start_object();
+        writer.add_value("name", "accel_" + std::to_string(j));
+        writer.add_value("type", "Value");
+        writer.add_value("dT", 0.01);
+        writer.add_array("data", history.data(), history.size());
+        writer.end_object();
+      }
+      writer.end_array();
+      writer.end_object();
+    }
+    writer.end_array();
+    writer.end_object();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2 *
+                            RECORD_LENGTH);
+}
+}  // namespace
+
+BENCHMARK(fft)->Arg(1024)->Arg(4096)->Arg(10000)->Arg(16384)->Arg(65536);
+BENCHMARK(vlachos_simulate_time_history)->Arg(1000)->Arg(4000)->Arg(16000);
+BENCHMARK(wittig_sinha_complex_random_numbers)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK(ddk_simulate_white_noise)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(ddk_baseline_correct_time_history)->Arg(1000)->Arg(4000)->Arg(16000);
+BENCHMARK(iir_filter_records)->Arg(1)->Arg(8)->Arg(64)->Arg(512);
+BENCHMARK(iir_filter_batch)->Arg(1)->Arg(8)->Arg(64)->Arg(512);
+BENCHMARK(json_output_object)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(json_output_stream)->Arg(1)->Arg(10)->Arg(100);
+
+int main(int argc, char** argv) {
+  config::initialize();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// JSON for Modern C++ single-include header
+#include <nlohmann/json.hpp>
+#include "binary_event.h"
+
+namespace {
+const char BINARY_MAGIC[8] = {'S', 'M', 'E', 'L', 'T', 'B', 'I', 'N'};
+const std::uint32_t BINARY_VERSION = 1;
+
+/**
+ * Check whether the host stores multi-byte values in little-endian order
+ * @return Returns true if host is little-endian, false otherwise
+ */
+bool host_is_little_endian() {
+  const std::uint16_t probe = 1;
+  unsigned char first_byte;
+  std::memcpy(&first_byte, &probe, 1);
+  return first_byte == 1;
+}
+
+/**
+ * Reverse the bytes of each value in place, converting between host and
+ * little-endian byte order on big-endian hosts
+ * @tparam T Type of values
+ * @param[in, out] values Pointer to first value
+ * @param[in] count Number of values
+ */
+template <typename T>
+void swap_bytes(T* values, std::size_t count) {
+  unsigned char* bytes = reinterpret_cast<unsigned char*>(values);
+  for (std::size_t i = 0; i < count; ++i) {
+    std::reverse(bytes + i * sizeof(T), bytes + (i + 1) * sizeof(T));
+  }
+}
+
+/**
+ * Write values to stream in little-endian byte order
+ * @tparam T Type of values
+ * @param[in] output_file Stream to write to
+ * @param[in] values Pointer to first value
+ * @param[in] count Number of values
+ * @param[in] scratch Buffer used for byte-swapped copy on big-endian hosts
+ */
+template <typename T>
+void write_little_endian(std::ofstream& output_file, const T* values,
+                         std::size_t count, std::vector<T>& scratch) {
+  if (host_is_little_endian()) {
+    output_file.write(reinterpret_cast<const char*>(values),
+                      count * sizeof(T));
+  } else {
+    scratch.assign(values, values + count);
+    swap_bytes(scratch.data(), count);
+    output_file.write(reinterpret_cast<const char*>(scratch.data()),
+                      count * sizeof(T));
+  }
+}
+
+/**
+ * Read values stored in little-endian byte order from stream
+ * @tparam T Type of values
+ * @param[in] input_file Stream to read from
+ * @param[out] values Pointer to first value to read into
+ * @param[in] count Number of values
+ */
+template <typename T>
+void read_little_endian(std::ifstream& input_file, T* values,
+                        std::size_t count) {
+  input_file.read(reinterpret_cast<char*>(values), count * sizeof(T));
+  if (!host_is_little_endian()) {
+    swap_bytes(values, count);
+  }
+}
+
+/**
+ * Get location of binary container corresponding to input JSON sidecar
+ * @param[in] sidecar_location Location of JSON sidecar
+ * @return Location of binary container
+ */
+std::string binary_location(const std::string& sidecar_location) {
+  std::size_t separator = sidecar_location.find_last_of("/\\");
+  std::size_t extension = sidecar_location.find_last_of('.');
+
+  if (extension == std::string::npos ||
+      (separator != std::string::npos && extension < separator)) {
+    return sidecar_location + ".bin";
+  }
+  return sidecar_location.substr(0, extension) + ".bin";
+}
+
+/**
+ * Get the directory portion of the input location, including trailing
+ * separator
+ * @param[in] location File location
+ * @return Directory containing file, or empty string if location has no
+ *         directory
+ */
+std::string directory_of(const std::string& location) {
+  std::size_t separator = location.find_last_of("/\\");
+  return separator == std::string::npos ? std::string()
+                                        : location.substr(0, separator + 1);
+}
+}  // namespace
+
+bool utilities::write_binary_histories(
+    const std::string& output_location,
+    const std::vector<std::vector<double>>& histories,
+    BinaryPrecision precision) {
+  std::ofstream output_file(output_location, std::ios::binary);
+
+  if (!output_file.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::write_binary_histories(): Could not open "
+        "output location\n");
+  }
+
+  std::uint32_t value_size = precision == BinaryPrecision::Float32 ? 4 : 8;
+  std::uint64_t num_histories = histories.size();
+  std::vector<std::uint64_t> lengths(histories.size());
+  for (unsigned int i = 0; i < histories.size(); ++i) {
+    lengths[i] = histories[i].size();
+  }
+
+  std::vector<std::uint32_t> scratch_32;
+  std::vector<std::uint64_t> scratch_64;
+  output_file.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  write_little_endian(output_file, &BINARY_VERSION, 1, scratch_32);
+  write_little_endian(output_file, &value_size, 1, scratch_32);
+  write_little_endian(output_file, &num_histories, 1, scratch_64);
+  write_little_endian(output_file, lengths.data(), lengths.size(), scratch_64);
+
+  // Histories are already contiguous in double precision so are written
+  // directly on little-endian hosts, otherwise they are narrowed or
+  // byte-swapped one history at a time
+  std::vector<double> swapped;
+  std::vector<float> narrowed, narrowed_swapped;
+  for (const auto& history : histories) {
+    if (precision == BinaryPrecision::Float64) {
+      write_little_endian(output_file, history.data(), history.size(),
+                          swapped);
+    } else {
+      narrowed.assign(history.begin(), history.end());
+      write_little_endian(output_file, narrowed.data(), narrowed.size(),
+                          narrowed_swapped);
+    }
+  }
+
+  output_file.close();
+
+  if (output_file.fail()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::write_binary_histories(): Error when writing "
+        "to output location\n");
+  }
+
+  return true;
+}
+
+bool utilities::read_binary_histories(
+    const std::string& input_location,
+    std::vector<std::vector<double>>& histories) {
+  std::ifstream input_file(input_location, std::ios::binary);
+
+  if (!input_file.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::read_binary_histories(): Could not open "
+        "input location\n");
+  }
+
+  char magic[sizeof(BINARY_MAGIC)];
+  std::uint32_t version = 0, value_size = 0;
+  std::uint64_t num_histories = 0;
+
+  input_file.read(magic, sizeof(magic));
+  read_little_endian(input_file, &version, 1);
+  read_little_endian(input_file, &value_size, 1);
+  read_little_endian(input_file, &num_histories, 1);
+
+  if (!input_file ||
+      std::memcmp(magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::read_binary_histories(): Input is not a "
+        "binary time history container\n");
+  }
+
+  if (version != BINARY_VERSION || (value_size != 4 && value_size != 8)) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::read_binary_histories(): Unsupported binary "
+        "container version or value size\n");
+  }
+
+  std::vector<std::uint64_t> lengths(num_histories);
+  read_little_endian(input_file, lengths.data(), lengths.size());
+
+  histories.resize(num_histories);
+  std::vector<float> narrowed;
+  for (unsigned int i = 0; i < num_histories; ++i) {
+    histories[i].resize(lengths[i]);
+    if (value_size == 8) {
+      read_little_endian(input_file, histories[i].data(), lengths[i]);
+    } else {
+      narrowed.resize(lengths[i]);
+      read_little_endian(input_file, narrowed.data(), lengths[i]);
+      histories[i].assign(narrowed.begin(), narrowed.end());
+    }
+  }
+
+  if (!input_file) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::read_binary_histories(): Binary container is "
+        "truncated\n");
+  }
+
+  return true;
+}
+
+bool utilities::write_binary_event(nlohmann::json event,
+                                   const std::string& output_location,
+                                   BinaryPrecision precision) {
+  // Move the data of every time series into the list of histories, replacing
+  // it with its index in the binary container
+  std::vector<std::vector<double>> histories;
+
+  if (event.contains("Events")) {
+    for (auto& current_event : event["Events"]) {
+      if (!current_event.contains("timeSeries")) {
+        continue;
+      }
+
+      for (auto& time_series : current_event["timeSeries"]) {
+        if (time_series.contains("data") && time_series["data"].is_array()) {
+          time_series["dataIndex"] = histories.size();
+          histories.push_back(time_series["data"].get<std::vector<double>>());
+          time_series.erase("data");
+        }
+      }
+    }
+  }
+
+  std::string binary_file = binary_location(output_location);
+  write_binary_histories(binary_file, histories, precision);
+
+  event["binaryData"] = nlohmann::json::object(
+      {{"file", binary_file.substr(directory_of(binary_file).size())},
+       {"version", BINARY_VERSION},
+       {"precision",
+        precision == BinaryPrecision::Float32 ? "float32" : "float64"}});
+
+  std::ofstream output_file(output_location);
+
+  if (!output_file.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::write_binary_event(): Could not open "
+        "output location\n");
+  }
+
+  output_file << std::setw(4) << event << std::endl;
+  output_file.close();
+
+  if (output_file.fail()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::write_binary_event(): Error when closing "
+        "output location\n");
+  }
+
+  return true;
+}
+
+nlohmann::json utilities::read_binary_event(const std::string& input_location) {
+  std::ifstream input_file(input_location);
+
+  if (!input_file.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::read_binary_event(): Could not open "
+        "input location\n");
+  }
+
+  nlohmann::json event;
+  input_file >> event;
+
+  if (!event.contains("binaryData")) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::read_binary_event(): Input does not reference "
+        "a binary time history container\n");
+  }
+
+  std::vector<std::vector<double>> histories;
+  read_binary_histories(
+      directory_of(input_location) +
+          event["binaryData"]["file"].get<std::string>(),
+      histories);
+
+  if (event.contains("Events")) {
+    for (auto& current_event : event["Events"]) {
+      if (!current_event.contains("timeSeries")) {
+        continue;
+      }
+
+      for (auto& time_series : current_event["timeSeries"]) {
+        if (time_series.contains("dataIndex")) {
+          std::size_t index = time_series["dataIndex"].get<std::size_t>();
+          if (index >= histories.size()) {
+            throw std::runtime_error(
+                "\nERROR: In utilities::read_binary_event(): Time series data "
+                "index exceeds number of histories in binary container\n");
+          }
+          time_series["data"] = std::move(histories[index]);
+          time_series.erase("dataIndex");
+        }
+      }
+    }
+  }
+
+  event.erase("binaryData");
+
+  return event;
+}
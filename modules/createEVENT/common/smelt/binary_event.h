@@ -0,0 +1,82 @@
+#ifndef _BINARY_EVENT_H_
+#define _BINARY_EVENT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+// JSON for Modern C++ single-include header
+#include <nlohmann/json.hpp>
+
+/**
+ * Compact binary container for time histories. A container consists of a
+ * fixed header followed by the length of each history and then all histories
+ * stored contiguously, one after the other:
+ *
+ *   char     magic[8]       "SMELTBIN"
+ *   uint32_t version        Container version, currently 1
+ *   uint32_t value_size     Size of each value in bytes (4 or 8)
+ *   uint64_t num_histories  Number of histories in container
+ *   uint64_t lengths[num_histories]
+ *   value    data[sum(lengths)]
+ *
+ * All values are stored in little-endian byte order, whatever the byte order
+ * of the host writing or reading the container.
+ */
+namespace utilities {
+
+/**
+ * Precision used to store time history values in binary containers
+ */
+enum class BinaryPrecision {
+  Float32, /**< Single precision (4 byte) values */
+  Float64  /**< Double precision (8 byte) values */
+};
+
+/**
+ * Write time histories to compact binary container
+ * @param[in] output_location Location to write binary container to
+ * @param[in] histories Vector of time histories to write
+ * @param[in] precision Precision to store values with. Defaults to double
+ *                      precision.
+ * @return Returns true if successful, false otherwise
+ */
+bool write_binary_histories(
+    const std::string& output_location,
+    const std::vector<std::vector<double>>& histories,
+    BinaryPrecision precision = BinaryPrecision::Float64);
+
+/**
+ * Read time histories from compact binary container
+ * @param[in] input_location Location of binary container
+ * @param[out] histories Vector to write time histories to
+ * @return Returns true if successful, false otherwise
+ */
+bool read_binary_histories(const std::string& input_location,
+                           std::vector<std::vector<double>>& histories);
+
+/**
+ * Write event to a compact binary container holding the data of every time
+ * series plus a small JSON sidecar holding the remaining event description.
+ * In the sidecar, the data array of each time series is replaced by its
+ * index in the binary container under the key "dataIndex". The binary
+ * container is written next to the sidecar with the extension ".bin".
+ * @param[in] event Event in the format generated by the stochastic models
+ * @param[in] output_location Location to write JSON sidecar to
+ * @param[in] precision Precision to store values with. Defaults to double
+ *                      precision.
+ * @return Returns true if successful, false otherwise
+ */
+bool write_binary_event(nlohmann::json event,
+                        const std::string& output_location,
+                        BinaryPrecision precision = BinaryPrecision::Float64);
+
+/**
+ * Read event written by write_binary_event, restoring the data arrays of all
+ * time series from the binary container
+ * @param[in] input_location Location of JSON sidecar
+ * @return Event with time series data restored
+ */
+nlohmann::json read_binary_event(const std::string& input_location);
+}  // namespace utilities
+
+#endif  // _BINARY_EVENT_H_
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <cmath>
 #include <ctime>
+#include <fstream>
 #include <memory>
 #include <numeric>
 #include <stdexcept>
@@ -20,6 +21,7 @@
 #include "factory.h"
 #include "function_dispatcher.h"
 #include "json_object.h"
+#include "json_stream_writer.h"
 #include "nelder_mead.h"
 #include "normal_dist.h"
 #include "normal_multivar.h"
@@ -361,61 +363,8 @@ utilities::JsonObject stochastic::DabaghiDerKiureghian::generate(
 
   // Generated simulated acceleration time histories
   try {
-    // Simulate model parameters
-    Eigen::MatrixXd parameters_pulse =
-        simulate_model_parameters(true, num_sims_pulse_);
-    Eigen::MatrixXd parameters_nopulse =
-        simulate_model_parameters(false, num_sims_nopulse_);
-
-    // Simulate pulse-like motions
-    for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
-        simulate_near_fault_ground_motion(
-            true, parameters_pulse.row(i), pulse_motions_comp1[i],
-            pulse_motions_comp2[i], num_realizations_);
-    } 
-
-    // Simulate non-pulse-like motions
-    for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
-      simulate_near_fault_ground_motion(
-          false, parameters_nopulse.row(i), nopulse_motions_comp1[i],
-          nopulse_motions_comp2[i], num_realizations_);
-    }
-
-    // If requested, truncate and baseline correct time histories
-    double gfactor = 981;
-    unsigned int fit_order = 5;
-    if (truncate_) {
-      // First truncate motions
-      for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
-        truncate_time_histories(pulse_motions_comp1[i], pulse_motions_comp2[i],
-                                gfactor);
-      }
-
-      for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
-        truncate_time_histories(nopulse_motions_comp1[i],
-                                nopulse_motions_comp2[i], gfactor);
-      }
-
-      // Baseline correct truncated pulse-like motions
-      for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
-        for (unsigned int j = 0; j < num_realizations_; ++j) {
-          baseline_correct_time_history(pulse_motions_comp1[i][j], gfactor,
-                                        fit_order);
-          baseline_correct_time_history(pulse_motions_comp2[i][j], gfactor,
-                                        fit_order);
-        }
-      }
-
-      // Baseline correct truncated non-pulse-like motions
-      for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
-        for (unsigned int j = 0; j < num_realizations_; ++j) {
-          baseline_correct_time_history(nopulse_motions_comp1[i][j], gfactor,
-                                        fit_order);
-          baseline_correct_time_history(nopulse_motions_comp2[i][j], gfactor,
-                                        fit_order);
-        }
-      }
-    }
+    simulate_motions(pulse_motions_comp1, pulse_motions_comp2,
+                     nopulse_motions_comp1, nopulse_motions_comp2);
   } catch (const std::exception& e) {
     std::cerr << e.what();
     throw;
@@ -426,95 +375,50 @@ utilities::JsonObject stochastic::DabaghiDerKiureghian::generate(
   std::vector<utilities::JsonObject> events_array(
       num_realizations_ * (num_sims_pulse_ + num_sims_nopulse_));
 
-  // Add pattern information for JSON
-  auto pattern_x = utilities::JsonObject();
-  auto pattern_y = utilities::JsonObject();  
-  pattern_x.add_value("type", "UniformAcceleration");
-  pattern_x.add_value("timeSeries", "accel_x");
-  pattern_x.add_value("dof", 1);
-  pattern_y.add_value("type", "UniformAcceleration");
-  pattern_y.add_value("timeSeries", "accel_y");
-  pattern_y.add_value("dof", 2);
-
-  // Create JSON for specific event
-  auto event_data = utilities::JsonObject();
+  // Add event with time histories for x and y directions to events array
+  auto add_event = [&](unsigned int index, const std::string& name,
+                       std::vector<double>& accel_comp_1,
+                       std::vector<double>& accel_comp_2) {
+    auto event_data =
+        seismic_event_fields(name, time_step_, accel_comp_1.size());
+
+    convert_time_history_units(accel_comp_1, units);
+    convert_time_history_units(accel_comp_2, units);
+
+    std::vector<utilities::JsonObject> time_histories{
+        time_series_fields("accel_x", time_step_),
+        time_series_fields("accel_y", time_step_)};
+    time_histories[0].add_value("data", accel_comp_1);
+    time_histories[1].add_value("data", accel_comp_2);
+    event_data.add_value("timeSeries", std::move(time_histories));
+    events_array[index] = std::move(event_data);
+  };
+
   // Loop over simulations for different parameter sets for pulse-like
   // motions
   for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
     // Loop over number of realizations per parameter set realization    
     for (unsigned int j = 0; j < num_realizations_; ++j) {
-      event_data.add_value("name", event_name + "_ParameterSetPulse" + std::to_string(i) +
-                                       "_Sim" + std::to_string(j));
-      event_data.add_value("type", "Seismic");
-      event_data.add_value("dT", time_step_);
-      event_data.add_value("numSteps", pulse_motions_comp1[i][j].size());
-      event_data.add_value(
-          "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
-
-      // Rotate accelerations, if necessary      
-      std::vector<double> x_accels(pulse_motions_comp1[i][j].size());
-      std::vector<double> y_accels(pulse_motions_comp2[i][j].size());
-      convert_time_history_units(pulse_motions_comp1[i][j], units);
-      convert_time_history_units(pulse_motions_comp2[i][j], units);
-
-      // Add time histories for x and y directions to event
-      auto time_history_x = utilities::JsonObject();
-      auto time_history_y = utilities::JsonObject();
-      time_history_x.add_value("name", "accel_x");
-      time_history_x.add_value("type", "Value");
-      time_history_x.add_value("dT", time_step_);
-      time_history_x.add_value("data", pulse_motions_comp1[i][j]);
-      time_history_y.add_value("name", "accel_y");
-      time_history_y.add_value("type", "Value");
-      time_history_y.add_value("dT", time_step_);
-      time_history_y.add_value("data", pulse_motions_comp2[i][j]);
-      event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
-                                             time_history_x, time_history_y});
-      events_array[i * num_realizations_ + j] = event_data;
-      event_data.clear();
+      add_event(i * num_realizations_ + j,
+                event_name + "_ParameterSetPulse" + std::to_string(i) +
+                    "_Sim" + std::to_string(j),
+                pulse_motions_comp1[i][j], pulse_motions_comp2[i][j]);
     }
   }
-  
 
   // Loop over different simulations for parameter sets non-pulse-like
   // motions
   for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
     // Loop over number of realizations per parameter set realization
     for (unsigned int j = 0; j < num_realizations_; ++j) {
-      event_data.add_value("name", event_name + "_ParameterSetNoPulse" + std::to_string(i) +
-                                       "_Sim" + std::to_string(j + num_sims_pulse_));
-      event_data.add_value("type", "Seismic");
-      event_data.add_value("dT", time_step_);
-      event_data.add_value("numSteps", nopulse_motions_comp1[i][j].size());
-      event_data.add_value(
-          "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
-
-      // Rotate accelerations, if necessary
-      std::vector<double> x_accels(nopulse_motions_comp1[i][j].size());
-      std::vector<double> y_accels(nopulse_motions_comp2[i][j].size());
-      convert_time_history_units(nopulse_motions_comp1[i][j], units);
-      convert_time_history_units(nopulse_motions_comp2[i][j], units);
-
-      // Add time histories for x and y directions to event
-      auto time_history_x = utilities::JsonObject();
-      auto time_history_y = utilities::JsonObject();
-      time_history_x.add_value("name", "accel_x");
-      time_history_x.add_value("type", "Value");
-      time_history_x.add_value("dT", time_step_);
-      time_history_x.add_value("data", nopulse_motions_comp1[i][j]);
-      time_history_y.add_value("name", "accel_y");
-      time_history_y.add_value("type", "Value");
-      time_history_y.add_value("dT", time_step_);
-      time_history_y.add_value("data", nopulse_motions_comp2[i][j]);
-      event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
-                                             time_history_x, time_history_y});
-      events_array[i * num_realizations_ + j +
-                   num_realizations_ * num_sims_pulse_] = event_data;
-      event_data.clear();
+      add_event(i * num_realizations_ + j + num_realizations_ * num_sims_pulse_,
+                event_name + "_ParameterSetNoPulse" + std::to_string(i) +
+                    "_Sim" + std::to_string(j + num_sims_pulse_),
+                nopulse_motions_comp1[i][j], nopulse_motions_comp2[i][j]);
     }
   }
 
-  events.add_value("Events", events_array);
+  events.add_value("Events", std::move(events_array));
 
   return events;
 }
@@ -524,10 +428,86 @@ bool stochastic::DabaghiDerKiureghian::generate(
     bool units) {
   bool status = true;
   
-  // Generate pool of acceleration time histories
-  try{
-    auto json_output = generate(event_name, units);
-    json_output.write_to_file(output_location);
+  // Generate pool of acceleration time histories and write them directly
+  // to file without building the complete JSON object
+  try {
+    std::vector<std::vector<std::vector<double>>> pulse_motions_comp1(
+        num_sims_pulse_, std::vector<std::vector<double>>(
+                             num_realizations_, std::vector<double>()));
+    std::vector<std::vector<std::vector<double>>> pulse_motions_comp2(
+        num_sims_pulse_, std::vector<std::vector<double>>(
+                             num_realizations_, std::vector<double>()));
+    std::vector<std::vector<std::vector<double>>> nopulse_motions_comp1(
+        num_sims_nopulse_, std::vector<std::vector<double>>(
+                               num_realizations_, std::vector<double>()));
+    std::vector<std::vector<std::vector<double>>> nopulse_motions_comp2(
+        num_sims_nopulse_, std::vector<std::vector<double>>(
+                               num_realizations_, std::vector<double>()));
+
+    simulate_motions(pulse_motions_comp1, pulse_motions_comp2,
+                     nopulse_motions_comp1, nopulse_motions_comp2);
+
+    std::ofstream output_file(output_location);
+    if (!output_file.is_open()) {
+      throw std::runtime_error(
+          "\nERROR: In stochastic::DabaghiDerKiureghian::generate: Could not "
+          "open output location\n");
+    }
+
+    utilities::JsonStreamWriter writer(output_file);
+
+    // Write a single event with time histories for x and y directions
+    auto write_event = [&](const std::string& name,
+                           std::vector<double>& accel_comp_1,
+                           std::vector<double>& accel_comp_2) {
+      convert_time_history_units(accel_comp_1, units);
+      convert_time_history_units(accel_comp_2, units);
+
+      writer.start_object();
+      writer.add_fields(
+          seismic_event_fields(name, time_step_, accel_comp_1.size()));
+      writer.start_array("timeSeries");
+      writer.start_object();
+      writer.add_fields(time_series_fields("accel_x", time_step_));
+      writer.add_array("data", accel_comp_1.data(), accel_comp_1.size());
+      writer.end_object();
+      writer.start_object();
+      writer.add_fields(time_series_fields("accel_y", time_step_));
+      writer.add_array("data", accel_comp_2.data(), accel_comp_2.size());
+      writer.end_object();
+      writer.end_array();
+      writer.end_object();
+    };
+
+    writer.start_object();
+    writer.start_array("Events");
+
+    for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
+      for (unsigned int j = 0; j < num_realizations_; ++j) {
+        write_event(event_name + "_ParameterSetPulse" + std::to_string(i) +
+                        "_Sim" + std::to_string(j),
+                    pulse_motions_comp1[i][j], pulse_motions_comp2[i][j]);
+      }
+    }
+
+    for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
+      for (unsigned int j = 0; j < num_realizations_; ++j) {
+        write_event(event_name + "_ParameterSetNoPulse" + std::to_string(i) +
+                        "_Sim" + std::to_string(j + num_sims_pulse_),
+                    nopulse_motions_comp1[i][j], nopulse_motions_comp2[i][j]);
+      }
+    }
+
+    writer.end_array();
+    writer.end_object();
+    output_file << std::endl;
+    output_file.close();
+
+    if (output_file.fail()) {
+      throw std::runtime_error(
+          "\nERROR: In stochastic::DabaghiDerKiureghian::generate: Error when "
+          "closing output location\n");
+    }
   } catch (const std::exception& e) {
     std::cerr << e.what();
     status = false;
@@ -537,6 +517,68 @@ bool stochastic::DabaghiDerKiureghian::generate(
   return status;  
 }
 
+void stochastic::DabaghiDerKiureghian::simulate_motions(
+    std::vector<std::vector<std::vector<double>>>& pulse_motions_comp1,
+    std::vector<std::vector<std::vector<double>>>& pulse_motions_comp2,
+    std::vector<std::vector<std::vector<double>>>& nopulse_motions_comp1,
+    std::vector<std::vector<std::vector<double>>>& nopulse_motions_comp2) {
+  // Simulate model parameters
+  Eigen::MatrixXd parameters_pulse =
+      simulate_model_parameters(true, num_sims_pulse_);
+  Eigen::MatrixXd parameters_nopulse =
+      simulate_model_parameters(false, num_sims_nopulse_);
+
+  // Simulate pulse-like motions
+  for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
+    simulate_near_fault_ground_motion(
+        true, parameters_pulse.row(i), pulse_motions_comp1[i],
+        pulse_motions_comp2[i], num_realizations_);
+  }
+
+  // Simulate non-pulse-like motions
+  for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
+    simulate_near_fault_ground_motion(
+        false, parameters_nopulse.row(i), nopulse_motions_comp1[i],
+        nopulse_motions_comp2[i], num_realizations_);
+  }
+
+  // If requested, truncate and baseline correct time histories
+  double gfactor = 981;
+  unsigned int fit_order = 5;
+  if (truncate_) {
+    // First truncate motions
+    for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
+      truncate_time_histories(pulse_motions_comp1[i], pulse_motions_comp2[i],
+                              gfactor);
+    }
+
+    for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
+      truncate_time_histories(nopulse_motions_comp1[i],
+                              nopulse_motions_comp2[i], gfactor);
+    }
+
+    // Baseline correct truncated pulse-like motions
+    for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
+      for (unsigned int j = 0; j < num_realizations_; ++j) {
+        baseline_correct_time_history(pulse_motions_comp1[i][j], gfactor,
+                                      fit_order);
+        baseline_correct_time_history(pulse_motions_comp2[i][j], gfactor,
+                                      fit_order);
+      }
+    }
+
+    // Baseline correct truncated non-pulse-like motions
+    for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
+      for (unsigned int j = 0; j < num_realizations_; ++j) {
+        baseline_correct_time_history(nopulse_motions_comp1[i][j], gfactor,
+                                      fit_order);
+        baseline_correct_time_history(nopulse_motions_comp2[i][j], gfactor,
+                                      fit_order);
+      }
+    }
+  }
+}
+
 unsigned int stochastic::DabaghiDerKiureghian::simulate_pulse_type(
     unsigned int num_sims) const {
   double pulse_probability = 0.0;
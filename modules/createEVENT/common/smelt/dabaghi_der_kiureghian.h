@@ -134,8 +134,9 @@ class DabaghiDerKiureghian : public StochasticModel {
 
   /**
    * Generate ground motion time histories based on input parameters
-   * and write results to file in JSON format. Throws exception if
-   * errors are encountered during time history generation.
+   * and write results to file in JSON format. Time histories are streamed
+   * to file without building the complete JSON object first. Throws
+   * exception if errors are encountered during time history generation.
    * @param[in] event_name Name to assign to event
    * @param[in, out] output_location Location to write outputs to
    * @param[in] units Indicates that time histories should be returned in
@@ -376,6 +377,21 @@ class DabaghiDerKiureghian : public StochasticModel {
   void convert_time_history_units(std::vector<double>& time_history,
                                   bool units) const;  
 
+  /**
+   * Simulate pulse-like and non-pulse-like acceleration time histories for
+   * all simulated parameter sets, truncating and baseline correcting them if
+   * requested
+   * @param[in, out] pulse_motions_comp1 Component 1 of pulse-like motions
+   * @param[in, out] pulse_motions_comp2 Component 2 of pulse-like motions
+   * @param[in, out] nopulse_motions_comp1 Component 1 of non-pulse-like motions
+   * @param[in, out] nopulse_motions_comp2 Component 2 of non-pulse-like motions
+   */
+  void simulate_motions(
+      std::vector<std::vector<std::vector<double>>>& pulse_motions_comp1,
+      std::vector<std::vector<std::vector<double>>>& pulse_motions_comp2,
+      std::vector<std::vector<std::vector<double>>>& nopulse_motions_comp1,
+      std::vector<std::vector<std::vector<double>>>& nopulse_motions_comp2);
+
  private:
   FaultType faulting_;      /**< Enum for type of faulting for scenario */
   SimulationType sim_type_; /**< Enum for pulse-like nature of ground motion */
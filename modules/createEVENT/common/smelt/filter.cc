@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <stdexcept>
@@ -11,6 +13,7 @@
 
 // Eigen dense matrices
 #include <Eigen/Dense>
+#include "filter.h"
 
 namespace signal_processing {
 
@@ -145,37 +148,20 @@ std::function<std::vector<double>(std::vector<double>, std::vector<double>, int,
     // ippsFree(internal_calcs);
 
 
-    // Initialize impulse and samples vectors
+    if (static_cast<int>(numerator_coeffs.size()) != order + 1) {
+      throw std::runtime_error(
+          "\nERROR: in signal_processing::impulse_response: Number of filter "
+          "coefficients does not match filter order\n");
+    }
+
+    // Initialize impulse and apply the filter to it
     std::vector<double> impulse(num_samples, 0.0);
     impulse[0] = 1.0;  // Set first value to 1 for impulse
-    std::vector<double> samples(num_samples, 0.0);
-
-    // Convert the coefficient vectors to Eigen objects
-    Eigen::VectorXd b = Eigen::Map<const Eigen::VectorXd>(numerator_coeffs.data(), numerator_coeffs.size());
-    Eigen::VectorXd a = Eigen::Map<const Eigen::VectorXd>(denominator_coeffs.data(), denominator_coeffs.size());
+    std::vector<double> sample_vec(num_samples, 0.0);
 
-    if (a[0] == 0) {
-      throw std::runtime_error("Denominator's first coefficient (a[0]) cannot be zero");
-    }
-
-    // Normalize the coefficients
-    b /= a[0];
-    a /= a[0];
+    iir_filter(numerator_coeffs, denominator_coeffs, impulse.data(),
+               sample_vec.data(), num_samples);
 
-    // Apply the filter (difference equation)
-    for (int n = 0; n < num_samples; ++n) {
-      samples[n] = b[0] * impulse[n];
-      for (int i = 1; i <= order; ++i) {
-        if (n - i >= 0) {
-          samples[n] += b[i] * impulse[n - i] - a[i] * samples[n - i];
-        }
-      }
-    }
-    
-    std::vector<double> sample_vec(num_samples);
-    for (int i = 0; i < num_samples; ++i) {
-      sample_vec[i] = samples[i];
-    }
     return sample_vec;
   };
 }
@@ -221,4 +207,116 @@ std::function<std::vector<double>(double, double, unsigned int, unsigned int)>
     return filter_vector;
   };
 }
+
+namespace {
+/**
+ * Normalize filter coefficients by the first denominator coefficient
+ * @param[in] numerator_coeffs Numerator coefficients for filter
+ * @param[in] denominator_coeffs Denominator coefficients for filter
+ * @param[out] numerator Normalized numerator coefficients
+ * @param[out] denominator Normalized denominator coefficients
+ */
+void normalize_coefficients(const std::vector<double>& numerator_coeffs,
+                            const std::vector<double>& denominator_coeffs,
+                            std::vector<double>& numerator,
+                            std::vector<double>& denominator) {
+  if (numerator_coeffs.size() != denominator_coeffs.size()) {
+    throw std::runtime_error(
+        "\nERROR: in signal_processing::iir_filter: Inputs for numerator "
+        "and denominator coefficients not same length\n");
+  }
+
+  if (denominator_coeffs.empty() || denominator_coeffs[0] == 0) {
+    throw std::runtime_error(
+        "Denominator's first coefficient (a[0]) cannot be zero");
+  }
+
+  numerator.resize(numerator_coeffs.size());
+  denominator.resize(denominator_coeffs.size());
+  for (std::size_t i = 0; i < numerator_coeffs.size(); ++i) {
+    numerator[i] = numerator_coeffs[i] / denominator_coeffs[0];
+    denominator[i] = denominator_coeffs[i] / denominator_coeffs[0];
+  }
+}
+
+// Number of records filtered together in a single vectorized group
+constexpr std::size_t FILTER_LANES = 8;
+}  // namespace
+
+void iir_filter(const std::vector<double>& numerator_coeffs,
+                const std::vector<double>& denominator_coeffs,
+                const double* input, double* output, std::size_t num_samples) {
+  std::vector<double> b, a;
+  normalize_coefficients(numerator_coeffs, denominator_coeffs, b, a);
+  const std::size_t order = b.size() - 1;
+
+  // Apply the filter (difference equation)
+  for (std::size_t n = 0; n < num_samples; ++n) {
+    double sample = b[0] * input[n];
+    for (std::size_t i = 1; i <= order && i <= n; ++i) {
+      sample += b[i] * input[n - i] - a[i] * output[n - i];
+    }
+    output[n] = sample;
+  }
+}
+
+void iir_filter_batch(const std::vector<double>& numerator_coeffs,
+                      const std::vector<double>& denominator_coeffs,
+                      const double* input, double* output,
+                      std::size_t num_samples, std::size_t num_records) {
+  std::vector<double> b, a;
+  normalize_coefficients(numerator_coeffs, denominator_coeffs, b, a);
+  const std::size_t order = b.size() - 1;
+  const long num_groups =
+      static_cast<long>((num_records + FILTER_LANES - 1) / FILTER_LANES);
+
+#pragma omp parallel
+  {
+    // Records in a group are interleaved so that each step of the recursion
+    // operates on contiguous lanes
+    std::vector<double> group_input(num_samples * FILTER_LANES, 0.0);
+    std::vector<double> group_output(num_samples * FILTER_LANES, 0.0);
+
+#pragma omp for schedule(static)
+    for (long group = 0; group < num_groups; ++group) {
+      const std::size_t first = static_cast<std::size_t>(group) * FILTER_LANES;
+      const std::size_t lanes = std::min(FILTER_LANES, num_records - first);
+
+      for (std::size_t lane = 0; lane < lanes; ++lane) {
+        const double* record = input + (first + lane) * num_samples;
+        for (std::size_t n = 0; n < num_samples; ++n) {
+          group_input[n * FILTER_LANES + lane] = record[n];
+        }
+      }
+
+      for (std::size_t n = 0; n < num_samples; ++n) {
+        double* current = &group_output[n * FILTER_LANES];
+        const double* current_input = &group_input[n * FILTER_LANES];
+
+#pragma omp simd
+        for (std::size_t lane = 0; lane < FILTER_LANES; ++lane) {
+          current[lane] = b[0] * current_input[lane];
+        }
+
+        for (std::size_t i = 1; i <= order && i <= n; ++i) {
+          const double* past_input = &group_input[(n - i) * FILTER_LANES];
+          const double* past_output = &group_output[(n - i) * FILTER_LANES];
+          const double b_i = b[i], a_i = a[i];
+
+#pragma omp simd
+          for (std::size_t lane = 0; lane < FILTER_LANES; ++lane) {
+            current[lane] += b_i * past_input[lane] - a_i * past_output[lane];
+          }
+        }
+      }
+
+      for (std::size_t lane = 0; lane < lanes; ++lane) {
+        double* record = output + (first + lane) * num_samples;
+        for (std::size_t n = 0; n < num_samples; ++n) {
+          record[n] = group_output[n * FILTER_LANES + lane];
+        }
+      }
+    }
+  }
+}
 }  // namespace signal_processing
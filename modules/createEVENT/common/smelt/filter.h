@@ -1,6 +1,7 @@
 #ifndef _FILTER_H_
 #define _FILTER_H_
 
+#include <cstddef>
 #include <functional>
 #include <vector>
 
@@ -43,6 +44,38 @@ std::function<std::vector<double>(std::vector<double>, std::vector<double>, int,
  */
 std::function<std::vector<double>(double, double, unsigned int, unsigned int)>
     acausal_highpass_filter();
+
+/**
+ * Apply the filter defined by the input numerator and denominator coefficients
+ * to a single record, reading from and writing to caller-provided storage
+ * @param[in] numerator_coeffs Numerator coefficients for filter
+ * @param[in] denominator_coeffs Denominator coefficients for filter
+ * @param[in] input Pointer to first sample of record to filter
+ * @param[out] output Pointer to storage for filtered record, which must not
+ *                    overlap the input
+ * @param[in] num_samples Number of samples in record
+ */
+void iir_filter(const std::vector<double>& numerator_coeffs,
+                const std::vector<double>& denominator_coeffs,
+                const double* input, double* output, std::size_t num_samples);
+
+/**
+ * Apply the filter defined by the input numerator and denominator coefficients
+ * to a batch of records of equal length stored contiguously one after the
+ * other. Records are processed in groups, with the filter recursion
+ * vectorized across the records in each group.
+ * @param[in] numerator_coeffs Numerator coefficients for filter
+ * @param[in] denominator_coeffs Denominator coefficients for filter
+ * @param[in] input Pointer to first sample of first record to filter
+ * @param[out] output Pointer to storage for filtered records, using the same
+ *                    layout as the input
+ * @param[in] num_samples Number of samples in each record
+ * @param[in] num_records Number of records
+ */
+void iir_filter_batch(const std::vector<double>& numerator_coeffs,
+                      const std::vector<double>& denominator_coeffs,
+                      const double* input, double* output,
+                      std::size_t num_samples, std::size_t num_records);
 }  // namespace signal_processing
 
 #endif  // _FILTER_H_
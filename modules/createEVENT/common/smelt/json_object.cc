@@ -18,6 +18,54 @@ utilities::JsonObject::JsonObject(json library_json)
   json_object_ = library_json;
 }
 
+bool utilities::JsonObject::emplace_value(const std::string& key,
+                                          json&& value) {
+  if (!json_object_.emplace(key, std::move(value)).second) {
+    throw std::runtime_error(
+        "\nWARNING: In utilities::JsonObject::add_value: Input already "
+        "exists, so no value was added!\n");
+  }
+
+  return true;
+}
+
+bool utilities::JsonObject::add_value(const std::string& key,
+                                      JsonObject&& value) {
+  bool status = true;
+
+  try {
+    emplace_value(key, std::move(value.json_object_));
+    value.json_object_ = json::object();
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    status = false;
+    throw;
+  }
+
+  return status;
+}
+
+bool utilities::JsonObject::add_value(const std::string& key,
+                                      std::vector<JsonObject>&& value) {
+  bool status = true;
+
+  try {
+    json value_array = json::array();
+    value_array.get_ref<json::array_t&>().reserve(value.size());
+    for (auto& entry : value) {
+      value_array.push_back(std::move(entry.json_object_));
+      entry.json_object_ = json::object();
+    }
+    emplace_value(key, std::move(value_array));
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    status = false;
+    throw;
+  }
+
+  return status;
+}
+
 bool utilities::JsonObject::delete_key(const std::string& key) {
   bool status = true;
   
@@ -1,8 +1,11 @@
 #ifndef _JSON_OBJECT_H_
 #define _JSON_OBJECT_H_
 
+#include <cstddef>
 #include <iomanip>
 #include <iostream>
+#include <string>
+#include <vector>
 // JSON for Modern C++ single-include header
 #include <nlohmann/json.hpp>
 
@@ -30,6 +33,26 @@ class JsonObject {
    */
   virtual ~JsonObject() {};
 
+  /**
+   * @constructor Copy constructor
+   */
+  JsonObject(const JsonObject&) = default;
+
+  /**
+   * @constructor Move constructor
+   */
+  JsonObject(JsonObject&&) = default;
+
+  /**
+   * Copy assignment operator
+   */
+  JsonObject& operator=(const JsonObject&) = default;
+
+  /**
+   * Move assignment operator
+   */
+  JsonObject& operator=(JsonObject&&) = default;
+
   /**
    * Compares input JsonObject to this JsonObject for equality
    * @param[in] json_value JsonObject to compare this JsonObject to
@@ -58,7 +81,40 @@ class JsonObject {
    */
   template <typename Tparam>
   bool add_value(const std::string& key, const Tparam& value);
-  
+
+  /**
+   * Add JsonObject to key in JSON object, moving its contents rather than
+   * copying them. If key doesn't exist, it will automatically added.
+   * @param[in] key Key to add values to
+   * @param[in] value JsonObject to move to key
+   * @return Returns true if successful, false otherwise
+   */
+  bool add_value(const std::string& key, JsonObject&& value);
+
+  /**
+   * Add vector of JsonObjects to key in JSON object, moving their contents
+   * rather than copying them. If key doesn't exist, it will automatically
+   * added.
+   * @param[in] key Key to add values to
+   * @param[in] value Vector of JsonObjects to move to key
+   * @return Returns true if successful, false otherwise
+   */
+  bool add_value(const std::string& key, std::vector<JsonObject>&& value);
+
+  /**
+   * Add contiguous array of numeric values to key in JSON object. Storage
+   * for the whole array is reserved before values are inserted. If key
+   * doesn't exist, it will automatically added.
+   * @tparam Tnumeric Numeric type of values
+   * @param[in] key Key to add values to
+   * @param[in] values Pointer to first value in array
+   * @param[in] size Number of values in array
+   * @return Returns true if successful, false otherwise
+   */
+  template <typename Tnumeric>
+  bool add_array(const std::string& key, const Tnumeric* values,
+                 std::size_t size);
+
   /**
    * Get the value associated with the input key
    * @tparam Tparam Template parameter value
@@ -108,12 +164,26 @@ class JsonObject {
   };  
 
  protected:
+  /**
+   * Friend class for streaming JSON output
+   */
+  friend class JsonStreamWriter;
+
   /**
    * @constructor Construct JsonObject from underlying library object
    * @param[in] library_json Library JSON object
    */
   JsonObject(json library_json);
 
+  /**
+   * Move library JSON value to key in JSON object using a single lookup.
+   * Throws exception if key already exists.
+   * @param[in] key Key to add value to
+   * @param[in] value Library JSON value to move to key
+   * @return Returns true if successful, false otherwise
+   */
+  bool emplace_value(const std::string& key, json&& value);
+
   json json_object_; /**< JSON object for this class */
 };
 
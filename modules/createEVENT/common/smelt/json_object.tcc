@@ -9,13 +9,13 @@ bool utilities::JsonObject::add_value(const std::string& key,
   bool status = true;
     
   try {
-    if (json_object_.find(key) != json_object_.end()) {
+    // Emplace only inserts if the key is not present, so a single lookup
+    // both checks for and adds the key
+    if (!json_object_.emplace(key, value).second) {
       status = false;      
       throw std::runtime_error(
           "\nWARNING: In utilities::JsonObject::add_value: Input already "
           "exists, so no value was added!\n");
-    } else {
-      json_object_.emplace(key, value);
     }
   } catch (const std::exception& e) {
     std::cerr << e.what();
@@ -33,7 +33,7 @@ bool utilities::JsonObject::add_value(const std::string& key,
   bool status = true;
   
   try {
-    add_value<nlohmann::json>(key, value.get_library_json());
+    emplace_value(key, json(value.json_object_));
   } catch (const std::exception& e) {
     std::cerr << e.what();
     status = false;
@@ -49,12 +49,13 @@ bool utilities::JsonObject::add_value(const std::string& key, const std::vector<
   bool status = true;
 
   try {
-    // Create vector nlohmann::json type
-    std::vector<nlohmann::json> value_vector(value.size());   
-    for (unsigned int i = 0; i < value.size(); ++i) {
-      value_vector[i] = value[i].get_library_json();
-    }    
-    add_value<std::vector<nlohmann::json>>(key, value_vector);
+    // Create JSON array directly from the underlying library objects
+    json value_array = json::array();
+    value_array.get_ref<json::array_t&>().reserve(value.size());
+    for (const auto& entry : value) {
+      value_array.push_back(entry.json_object_);
+    }
+    emplace_value(key, std::move(value_array));
   } catch (const std::exception& e) {
     std::cerr << e.what();
     status = false;
@@ -64,6 +65,37 @@ bool utilities::JsonObject::add_value(const std::string& key, const std::vector<
   return status;  
 }
 
+/**< Template specialization for case when input value is vector of doubles */
+template <> inline
+bool utilities::JsonObject::add_value(const std::string& key,
+                                      const std::vector<double>& value) {
+  return add_array(key, value.data(), value.size());
+}
+
+/**< Add contiguous array of numeric values to key */
+template <typename Tnumeric> inline
+bool utilities::JsonObject::add_array(const std::string& key,
+                                      const Tnumeric* values,
+                                      std::size_t size) {
+  bool status = true;
+
+  try {
+    json value_array = json::array();
+    auto& array_storage = value_array.get_ref<json::array_t&>();
+    array_storage.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      array_storage.emplace_back(values[i]);
+    }
+    emplace_value(key, std::move(value_array));
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    status = false;
+    throw;
+  }
+
+  return status;
+}
+
 /**< Get value at input key */
 template <typename Tparam>
 Tparam utilities::JsonObject::get_value(const std::string& key) const {
@@ -0,0 +1,173 @@
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+// JSON for Modern C++ single-include header
+#include <nlohmann/json.hpp>
+#include "json_stream_writer.h"
+
+utilities::JsonStreamWriter::JsonStreamWriter(std::ostream& output)
+    : output_{output} {}
+
+void utilities::JsonStreamWriter::start_object(const std::string& key) {
+  next_entry(key);
+  output_ << '{';
+  scopes_.push_back(Scope{true, true, "", {}});
+}
+
+void utilities::JsonStreamWriter::end_object() {
+  if (scopes_.empty() || !scopes_.back().is_object) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonStreamWriter::end_object: No object is "
+        "currently open\n");
+  }
+  end_scope(true, '}');
+}
+
+void utilities::JsonStreamWriter::start_array(const std::string& key) {
+  next_entry(key);
+  output_ << '[';
+  scopes_.push_back(Scope{false, true, "", {}});
+}
+
+void utilities::JsonStreamWriter::end_array() {
+  if (scopes_.empty() || scopes_.back().is_object) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonStreamWriter::end_array: No array is "
+        "currently open\n");
+  }
+  end_scope(false, ']');
+}
+
+void utilities::JsonStreamWriter::add_fields(const JsonObject& fields) {
+  for (auto it = fields.json_object_.begin(); it != fields.json_object_.end();
+       ++it) {
+    write_value(it.key(), it.value());
+  }
+}
+
+void utilities::JsonStreamWriter::add_array(const std::string& key,
+                                            const double* values,
+                                            std::size_t size) {
+  next_entry(key);
+  if (size == 0) {
+    output_ << "[]";
+    return;
+  }
+
+  // Values are formatted into a buffer that is flushed to the output stream
+  // in large blocks rather than one value at a time. Each value is on its own
+  // line, indented one level deeper than the key.
+  const std::size_t flush_size = 1 << 16;
+  const std::string separator =
+      ",\n" + std::string(4 * (scopes_.size() + 1), ' ');
+  buffer_.assign("[\n");
+  buffer_.append(separator, 2, std::string::npos);
+  for (std::size_t i = 0; i < size; ++i) {
+    if (i > 0) {
+      buffer_.append(separator);
+    }
+    write_number(values[i]);
+    if (buffer_.size() >= flush_size) {
+      output_.write(buffer_.data(), buffer_.size());
+      buffer_.clear();
+    }
+  }
+  buffer_.push_back('\n');
+  buffer_.append(4 * scopes_.size(), ' ');
+  buffer_.push_back(']');
+  output_.write(buffer_.data(), buffer_.size());
+}
+
+void utilities::JsonStreamWriter::write_separator() {
+  Scope& scope = scopes_.back();
+  if (!scope.first_entry) {
+    output_ << ',';
+  }
+  scope.first_entry = false;
+  output_ << '\n' << std::string(4 * scopes_.size(), ' ');
+}
+
+void utilities::JsonStreamWriter::next_entry(const std::string& key) {
+  if (scopes_.empty()) {
+    return;
+  }
+
+  if (scopes_.back().is_object) {
+    write_held_values(key);
+    if (key <= scopes_.back().last_key) {
+      throw std::runtime_error(
+          "\nERROR: In utilities::JsonStreamWriter::next_entry: Key " + key +
+          " is not written in sorted order\n");
+    }
+    scopes_.back().last_key = key;
+    write_separator();
+    output_ << json(key).dump() << ": ";
+  } else {
+    write_separator();
+  }
+}
+
+void utilities::JsonStreamWriter::write_value(const std::string& key,
+                                              const json& value) {
+  // Nested lines of the value are indented to the level of the entry
+  std::string text = value.dump(4);
+  std::string indent(4 * scopes_.size(), ' ');
+  for (std::size_t i = text.find('\n'); i != std::string::npos;
+       i = text.find('\n', i + 1)) {
+    text.insert(i + 1, indent);
+  }
+
+  if (scopes_.empty() || !scopes_.back().is_object) {
+    next_entry(key);
+    output_ << text;
+    return;
+  }
+
+  if (key < scopes_.back().last_key) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonStreamWriter::write_value: Key " + key +
+        " is not written in sorted order\n");
+  }
+  scopes_.back().held_values[key] = std::move(text);
+}
+
+void utilities::JsonStreamWriter::write_held_values(const std::string& key) {
+  Scope& scope = scopes_.back();
+  auto last = key.empty() ? scope.held_values.end()
+                          : scope.held_values.lower_bound(key);
+  for (auto it = scope.held_values.begin(); it != last; ++it) {
+    write_separator();
+    output_ << json(it->first).dump() << ": " << it->second;
+    scope.last_key = it->first;
+  }
+  scope.held_values.erase(scope.held_values.begin(), last);
+}
+
+void utilities::JsonStreamWriter::end_scope(bool is_object, char close) {
+  if (is_object) {
+    write_held_values("");
+  }
+
+  bool empty = scopes_.back().first_entry;
+  scopes_.pop_back();
+  if (!empty) {
+    output_ << '\n' << std::string(4 * scopes_.size(), ' ');
+  }
+  output_ << close;
+}
+
+void utilities::JsonStreamWriter::write_number(double value) {
+  // JSON has no representation for NaN or infinity, so write null as the
+  // JSON library does
+  if (!std::isfinite(value)) {
+    buffer_.append("null");
+    return;
+  }
+
+  // Numbers are formatted as the JSON library formats them, so integral
+  // values keep their decimal point and are read back as reals
+  char number[64];
+  char* end = nlohmann::detail::to_chars(number, number + sizeof(number), value);
+  buffer_.append(number, end);
+}
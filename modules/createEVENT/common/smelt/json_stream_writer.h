@@ -0,0 +1,169 @@
+#ifndef _JSON_STREAM_WRITER_H_
+#define _JSON_STREAM_WRITER_H_
+
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "json_object.h"
+
+namespace utilities {
+
+/**
+ * Class for writing JSON directly to an output stream without building
+ * the complete document in memory first. Objects and arrays are opened
+ * and closed explicitly, while numeric arrays are formatted straight from
+ * contiguous storage. Output is byte-identical to JsonObject::write_to_file
+ * for the same document: indented by four spaces, with the keys of each
+ * object in sorted order and numbers formatted by the JSON library. Small
+ * values written to an object with add_value or add_fields are held back
+ * and written in key order around the objects and arrays streamed into it,
+ * which have to be opened in key order.
+ */
+class JsonStreamWriter {
+ public:
+  /**
+   * @constructor Delete default constructor
+   */
+  JsonStreamWriter() = delete;
+
+  /**
+   * @constructor Construct writer for input output stream
+   * @param[in, out] output Output stream to write JSON to
+   */
+  explicit JsonStreamWriter(std::ostream& output);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~JsonStreamWriter() {};
+
+  /**
+   * Delete copy constructor
+   */
+  JsonStreamWriter(const JsonStreamWriter&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  JsonStreamWriter& operator=(const JsonStreamWriter&) = delete;
+
+  /**
+   * Open JSON object. At the top level or inside arrays, the key is omitted.
+   * @param[in] key Key of object when inside another object, which has to
+   *                sort after the keys already streamed into that object
+   */
+  void start_object(const std::string& key = "");
+
+  /**
+   * Close the currently open JSON object
+   */
+  void end_object();
+
+  /**
+   * Open JSON array. At the top level or inside arrays, the key is omitted.
+   * @param[in] key Key of array when inside an object, which has to sort
+   *                after the keys already streamed into that object
+   */
+  void start_array(const std::string& key = "");
+
+  /**
+   * Close the currently open JSON array
+   */
+  void end_array();
+
+  /**
+   * Write key-value pair to currently open object, or value to currently
+   * open array. Values are serialized using the underlying JSON library and
+   * held back in objects until their key is due, so this should only be used
+   * for small values.
+   * @tparam Tparam Template parameter for value
+   * @param[in] key Key to write value to
+   * @param[in] value Value to write
+   */
+  template <typename Tparam>
+  void add_value(const std::string& key, const Tparam& value);
+
+  /**
+   * Write all key-value pairs of input JsonObject to currently open object
+   * @param[in] fields JsonObject containing key-value pairs to write
+   */
+  void add_fields(const JsonObject& fields);
+
+  /**
+   * Write contiguous array of values to key in currently open object,
+   * formatting values directly from the input storage
+   * @param[in] key Key to write array to, which has to sort after the keys
+   *                already streamed into the object
+   * @param[in] values Pointer to first value in array
+   * @param[in] size Number of values in array
+   */
+  void add_array(const std::string& key, const double* values,
+                 std::size_t size);
+
+ private:
+  /**
+   * Open object or array that is currently open
+   */
+  struct Scope {
+    bool is_object; /**< Indicates that scope is an object */
+    bool first_entry; /**< Indicates that no entry has been written yet */
+    std::string last_key; /**< Last key written to object */
+    std::map<std::string, std::string> held_values; /**< Serialized values
+                                                        waiting for their key
+                                                        to be due, by key */
+  };
+
+  /**
+   * Write separator and indentation before next entry in the currently open
+   * object or array
+   */
+  void write_separator();
+
+  /**
+   * Write separator, indentation and key, if required, before next entry in
+   * the currently open object or array. In objects, the held values whose
+   * keys sort before the key are written first.
+   * @param[in] key Key of next entry
+   */
+  void next_entry(const std::string& key);
+
+  /**
+   * Write value serialized by the JSON library, or hold it back until its
+   * key is due when inside an object
+   * @param[in] key Key of value
+   * @param[in] value JSON value to write
+   */
+  void write_value(const std::string& key, const json& value);
+
+  /**
+   * Write held values of currently open object with keys sorting before
+   * input key
+   * @param[in] key Key before which held values are written, or empty to
+   *                write all held values
+   */
+  void write_held_values(const std::string& key);
+
+  /**
+   * Close the currently open object or array
+   * @param[in] is_object Indicates that an object is closed
+   * @param[in] close Closing character
+   */
+  void end_scope(bool is_object, char close);
+
+  /**
+   * Append a single number to buffer
+   * @param[in] value Value to write
+   */
+  void write_number(double value);
+
+  std::ostream& output_; /**< Output stream JSON is written to */
+  std::vector<Scope> scopes_; /**< Stack of open objects and arrays */
+  std::string buffer_; /**< Buffer used when formatting numeric arrays */
+};
+}  // namespace utilities
+
+#include "json_stream_writer.tcc"
+
+#endif  // _JSON_STREAM_WRITER_H_
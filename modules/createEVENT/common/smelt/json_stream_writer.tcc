@@ -0,0 +1,33 @@
+#include <string>
+
+/**< Write key-value pair to currently open object */
+template <typename Tparam> inline
+void utilities::JsonStreamWriter::add_value(const std::string& key,
+                                            const Tparam& value) {
+  write_value(key, json(value));
+}
+
+/**< Template specialization for case when input value is JsonObject */
+template <> inline
+void utilities::JsonStreamWriter::add_value(const std::string& key,
+                                            const utilities::JsonObject& value) {
+  write_value(key, value.json_object_);
+}
+
+/**< Template specialization for case when input value is vector of JsonObjects */
+template <> inline
+void utilities::JsonStreamWriter::add_value(
+    const std::string& key, const std::vector<utilities::JsonObject>& value) {
+  json array = json::array();
+  for (const auto& entry : value) {
+    array.push_back(entry.json_object_);
+  }
+  write_value(key, array);
+}
+
+/**< Template specialization for case when input value is vector of doubles */
+template <> inline
+void utilities::JsonStreamWriter::add_value(const std::string& key,
+                                            const std::vector<double>& value) {
+  add_array(key, value.data(), value.size());
+}
@@ -269,7 +269,55 @@ bool inverse_fft(const Eigen::VectorXcd& input_vector,
               << e.what() << std::endl;
   }
 
-  return true;  
+  return true;
+}
+
+bool inverse_fft(const Eigen::MatrixXcd& input_matrix,
+                 Eigen::MatrixXd& output_matrix) {
+  const int n = static_cast<int>(input_matrix.rows());
+  const int num_series = static_cast<int>(input_matrix.cols());
+  output_matrix.resize(n, num_series);
+
+  if (n == 0 || num_series == 0) {
+    return true;
+  }
+
+  // All columns have the same length, so a single configuration is shared by
+  // every transform. KissFFT only reads the configuration during an
+  // out-of-place transform, so it is safe to use from multiple threads.
+  kiss_fft_cfg cfg = kiss_fft_alloc(n, 1, nullptr, nullptr);
+  if (!cfg) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::inverse_fft (Batched): Failed to allocate "
+        "KissFFT configuration\n");
+  }
+
+#pragma omp parallel
+  {
+    // Work buffers are allocated once per thread and reused for every column
+    std::vector<kiss_fft_cpx> input_kissfft(n);
+    std::vector<kiss_fft_cpx> output_kissfft(n);
+
+#pragma omp for schedule(static)
+    for (int col = 0; col < num_series; ++col) {
+      const std::complex<double>* column = input_matrix.col(col).data();
+      for (int i = 0; i < n; ++i) {
+        input_kissfft[i].r = static_cast<kiss_fft_scalar>(column[i].real());
+        input_kissfft[i].i = static_cast<kiss_fft_scalar>(column[i].imag());
+      }
+
+      kiss_fft(cfg, input_kissfft.data(), output_kissfft.data());
+
+      double* output = output_matrix.col(col).data();
+      for (int i = 0; i < n; ++i) {
+        output[i] = output_kissfft[i].r / n;
+      }
+    }
+  }
+
+  free(cfg);
+
+  return true;
 }
 
 bool fft(std::vector<double> input_vector,
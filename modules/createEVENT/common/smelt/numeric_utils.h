@@ -62,6 +62,19 @@ bool inverse_fft(const Eigen::VectorXcd& input_vector,
 bool inverse_fft(const Eigen::VectorXcd& input_vector,
                  std::vector<double>& output_vector);
 
+/**
+ * Computes the real portion of the 1-dimensional inverse Fast Fourier Transform
+ * (FFT) of each column of the input matrix. All transforms share a single FFT
+ * plan and are distributed over the available threads when OpenMP is enabled.
+ * @param[in] input_matrix Matrix whose columns are the vectors to compute the
+ *                         inverse FFT of
+ * @param[in, out] output_matrix Matrix to write outputs to, with one column
+ *                               per input column
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_fft(const Eigen::MatrixXcd& input_matrix,
+                 Eigen::MatrixXd& output_matrix);
+
 /**
  * Computes the real portion of the 1-dimensional Fast Fourier Transform
  * (FFT) of the input vector
@@ -1,7 +1,9 @@
 #ifndef _STOCHASTIC_MODEL_H_
 #define _STOCHASTIC_MODEL_H_
 
+#include <cstddef>
 #include <string>
+#include <vector>
 #include "json_object.h"
 
 namespace stochastic {
@@ -64,6 +66,51 @@ class StochasticModel {
                         bool units = false) = 0;
 
  protected:
+  /**
+   * Get the fields of a seismic event with uniform acceleration patterns for
+   * time series accel_x and accel_y, excluding the time series themselves.
+   * Shared by the JSON object and streaming outputs of the ground motion
+   * models so both write the same layout.
+   * @param[in] name Name of event
+   * @param[in] time_step Time step of time histories
+   * @param[in] num_steps Number of steps in time histories
+   * @return JsonObject containing event fields
+   */
+  static utilities::JsonObject seismic_event_fields(const std::string& name,
+                                                    double time_step,
+                                                    std::size_t num_steps) {
+    std::vector<utilities::JsonObject> patterns(2);
+    patterns[0].add_value("type", "UniformAcceleration");
+    patterns[0].add_value("timeSeries", "accel_x");
+    patterns[0].add_value("dof", 1);
+    patterns[1].add_value("type", "UniformAcceleration");
+    patterns[1].add_value("timeSeries", "accel_y");
+    patterns[1].add_value("dof", 2);
+
+    utilities::JsonObject fields;
+    fields.add_value("name", name);
+    fields.add_value("type", "Seismic");
+    fields.add_value("dT", time_step);
+    fields.add_value("numSteps", num_steps);
+    fields.add_value("pattern", std::move(patterns));
+    return fields;
+  }
+
+  /**
+   * Get the fields of a time series, excluding its data
+   * @param[in] name Name of time series
+   * @param[in] time_step Time step of time series
+   * @return JsonObject containing time series fields
+   */
+  static utilities::JsonObject time_series_fields(const std::string& name,
+                                                  double time_step) {
+    utilities::JsonObject fields;
+    fields.add_value("name", name);
+    fields.add_value("type", "Value");
+    fields.add_value("dT", time_step);
+    return fields;
+  }
+
   std::string model_name_ = "StochasticModel"; /**< Name of stochastic model */  
 };
 }  // namespace stochastic
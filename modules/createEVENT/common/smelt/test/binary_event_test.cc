@@ -0,0 +1,154 @@
+// Round trip test of the smelt binary event container. Writes events with
+// double and single precision histories, reads them back and checks that every
+// value is restored bit for bit and that the container is little-endian.
+//
+// Usage:
+//   smelt_binary_event_test
+// Files are written to the current directory. Returns the number of failures.
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+// JSON for Modern C++ single-include header
+#include <nlohmann/json.hpp>
+
+#include "binary_event.h"
+
+namespace {
+/**
+ * Generate event with several time series of random values, including zero
+ * length series and values spanning many orders of magnitude
+ * @return Event in the format generated by the stochastic models
+ */
+nlohmann::json random_event() {
+  std::mt19937_64 generator(100);
+  std::normal_distribution<double> mantissa(0.0, 1.0);
+  std::uniform_int_distribution<int> exponent(-30, 30);
+
+  nlohmann::json time_series = nlohmann::json::array();
+  std::vector<unsigned int> lengths = {1000, 0, 1, 4097};
+  for (unsigned int i = 0; i < lengths.size(); ++i) {
+    std::vector<double> data(lengths[i]);
+    for (auto& value : data) {
+      value = mantissa(generator) * std::pow(10.0, exponent(generator));
+    }
+    if (!data.empty()) {
+      data[0] = -0.0;
+    }
+    time_series.push_back({{"name", "accel_" + std::to_string(i)},
+                           {"dT", 0.01},
+                           {"data", data}});
+  }
+
+  return nlohmann::json::object(
+      {{"Events",
+        nlohmann::json::array({{{"type", "Seismic"},
+                                {"timeSeries", time_series}}})}});
+}
+
+/**
+ * Check that histories of read event match those of written event bit for
+ * bit, after rounding to single precision if requested
+ * @param[in] written Event passed to write_binary_event
+ * @param[in] read Event returned by read_binary_event
+ * @param[in] single Whether values were stored in single precision
+ * @return Number of mismatching values or series
+ */
+int compare_events(const nlohmann::json& written, const nlohmann::json& read,
+                   bool single) {
+  if (read.contains("binaryData") || read["Events"].size() != 1) {
+    return 1;
+  }
+
+  const auto& expected_series = written["Events"][0]["timeSeries"];
+  const auto& actual_series = read["Events"][0]["timeSeries"];
+  if (expected_series.size() != actual_series.size()) {
+    return 1;
+  }
+
+  int mismatches = 0;
+  for (unsigned int i = 0; i < expected_series.size(); ++i) {
+    if (actual_series[i].contains("dataIndex") ||
+        actual_series[i]["name"] != expected_series[i]["name"]) {
+      ++mismatches;
+      continue;
+    }
+    auto expected = expected_series[i]["data"].get<std::vector<double>>();
+    auto actual = actual_series[i]["data"].get<std::vector<double>>();
+    if (expected.size() != actual.size()) {
+      ++mismatches;
+      continue;
+    }
+    for (unsigned int j = 0; j < expected.size(); ++j) {
+      double value = single ? static_cast<float>(expected[j]) : expected[j];
+      if (std::memcmp(&value, &actual[j], sizeof(double)) != 0) {
+        ++mismatches;
+      }
+    }
+  }
+
+  return mismatches;
+}
+
+/**
+ * Check that the value size field of a container is stored little-endian
+ * @param[in] location Location of binary container
+ * @param[in] value_size Expected value size in bytes
+ * @return Returns true if the field bytes are little-endian
+ */
+bool little_endian_header(const std::string& location,
+                          unsigned char value_size) {
+  std::ifstream input_file(location, std::ios::binary);
+  char header[16];
+  input_file.read(header, sizeof(header));
+  const unsigned char expected[4] = {value_size, 0, 0, 0};
+  return input_file && std::memcmp(header + 12, expected, 4) == 0;
+}
+}  // namespace
+
+int main() {
+  int failures = 0;
+  nlohmann::json event = random_event();
+
+  struct Case {
+    std::string name;
+    utilities::BinaryPrecision precision;
+    unsigned char value_size;
+  };
+  std::vector<Case> cases = {
+      {"float64", utilities::BinaryPrecision::Float64, 8},
+      {"float32", utilities::BinaryPrecision::Float32, 4}};
+
+  for (const auto& current : cases) {
+    std::string sidecar = "binary_event_test_" + current.name + ".json";
+    int mismatches = 0;
+    try {
+      utilities::write_binary_event(event, sidecar, current.precision);
+      nlohmann::json read = utilities::read_binary_event(sidecar);
+      mismatches = compare_events(
+          event, read, current.precision == utilities::BinaryPrecision::Float32);
+      if (!little_endian_header("binary_event_test_" + current.name + ".bin",
+                                current.value_size)) {
+        ++mismatches;
+      }
+    } catch (const std::exception& error) {
+      std::cout << current.name << " FAILED: " << error.what() << std::endl;
+      ++failures;
+      continue;
+    }
+
+    if (mismatches == 0) {
+      std::cout << current.name << " passed" << std::endl;
+    } else {
+      std::cout << current.name << " FAILED: " << mismatches
+                << " mismatching values" << std::endl;
+      ++failures;
+    }
+  }
+
+  return failures;
+}
@@ -0,0 +1,88 @@
+// Equivalence test of the batched IIR filter. Filters random records with
+// iir_filter_batch and with iir_filter one record at a time and checks that
+// every sample agrees to within 1e-12 of the record's peak.
+//
+// Usage:
+//   smelt_filter_test
+// Returns the number of failures.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "filter.h"
+
+namespace {
+const double TOLERANCE = 1e-12; /**< Allowed difference relative to peak */
+
+/**
+ * Filter random records in a batch and one at a time and compare results
+ * @param[in] name Name of test case
+ * @param[in] coeffs Numerator and denominator coefficients of filter
+ * @param[in] num_samples Number of samples in each record
+ * @param[in] num_records Number of records
+ * @return Returns true if batched and single record results agree
+ */
+bool check_batch(const std::string& name,
+                 const std::vector<std::vector<double>>& coeffs,
+                 std::size_t num_samples, std::size_t num_records) {
+  std::mt19937_64 generator(100);
+  std::normal_distribution<double> distribution(0.0, 1.0);
+  std::vector<double> input(num_samples * num_records);
+  for (auto& value : input) {
+    value = distribution(generator);
+  }
+
+  std::vector<double> batch(input.size(), 0.0), single(input.size(), 0.0);
+  signal_processing::iir_filter_batch(coeffs[0], coeffs[1], input.data(),
+                                      batch.data(), num_samples, num_records);
+  for (std::size_t i = 0; i < num_records; ++i) {
+    signal_processing::iir_filter(coeffs[0], coeffs[1],
+                                  input.data() + i * num_samples,
+                                  single.data() + i * num_samples,
+                                  num_samples);
+  }
+
+  double max_error = 0.0;
+  for (std::size_t i = 0; i < num_records; ++i) {
+    double peak = 0.0, error = 0.0;
+    for (std::size_t n = i * num_samples; n < (i + 1) * num_samples; ++n) {
+      peak = std::max(peak, std::abs(single[n]));
+      error = std::max(error, std::abs(batch[n] - single[n]));
+    }
+    // NaN errors fail the comparison below
+    max_error = std::max(max_error, peak > 0.0 ? error / peak : error);
+    if (!(error <= TOLERANCE * std::max(peak, 1.0))) {
+      std::cout << name << " FAILED: record " << i << " differs by " << error
+                << std::endl;
+      return false;
+    }
+  }
+
+  std::cout << name << " passed, max relative difference " << max_error
+            << std::endl;
+  return true;
+}
+}  // namespace
+
+int main() {
+  int failures = 0;
+  // Butterworth highpass filter used by Vlachos et al. and a low order filter
+  // whose first denominator coefficient is not normalized
+  auto butterworth = signal_processing::hp_butterworth()(4, 0.004);
+  std::vector<std::vector<double>> low_order = {{0.4, 0.8, 0.4},
+                                                {2.0, -1.2, 0.6}};
+
+  // Partial last group, records shorter than the filter order and a single
+  // record
+  failures += !check_batch("order 4, 21 records", butterworth, 4000, 21);
+  failures += !check_batch("order 2, 16 records", low_order, 1000, 16);
+  failures += !check_batch("order 4, short records", butterworth, 3, 11);
+  failures += !check_batch("order 4, 1 record", butterworth, 500, 1);
+
+  return failures;
+}
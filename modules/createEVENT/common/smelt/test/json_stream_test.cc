@@ -0,0 +1,173 @@
+// Equivalence test of the streaming JSON output. Writes the same documents
+// with JsonStreamWriter and with JsonObject::write_to_file and checks that the
+// files are byte-identical: a document holding integral, signed zero, tiny,
+// huge and non-finite numbers, empty arrays and keys written out of sorted
+// order, and the events generated by VlachosEtAl, DabaghiDerKiureghian and
+// WittigSinha for a fixed seed.
+//
+// Usage:
+//   smelt_json_stream_test
+// Files are written to the current directory. Returns the number of failures.
+
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "configure.h"
+#include "dabaghi_der_kiureghian.h"
+#include "json_object.h"
+#include "json_stream_writer.h"
+#include "stochastic_model.h"
+#include "vlachos_et_al.h"
+#include "wittig_sinha.h"
+
+namespace {
+/**
+ * Read the contents of a file
+ * @param[in] file_name Name of file to read
+ * @return Contents of file
+ */
+std::string read_file(const std::string& file_name) {
+  std::ifstream file(file_name, std::ios::binary);
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+/**
+ * Compare two files byte for byte
+ * @param[in] name Name of test case
+ * @param[in] stream_file File written by streaming output
+ * @param[in] object_file File written by JsonObject output
+ * @return Returns true if files are identical
+ */
+bool check_identical(const std::string& name, const std::string& stream_file,
+                     const std::string& object_file) {
+  std::string streamed = read_file(stream_file);
+  std::string expected = read_file(object_file);
+  if (expected.empty() || streamed != expected) {
+    std::size_t position = 0;
+    while (position < streamed.size() && position < expected.size() &&
+           streamed[position] == expected[position]) {
+      ++position;
+    }
+    std::cout << name << " FAILED: " << stream_file << " differs from "
+              << object_file << " at byte " << position << std::endl;
+    return false;
+  }
+
+  std::cout << name << " passed, " << expected.size() << " bytes" << std::endl;
+  return true;
+}
+
+/**
+ * Write a document exercising number formatting and key order both ways
+ * @return Returns true if both files are identical
+ */
+bool check_document() {
+  std::vector<double> data{1.0,   -0.0,   0.0,  2.5, -3.0, 1e-7,   1.0e-4,
+                           1e15,  1e16,   1e20, 0.1, 1.0 / 3.0, 123456789.0,
+                           std::numeric_limits<double>::quiet_NaN(),
+                           std::numeric_limits<double>::infinity()};
+  std::vector<double> empty;
+
+  utilities::JsonObject fields;
+  fields.add_value("name", "accel_x");
+  fields.add_value("dT", 0.01);
+  fields.add_value("factor", 1.0);
+
+  utilities::JsonObject pattern;
+  pattern.add_value("type", "UniformAcceleration");
+  pattern.add_value("dof", 1);
+
+  utilities::JsonObject event = fields;
+  event.add_array("data", data.data(), data.size());
+  event.add_array("empty", empty.data(), empty.size());
+  event.add_value("pattern", std::vector<utilities::JsonObject>{pattern});
+  event.add_value("nested", utilities::JsonObject());
+  utilities::JsonObject document;
+  document.add_value("zeta", 2.0);
+  document.add_value("numSteps", 15);
+  document.add_value("Events", std::vector<utilities::JsonObject>{event});
+  document.write_to_file("document_object.json");
+
+  std::ofstream output("document_stream.json");
+  utilities::JsonStreamWriter writer(output);
+  writer.start_object();
+  writer.add_value("zeta", 2.0);
+  writer.add_value("numSteps", 15);
+  writer.start_array("Events");
+  writer.start_object();
+  writer.add_value("pattern", std::vector<utilities::JsonObject>{pattern});
+  writer.add_fields(fields);
+  writer.add_array("data", data.data(), data.size());
+  writer.add_array("empty", empty.data(), empty.size());
+  writer.start_object("nested");
+  writer.end_object();
+  writer.end_object();
+  writer.end_array();
+  writer.end_object();
+  output << std::endl;
+  output.close();
+
+  return check_identical("document", "document_stream.json",
+                         "document_object.json");
+}
+
+/**
+ * Generate events of two models constructed with the same seed, one written
+ * through the JSON object and one streamed, and compare the files
+ * @param[in] name Name of test case
+ * @param[in] object_model Model whose JSON object output is written
+ * @param[in] stream_model Model whose output is streamed
+ * @param[in] units Indicates that time histories are returned in ft/s
+ * @return Returns true if both files are identical
+ */
+bool check_model(const std::string& name,
+                 stochastic::StochasticModel& object_model,
+                 stochastic::StochasticModel& stream_model, bool units) {
+  object_model.generate("event", units).write_to_file(name + "_object.json");
+  stream_model.generate("event", name + "_stream.json", units);
+  return check_identical(name, name + "_stream.json", name + "_object.json");
+}
+}  // namespace
+
+int main() {
+  config::initialize();
+
+  int failures = 0;
+  failures += !check_document();
+
+  {
+    stochastic::VlachosEtAl object_model(6.5, 20.0, 400.0, 0.0, 2, 2, 7);
+    stochastic::VlachosEtAl stream_model(6.5, 20.0, 400.0, 0.0, 2, 2, 7);
+    failures += !check_model("VlachosEtAl", object_model, stream_model, true);
+  }
+
+  {
+    stochastic::DabaghiDerKiureghian object_model(
+        stochastic::FaultType::StrikeSlip,
+        stochastic::SimulationType::PulseAndNoPulse, 6.5, 2.0, 10.0, 400.0,
+        10.0, 10.0, 3, 2, true, 5);
+    stochastic::DabaghiDerKiureghian stream_model(
+        stochastic::FaultType::StrikeSlip,
+        stochastic::SimulationType::PulseAndNoPulse, 6.5, 2.0, 10.0, 400.0,
+        10.0, 10.0, 3, 2, true, 5);
+    failures += !check_model("DabaghiDerKiureghian", object_model,
+                             stream_model, false);
+  }
+
+  {
+    std::vector<double> heights{10.0, 20.0, 30.0};
+    stochastic::WittigSinha object_model("B", 100.0, heights, {0.0, 5.0},
+                                         {0.0}, 60.0, 3);
+    stochastic::WittigSinha stream_model("B", 100.0, heights, {0.0, 5.0},
+                                         {0.0}, 60.0, 3);
+    failures += !check_model("WittigSinha", object_model, stream_model, true);
+  }
+
+  return failures;
+}
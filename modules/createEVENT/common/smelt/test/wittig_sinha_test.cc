@@ -0,0 +1,175 @@
+// Equivalence test of the grid locations and batched inverse FFTs of
+// WittigSinha. For a fixed seed the time histories of all locations, computed
+// with one batch of inverse FFTs, are compared with the inverse FFT of each
+// location on its own. The cross-spectral density of a grid has to be
+// symmetric and positive definite, and its blocks along each vertical line
+// have to equal the cross-spectral density of a single vertical line.
+//
+// Usage:
+//   smelt_wittig_sinha_test
+// Returns the number of failures.
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+#include "configure.h"
+#include "numeric_utils.h"
+#include "wittig_sinha.h"
+
+namespace {
+const double TOLERANCE = 1e-12; /**< Allowed difference relative to peak */
+
+/**
+ * Compute the time history of one location on its own, as in Equations 7 & 8
+ * of Wittig & Sinha (1975)
+ * @param[in] random_numbers Matrix of complex random numbers, with one column
+ *                           per location
+ * @param[in] column_index Location to compute time history of
+ * @param[in] units Indicates that time history should be returned in ft/s
+ * @return Vector containing time history of location
+ */
+std::vector<double> location_hist(const Eigen::MatrixXcd& random_numbers,
+                                  unsigned int column_index, bool units) {
+  unsigned int num_freqs = random_numbers.rows();
+  Eigen::VectorXcd complex_full_range = Eigen::VectorXcd::Zero(2 * num_freqs);
+  complex_full_range.segment(1, num_freqs) = random_numbers.col(column_index);
+  complex_full_range.segment(num_freqs + 1, num_freqs - 1) =
+      random_numbers.col(column_index)
+          .head(num_freqs - 1)
+          .reverse()
+          .conjugate();
+  complex_full_range(num_freqs) =
+      std::abs(random_numbers(num_freqs - 1, column_index));
+
+  std::vector<double> time_history(complex_full_range.size());
+  numeric_utils::inverse_fft(complex_full_range, time_history);
+  if (units) {
+    for (auto& value : time_history) {
+      value = value * 3.28084;
+    }
+  }
+  return time_history;
+}
+
+/**
+ * Compare batched time histories of all locations with the time histories of
+ * each location on its own for a fixed seed
+ * @param[in] name Name of test case
+ * @param[in] heights Heights of grid
+ * @param[in] x_locations x locations of grid
+ * @param[in] y_locations y locations of grid
+ * @param[in] units Indicates that time histories should be returned in ft/s
+ * @return Returns true if batched and single location results agree
+ */
+bool check_batch(const std::string& name, const std::vector<double>& heights,
+                 const std::vector<double>& x_locations,
+                 const std::vector<double>& y_locations, bool units) {
+  stochastic::WittigSinha model("B", 100.0, heights, x_locations, y_locations,
+                                60.0, 100);
+  Eigen::MatrixXcd random_numbers = model.complex_random_numbers();
+  Eigen::MatrixXd batch = model.gen_location_hists(random_numbers, units);
+
+  if (batch.cols() != model.num_locations()) {
+    std::cout << name << " FAILED: " << batch.cols() << " time histories for "
+              << model.num_locations() << " locations" << std::endl;
+    return false;
+  }
+
+  double max_error = 0.0;
+  for (unsigned int i = 0; i < model.num_locations(); ++i) {
+    std::vector<double> single = location_hist(random_numbers, i, units);
+    if (static_cast<long>(single.size()) != batch.rows()) {
+      std::cout << name << " FAILED: location " << i << " has "
+                << batch.rows() << " steps instead of " << single.size()
+                << std::endl;
+      return false;
+    }
+
+    double peak = 0.0, error = 0.0;
+    for (unsigned int n = 0; n < single.size(); ++n) {
+      peak = std::max(peak, std::abs(single[n]));
+      error = std::max(error, std::abs(batch(n, i) - single[n]));
+    }
+    // NaN errors fail the comparison below
+    max_error = std::max(max_error, peak > 0.0 ? error / peak : error);
+    if (!(error <= TOLERANCE * std::max(peak, 1.0))) {
+      std::cout << name << " FAILED: location " << i << " differs by " << error
+                << std::endl;
+      return false;
+    }
+  }
+
+  std::cout << name << " passed, max relative difference " << max_error
+            << std::endl;
+  return true;
+}
+
+/**
+ * Check the cross-spectral density of a grid against the cross-spectral
+ * density of a single vertical line with the same heights
+ * @param[in] frequency Frequency at which to compare cross-spectral densities
+ * @return Returns true if cross-spectral density of grid is consistent
+ */
+bool check_cross_spectral_density(double frequency) {
+  std::vector<double> heights{10.0, 25.0, 40.0};
+  stochastic::WittigSinha grid("B", 100.0, heights, {0.0, 5.0, 12.0},
+                               {0.0, 4.0}, 60.0, 100);
+  stochastic::WittigSinha line("B", 100.0, heights, {1.0}, {1.0}, 60.0, 100);
+
+  std::string name =
+      "cross-spectral density at " + std::to_string(frequency) + " Hz";
+  Eigen::MatrixXd grid_density = grid.cross_spectral_density(frequency);
+  Eigen::MatrixXd line_density = line.cross_spectral_density(frequency);
+
+  if ((grid_density - grid_density.transpose()).cwiseAbs().maxCoeff() != 0.0) {
+    std::cout << name << " FAILED: grid matrix is not symmetric" << std::endl;
+    return false;
+  }
+  if (grid_density.llt().info() != Eigen::Success) {
+    std::cout << name << " FAILED: grid matrix is not positive definite"
+              << std::endl;
+    return false;
+  }
+
+  // Locations are ordered by x location, then y location, then height, so
+  // each vertical line is a diagonal block
+  unsigned int num_heights = heights.size();
+  for (unsigned int i = 0; i < grid.num_locations(); i += num_heights) {
+    Eigen::MatrixXd block =
+        grid_density.block(i, i, num_heights, num_heights);
+    double error = (block - line_density).cwiseAbs().maxCoeff();
+    if (!(error <= TOLERANCE * line_density.cwiseAbs().maxCoeff())) {
+      std::cout << name << " FAILED: vertical line at location " << i
+                << " differs by " << error << std::endl;
+      return false;
+    }
+  }
+
+  std::cout << name << " passed" << std::endl;
+  return true;
+}
+}  // namespace
+
+int main() {
+  config::initialize();
+
+  int failures = 0;
+  // Single vertical line, as used for floor loads, and grids in units of m/s
+  // and ft/s
+  failures += !check_batch("vertical line", {10.0, 20.0, 30.0, 40.0}, {1.0},
+                           {1.0}, false);
+  failures += !check_batch("3 x 2 x 3 grid", {10.0, 25.0, 40.0},
+                           {0.0, 5.0, 12.0}, {0.0, 4.0}, false);
+  failures += !check_batch("3 x 2 x 3 grid in ft/s", {10.0, 25.0, 40.0},
+                           {0.0, 5.0, 12.0}, {0.0, 4.0}, true);
+  failures += !check_cross_spectral_density(0.0);
+  failures += !check_cross_spectral_density(0.5);
+  failures += !check_cross_spectral_density(4.9);
+
+  return failures;
+}
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <cmath>
 #include <ctime>
+#include <fstream>
 #include <memory>
 #include <numeric>
 #include <stdexcept>
@@ -17,6 +18,7 @@
 #include "factory.h"
 #include "function_dispatcher.h"
 #include "json_object.h"
+#include "json_stream_writer.h"
 #include "lognormal_dist.h"
 #include "normal_dist.h"
 #include "normal_multivar.h"
@@ -421,29 +423,14 @@ utilities::JsonObject stochastic::VlachosEtAl::generate(
   auto events = utilities::JsonObject();
   std::vector<utilities::JsonObject> events_array(num_spectra_ * num_sims_);
 
-  // Add pattern information for JSON
-  auto pattern_x = utilities::JsonObject();
-  auto pattern_y = utilities::JsonObject();  
-  pattern_x.add_value("type", "UniformAcceleration");
-  pattern_x.add_value("timeSeries", "accel_x");
-  pattern_x.add_value("dof", 1);
-  pattern_y.add_value("type", "UniformAcceleration");
-  pattern_y.add_value("timeSeries", "accel_y");
-  pattern_y.add_value("dof", 2);
-
-  // Create JSON for specific event
-  auto event_data = utilities::JsonObject();
   // Loop over spectra
   for (unsigned int i = 0; i < num_spectra_; ++i) {
     // Loop over different simulations for current spectra
     for (unsigned int j = 0; j < num_sims_; ++j) {
-      event_data.add_value("name", event_name + "_Spectra" + std::to_string(i) +
-                                       "_Sim" + std::to_string(j));
-      event_data.add_value("type", "Seismic");
-      event_data.add_value("dT", time_step_);
-      event_data.add_value("numSteps", acceleration_pool[i][j].size());
-      event_data.add_value(
-          "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
+      auto event_data = seismic_event_fields(
+          event_name + "_Spectra" + std::to_string(i) + "_Sim" +
+              std::to_string(j),
+          time_step_, acceleration_pool[i][j].size());
 
       // Rotate accelerations, if necessary      
       std::vector<double> x_accels(acceleration_pool[i][j].size());
@@ -451,24 +438,17 @@ utilities::JsonObject stochastic::VlachosEtAl::generate(
       rotate_acceleration(acceleration_pool[i][j], x_accels, y_accels, units);
 
       // Add time histories for x and y directions to event
-      auto time_history_x = utilities::JsonObject();
-      auto time_history_y = utilities::JsonObject();
-      time_history_x.add_value("name", "accel_x");
-      time_history_x.add_value("type", "Value");
-      time_history_x.add_value("dT", time_step_);
-      time_history_x.add_value("data", x_accels);
-      time_history_y.add_value("name", "accel_y");
-      time_history_y.add_value("type", "Value");
-      time_history_y.add_value("dT", time_step_);
-      time_history_y.add_value("data", y_accels);
-      event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
-                                             time_history_x, time_history_y});
-      events_array[i * num_sims_ + j] = event_data;	
-      event_data.clear();
+      std::vector<utilities::JsonObject> time_histories{
+          time_series_fields("accel_x", time_step_),
+          time_series_fields("accel_y", time_step_)};
+      time_histories[0].add_value("data", x_accels);
+      time_histories[1].add_value("data", y_accels);
+      event_data.add_value("timeSeries", std::move(time_histories));
+      events_array[i * num_sims_ + j] = std::move(event_data);
     }
   }
 
-  events.add_value("Events", events_array);
+  events.add_value("Events", std::move(events_array));
 
   return events;
 }
@@ -478,10 +458,66 @@ bool stochastic::VlachosEtAl::generate(const std::string& event_name,
                                        bool units) {
   bool status = true;
   
-  // Generate pool of acceleration time histories
-  try{
-    auto json_output = generate(event_name, units);
-    json_output.write_to_file(output_location);
+  // Generate pool of acceleration time histories and write them directly
+  // to file without building the complete JSON object
+  try {
+    std::vector<std::vector<std::vector<double>>> acceleration_pool(
+        num_spectra_,
+        std::vector<std::vector<double>>(num_sims_, std::vector<double>()));
+
+    for (unsigned int i = 0; i < num_spectra_; ++i) {
+      time_history_family(acceleration_pool[i], physical_parameters_.row(i));
+    }
+
+    std::ofstream output_file(output_location);
+    if (!output_file.is_open()) {
+      throw std::runtime_error(
+          "\nERROR: In stochastic::VlachosEtAl::generate: Could not open "
+          "output location\n");
+    }
+
+    utilities::JsonStreamWriter writer(output_file);
+    writer.start_object();
+    writer.start_array("Events");
+
+    for (unsigned int i = 0; i < num_spectra_; ++i) {
+      for (unsigned int j = 0; j < num_sims_; ++j) {
+        writer.start_object();
+        writer.add_fields(seismic_event_fields(
+            event_name + "_Spectra" + std::to_string(i) + "_Sim" +
+                std::to_string(j),
+            time_step_, acceleration_pool[i][j].size()));
+
+        // Rotate accelerations, if necessary
+        std::vector<double> x_accels(acceleration_pool[i][j].size());
+        std::vector<double> y_accels(acceleration_pool[i][j].size());
+        rotate_acceleration(acceleration_pool[i][j], x_accels, y_accels, units);
+
+        // Write time histories for x and y directions
+        writer.start_array("timeSeries");
+        writer.start_object();
+        writer.add_fields(time_series_fields("accel_x", time_step_));
+        writer.add_array("data", x_accels.data(), x_accels.size());
+        writer.end_object();
+        writer.start_object();
+        writer.add_fields(time_series_fields("accel_y", time_step_));
+        writer.add_array("data", y_accels.data(), y_accels.size());
+        writer.end_object();
+        writer.end_array();
+        writer.end_object();
+      }
+    }
+
+    writer.end_array();
+    writer.end_object();
+    output_file << std::endl;
+    output_file.close();
+
+    if (output_file.fail()) {
+      throw std::runtime_error(
+          "\nERROR: In stochastic::VlachosEtAl::generate: Error when "
+          "closing output location\n");
+    }
   } catch (const std::exception& e) {
     std::cerr << e.what();
     status = false;
@@ -98,8 +98,9 @@ class VlachosEtAl : public StochasticModel {
 
   /**
    * Generate ground motion time histories based on input parameters
-   * and write results to file in JSON format. Throws exception if
-   * errors are encountered during time history generation.
+   * and write results to file in JSON format. Time histories are streamed
+   * to file without building the complete JSON object first. Throws
+   * exception if errors are encountered during time history generation.
    * @param[in] event_name Name to assign to event
    * @param[in, out] output_location Location to write outputs to
    * @param[in] units Indicates that time histories should be returned in
@@ -1,6 +1,7 @@
 #include <cmath>
 #include <complex>
 #include <ctime>
+#include <fstream>
 #include <string>
 // Boost random generator
 #include <boost/random/mersenne_twister.hpp>
@@ -11,6 +12,7 @@
 
 #include "function_dispatcher.h"
 #include "json_object.h"
+#include "json_stream_writer.h"
 #include "numeric_utils.h"
 #include "wittig_sinha.h"
 
@@ -116,29 +118,19 @@ stochastic::WittigSinha::WittigSinha(std::string exposure_category,
   seed_value_ = seed_value;
 }
 
-utilities::JsonObject stochastic::WittigSinha::generate(const std::string& event_name, bool units) {
-  // Initialize wind velocity vectors
-  std::vector<std::vector<std::vector<std::vector<double>>>> wind_vels(
-      local_x_.size(),
-      std::vector<std::vector<std::vector<double>>>(
-          local_y_.size(),
-          std::vector<std::vector<double>>(
-              heights_.size(), std::vector<double>(num_times_, 0.0))));
+utilities::JsonObject stochastic::WittigSinha::generate(
+    const std::string& /*event_name*/, bool units) {
+  // Wind velocity time histories for all locations, stored contiguously with
+  // one column per location
+  Eigen::MatrixXd wind_vels =
+      Eigen::MatrixXd::Zero(num_times_, num_locations());
 
-  Eigen::MatrixXcd complex_random_vals(num_freqs_, heights_.size());
-  
-  // Loop over heights to find time histories
+  // Generate correlated time histories at all locations at once
   try {
-    for (unsigned int i = 0; i < local_x_.size(); ++i) {
-      for (unsigned int j = 0; j < local_y_.size(); ++j) {
-        // Generate complex random numbers to use for calculation of discrete
-        // time series
-        complex_random_vals = complex_random_numbers();
-        for (unsigned int k = 0; k < heights_.size(); ++k) {
-          wind_vels[i][j][k] = gen_location_hist(complex_random_vals, k, units);
-        }
-      }
-    }
+    // Generate complex random numbers to use for calculation of discrete
+    // time series
+    Eigen::MatrixXcd complex_random_vals = complex_random_numbers();
+    wind_vels = gen_location_hists(complex_random_vals, units);
   } catch (const std::exception& e) {
     std::cerr << "\nERROR: In stochastic::WittigSinha::generate: "
               << e.what() << std::endl;
@@ -148,57 +140,67 @@ utilities::JsonObject stochastic::WittigSinha::generate(const std::string& event
   auto event = utilities::JsonObject();
   event.add_value("dT", time_step_);
   event.add_value("numSteps", num_times_);
-  
-  // Consider case when only looking at floor loads, so only have time histories as
-  // one location along the z-axis
-  if (local_x_.size() == 1 && local_y_.size() == 1) {
-    // Arrays of patterns and time histories for each floor
-    std::vector<utilities::JsonObject> pattern_array(heights_.size());
-    std::vector<utilities::JsonObject> event_array(1);
-    std::vector<utilities::JsonObject> time_history_array(heights_.size());
-    auto time_history = utilities::JsonObject();
-    event_array[0].add_value("type", "Wind");
-    event_array[0].add_value("subtype", model_name_);
 
-    for (unsigned int i = 0; i < heights_.size(); ++i) {
-      // Create pattern
-      pattern_array[i].add_value("name", std::to_string(i + 1));
-      pattern_array[i].add_value("timeSeries", std::to_string(i + 1));
-      pattern_array[i].add_value("type", "WindFloorLoad");
-      pattern_array[i].add_value("floor", std::to_string(i + 1));
-      pattern_array[i].add_value("dof", 1);
-      pattern_array[i].add_value("profileVelocity", wind_velocities_[i]);
-      
-      // Create time histories
-      time_history.add_value("name", std::to_string(i + 1));
-      time_history.add_value("dT", time_step_);
-      time_history.add_value("type", "Value");
-      time_history.add_value("data", wind_vels[0][0][i]);
-      time_history_array[i] = time_history;
-      time_history.clear();
-    }
-    
-    event_array[0].add_value("timeSeries", time_history_array);
-    event_array[0].add_value("pattern", pattern_array);
-    event.add_value("Events", event_array);   
-  } else {
-    throw std::runtime_error(
-        "ERROR: In stochastic::WittigSinha::generate: Currently, only supports "
-        "time histories along z-axis at single location\n");
+  std::vector<utilities::JsonObject> event_array{event_fields()};
+  std::vector<utilities::JsonObject> time_history_array(num_locations());
+
+  // Create time histories for each location
+  for (unsigned int i = 0; i < num_locations(); ++i) {
+    time_history_array[i] = time_series_fields(std::to_string(i + 1), time_step_);
+    time_history_array[i].add_array("data", wind_vels.col(i).data(),
+                                    num_times_);
   }
 
+  event_array[0].add_value("timeSeries", std::move(time_history_array));
+  event.add_value("Events", std::move(event_array));
+
   return event;
 }
 
-bool stochastic::WittigSinha::generate(const std::string& event_name,
+bool stochastic::WittigSinha::generate(const std::string& /*event_name*/,
                                        const std::string& output_location,
                                        bool units) {
 
   bool status = true;
-  // Generate time histories at specified locations
+  // Generate time histories at specified locations and write them directly
+  // to file without building the complete JSON object
   try {
-    auto json_output = generate(event_name, units);
-    json_output.write_to_file(output_location);
+    Eigen::MatrixXd wind_vels =
+        gen_location_hists(complex_random_numbers(), units);
+
+    std::ofstream output_file(output_location);
+    if (!output_file.is_open()) {
+      throw std::runtime_error(
+          "\nERROR: In stochastic::WittigSinha::generate: Could not open "
+          "output location\n");
+    }
+
+    utilities::JsonStreamWriter writer(output_file);
+    writer.start_object();
+    writer.add_value("dT", time_step_);
+    writer.add_value("numSteps", num_times_);
+    writer.start_array("Events");
+    writer.start_object();
+    writer.add_fields(event_fields());
+    writer.start_array("timeSeries");
+    for (unsigned int i = 0; i < num_locations(); ++i) {
+      writer.start_object();
+      writer.add_fields(time_series_fields(std::to_string(i + 1), time_step_));
+      writer.add_array("data", wind_vels.col(i).data(), num_times_);
+      writer.end_object();
+    }
+    writer.end_array();
+    writer.end_object();
+    writer.end_array();
+    writer.end_object();
+    output_file << std::endl;
+    output_file.close();
+
+    if (output_file.fail()) {
+      throw std::runtime_error(
+          "\nERROR: In stochastic::WittigSinha::generate: Error when closing "
+          "output location\n");
+    }
   } catch (const std::exception& e) {
     std::cerr << e.what();
     status = false;
@@ -209,27 +211,54 @@ bool stochastic::WittigSinha::generate(const std::string& event_name,
 }
 
 Eigen::MatrixXd stochastic::WittigSinha::cross_spectral_density(double frequency) const {
-  // Coefficient for coherence function
+  // Coefficients for coherence function for vertical and horizontal
+  // separations (Simiu & Scanlan, 1996)
   double coherence_coeff = 10.0;
+  double horizontal_coherence_coeff = 16.0;
+  unsigned int num_heights = heights_.size();
+  unsigned int num_points = num_locations();
   Eigen::MatrixXd cross_spectral_density =
-      Eigen::MatrixXd::Zero(heights_.size(), heights_.size());
-  
+      Eigen::MatrixXd::Zero(num_points, num_points);
+
+  // Spectral density only depends on height, so is the same at all locations
+  // with the same height
   for (unsigned int i = 0; i < cross_spectral_density.rows(); ++i) {
+    unsigned int k = i % num_heights;
     cross_spectral_density(i, i) =
-        200.0 * friction_velocity_ * friction_velocity_ * heights_[i] /
-        (wind_velocities_[i] *
-         std::pow(1.0 + 50.0 * frequency * heights_[i] / wind_velocities_[i],
+        200.0 * friction_velocity_ * friction_velocity_ * heights_[k] /
+        (wind_velocities_[k] *
+         std::pow(1.0 + 50.0 * frequency * heights_[k] / wind_velocities_[k],
                   5.0 / 3.0));
   }
 
   for (unsigned int i = 0; i < cross_spectral_density.rows(); ++i) {
+    unsigned int k_i = i % num_heights;
+    unsigned int xy_i = i / num_heights;
+    double x_i = local_x_[xy_i / local_y_.size()];
+    double y_i = local_y_[xy_i % local_y_.size()];
+
     for (unsigned int j = i + 1; j < cross_spectral_density.cols(); ++j) {
+      unsigned int k_j = j % num_heights;
+      unsigned int xy_j = j / num_heights;
+      double delta_x = x_i - local_x_[xy_j / local_y_.size()];
+      double delta_y = y_i - local_y_[xy_j % local_y_.size()];
+
+      // Separation scaled to be equivalent to a vertical separation, so that
+      // locations along a single vertical line give the vertical coherence
+      double separation = std::abs(heights_[k_i] - heights_[k_j]);
+      if (delta_x != 0.0 || delta_y != 0.0) {
+        double horizontal_ratio = horizontal_coherence_coeff / coherence_coeff;
+        separation = std::sqrt(
+            separation * separation +
+            horizontal_ratio * horizontal_ratio *
+                (delta_x * delta_x + delta_y * delta_y));
+      }
+
       cross_spectral_density(i, j) =
           std::sqrt(cross_spectral_density(i, i) *
                     cross_spectral_density(j, j)) *
-          std::exp(-coherence_coeff * frequency *
-                   std::abs(heights_[i] - heights_[j]) /
-                   (0.5 * (wind_velocities_[i] + wind_velocities_[j]))) *
+          std::exp(-coherence_coeff * frequency * separation /
+                   (0.5 * (wind_velocities_[k_i] + wind_velocities_[k_j]))) *
           0.999;
     }
   }
@@ -257,7 +286,7 @@ Eigen::MatrixXcd stochastic::WittigSinha::complex_random_numbers() const {
       distribution_gen(generator, distribution);
 
   // Generate white noise consisting of complex numbers
-  Eigen::MatrixXcd white_noise(heights_.size(), num_freqs_);
+  Eigen::MatrixXcd white_noise(num_locations(), num_freqs_);
 
   for (unsigned int i = 0; i < white_noise.rows(); ++i) {
     for (unsigned int j = 0; j < white_noise.cols(); ++j) {
@@ -269,12 +298,16 @@ Eigen::MatrixXcd stochastic::WittigSinha::complex_random_numbers() const {
 
   // Iterator over all frequencies and generate complex random numbers
   // for discrete time series simulation
-  Eigen::MatrixXd cross_spec_density_matrix(heights_.size(), heights_.size());
-  Eigen::MatrixXcd complex_random(num_freqs_, heights_.size());
+  // Frequencies are independent of each other, so they are distributed over
+  // the available threads
+  Eigen::MatrixXcd complex_random(num_freqs_, num_locations());
+  const int num_frequencies = static_cast<int>(frequencies_.size());
 
-  for (unsigned int i = 0; i < frequencies_.size(); ++i) {
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < num_frequencies; ++i) {
     // Calculate cross-spectral density matrix for current frequency
-    cross_spec_density_matrix = cross_spectral_density(frequencies_[i]);
+    Eigen::MatrixXd cross_spec_density_matrix =
+        cross_spectral_density(frequencies_[i]);
 
     // Find lower Cholesky factorization of cross-spectral density
     Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> lower_cholesky;
@@ -302,34 +335,77 @@ Eigen::MatrixXcd stochastic::WittigSinha::complex_random_numbers() const {
   return complex_random;
 }
 
-std::vector<double> stochastic::WittigSinha::gen_location_hist(
-    const Eigen::MatrixXcd& random_numbers, unsigned int column_index,
-    bool units) const {
+Eigen::MatrixXd stochastic::WittigSinha::gen_location_hists(
+    const Eigen::MatrixXcd& random_numbers, bool units) const {
 
-  // This following block implements what is expressed in Equations 7 & 8
-  Eigen::VectorXcd complex_full_range = Eigen::VectorXcd::Zero(2 * num_freqs_);
+  // This following block implements what is expressed in Equations 7 & 8 for
+  // all locations at once, with one column per location
+  Eigen::MatrixXcd complex_full_range =
+      Eigen::MatrixXcd::Zero(2 * num_freqs_, random_numbers.cols());
 
-  complex_full_range.segment(1, num_freqs_) =
-      random_numbers.block(0, column_index, num_freqs_, 1);
+  complex_full_range.block(1, 0, num_freqs_, random_numbers.cols()) =
+      random_numbers.topRows(num_freqs_);
 
-  complex_full_range.segment(num_freqs_ + 1, num_freqs_ - 1) =
-      random_numbers.block(0, column_index, num_freqs_ - 1, 1)
-          .reverse()
-          .conjugate();
- 
-  complex_full_range(num_freqs_) = std::abs(random_numbers(num_freqs_ - 1, column_index)); 
+  complex_full_range.block(num_freqs_ + 1, 0, num_freqs_ - 1,
+                           random_numbers.cols()) =
+      random_numbers.topRows(num_freqs_ - 1).colwise().reverse().conjugate();
 
-  // Calculate wind speed using real portion of inverse Fast Fourier Transform
-  // full range of random numbers
-  std::vector<double> node_time_history(complex_full_range.size());
-  numeric_utils::inverse_fft(complex_full_range, node_time_history);
+  complex_full_range.row(num_freqs_) =
+      random_numbers.row(num_freqs_ - 1).cwiseAbs().cast<std::complex<double>>();
+
+  // Calculate wind speeds using real portion of inverse Fast Fourier Transform
+  // of full range of random numbers, batched over all locations
+  Eigen::MatrixXd time_histories;
+  numeric_utils::inverse_fft(complex_full_range, time_histories);
 
   // Check if time histories need to be converted to ft/s
   if (units) {
-    for (auto & val : node_time_history) {
-      val = val * 3.28084;
+    time_histories *= 3.28084;
+  }
+
+  return time_histories;
+}
+
+std::vector<utilities::JsonObject> stochastic::WittigSinha::location_patterns()
+    const {
+  std::vector<utilities::JsonObject> pattern_array(num_locations());
+
+  // Consider case when only looking at floor loads, so only have time histories as
+  // one location along the z-axis
+  if (local_x_.size() == 1 && local_y_.size() == 1) {
+    for (unsigned int i = 0; i < heights_.size(); ++i) {
+      pattern_array[i].add_value("name", std::to_string(i + 1));
+      pattern_array[i].add_value("timeSeries", std::to_string(i + 1));
+      pattern_array[i].add_value("type", "WindFloorLoad");
+      pattern_array[i].add_value("floor", std::to_string(i + 1));
+      pattern_array[i].add_value("dof", 1);
+      pattern_array[i].add_value("profileVelocity", wind_velocities_[i]);
+    }
+  } else {
+    // Patterns for each point on the grid, ordered by x location, then y
+    // location, then height
+    for (unsigned int i = 0; i < num_locations(); ++i) {
+      unsigned int x_index = i / (local_y_.size() * heights_.size());
+      unsigned int y_index = (i / heights_.size()) % local_y_.size();
+      unsigned int z_index = i % heights_.size();
+
+      pattern_array[i].add_value("name", std::to_string(i + 1));
+      pattern_array[i].add_value("timeSeries", std::to_string(i + 1));
+      pattern_array[i].add_value("type", "WindVelocity");
+      pattern_array[i].add_value(
+          "location", std::vector<double>{local_x_[x_index], local_y_[y_index],
+                                          heights_[z_index]});
+      pattern_array[i].add_value("profileVelocity", wind_velocities_[z_index]);
     }
   }
-  
-  return node_time_history;
+
+  return pattern_array;
+}
+
+utilities::JsonObject stochastic::WittigSinha::event_fields() const {
+  utilities::JsonObject fields;
+  fields.add_value("type", "Wind");
+  fields.add_value("subtype", model_name_);
+  fields.add_value("pattern", location_patterns());
+  return fields;
 }
@@ -105,7 +105,7 @@ class WittigSinha : public StochasticModel {
   /**
    * Generate wind velocity time histories based on Wittig & Sinha (1975) model
    * with provided inputs and store outputs as JSON object
-   * @param[in] event_name Name to assign to event
+   * @param[in] event_name Unused, the wind event is not named
    * @param[in] units Indicates that time histories should be returned in
    *                  units of ft/s. Defaults to false where time histories
    *                  are returned in units of m/s
@@ -116,8 +116,10 @@ class WittigSinha : public StochasticModel {
 
   /**
    * Generate wind velocity time histories based on Wittig & Sinha (1975) model
-   * with provided inputs and write results to file in JSON format
-   * @param[in] event_name Name to assign to event
+   * with provided inputs and write results to file in JSON format. Time
+   * histories are streamed to file without building the complete JSON object
+   * first.
+   * @param[in] event_name Unused, the wind event is not named
    * @param[in, out] output_location Location to write outputs to
    * @param[in] units Indicates that time histories should be returned in
    *                  units of ft/s. Defaults to false where time histories
@@ -128,7 +130,8 @@ class WittigSinha : public StochasticModel {
                 const std::string& output_location, bool units = false) override;
 
   /**
-   * Calculate the cross-spectral density matrix 
+   * Calculate the cross-spectral density matrix
+   * between all locations
    * @param[in] frequency Frequency at which to calculate cross-spectral density
    * @return Matrix containing cross-spectral density functions
    */
@@ -142,20 +145,43 @@ class WittigSinha : public StochasticModel {
   Eigen::MatrixXcd complex_random_numbers() const;
 
   /**
-   * Generate velocity time histories at vertical location specified
+   * Generate velocity time histories at all locations using a single batch
+   * of inverse FFTs
    * @param[in] random_numbers Matrix of complex random numbers to use for
-   *                           velocity time history generation
-   * @param[in] column_index Index for column to use in input random numbers
-   *                         matrix
+   *                           velocity time history generation, with one
+   *                           column per location
    * @param[in] units Indicates that time histories should be returned in
    *                  units of ft/s. Otherwise time histories are returned
    *                  in units of m/s
-   * @return Vector containing velocity time history for vertical location
-   *         requested
+   * @return Matrix containing velocity time histories stored contiguously,
+   *         with one column per location
    */
-  std::vector<double> gen_location_hist(const Eigen::MatrixXcd& random_numbers,
-                                        unsigned int column_index,
-                                        bool units) const;
+  Eigen::MatrixXd gen_location_hists(const Eigen::MatrixXcd& random_numbers,
+                                     bool units) const;
+
+  /**
+   * Get the number of locations at which time histories are generated. Locations
+   * form a grid ordered by x location, then y location, then height.
+   * @return Number of locations
+   */
+  unsigned int num_locations() const {
+    return local_x_.size() * local_y_.size() * heights_.size();
+  }
+
+  /**
+   * Create load patterns for all locations. Floor load patterns are created
+   * when time histories are only generated along the height at a single
+   * location, otherwise velocity patterns with grid coordinates are created.
+   * @return Vector of JsonObjects containing load patterns
+   */
+  std::vector<utilities::JsonObject> location_patterns() const;
+
+  /**
+   * Get the fields of the wind event, excluding its time series. Shared by
+   * the JSON object and streaming outputs so both write the same layout.
+   * @return JsonObject containing event type, subtype and load patterns
+   */
+  utilities::JsonObject event_fields() const;
 
  private:
   std::string exposure_category_; /**< Exposure category for building based on ASCE-7 */
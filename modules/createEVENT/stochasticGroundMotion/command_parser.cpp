@@ -31,6 +31,10 @@ CommandParser::CommandParser(int& number_of_arguments, char* arguments[]) {
       clara::detail::Opt(configuration_.rv_flag)["-r"]["--getRV"](
           "Flag indicating whether the generated event file should specify "
           "random variable")
+          .optional() |
+      clara::detail::Opt(configuration_.output_format,
+                         "json|binary|binary32")["--outputFormat"](
+          "Format to write generated time histories in")
           .optional();
 
   auto result = command_parser_.parse(clara::detail::Args(number_of_arguments, arguments));
@@ -41,6 +45,14 @@ CommandParser::CommandParser(int& number_of_arguments, char* arguments[]) {
     throw std::invalid_argument("ERROR: In CommandParser::CommandParser: Command line inputs error");
   }
 
+  if (configuration_.output_format != "json" &&
+      configuration_.output_format != "binary" &&
+      configuration_.output_format != "binary32") {
+    throw std::invalid_argument(
+        "ERROR: In CommandParser::CommandParser: Output format must be one of "
+        "json, binary or binary32");
+  }
+
   // If help flag passed, print usage and exit
   if (configuration_.help) {
     std::cout << command_parser_ << std::endl;
@@ -94,6 +106,10 @@ bool CommandParser::get_rv_flag() const {
   return configuration_.rv_flag;
 }
 
+std::string CommandParser::get_output_format() const {
+  return configuration_.output_format;
+}
+
 CommandParser::Config CommandParser::get_configuration() const {
   return configuration_;
 }
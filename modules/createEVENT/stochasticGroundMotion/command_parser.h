@@ -36,6 +36,9 @@ class CommandParser {
                           option */
     bool rv_flag = false; /**< Flag indicating whether to generate event file
                              that specifies random variable */
+    std::string output_format =
+        "json"; /**< Format to write time histories in: json, binary or
+                   binary32 */
   };
 
   /**
@@ -81,6 +84,15 @@ class CommandParser {
    */
   bool get_rv_flag() const;
 
+  /**
+   * Get format that time histories should be written in. Time histories are
+   * written inline in the event file for "json", or to a compact binary
+   * container next to the event file in double ("binary") or single
+   * ("binary32") precision.
+   * @return Output format
+   */
+  std::string get_output_format() const;
+
   /**
    * Get the configuration structure generated from command line inputs
    * @return Struct containing configuration
@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <memory>
 #include <stdexcept>
+#include <binary_event.h>
 #include <configure.h>
 #include <nlohmann/json.hpp>
 #include "command_parser.h"
@@ -255,6 +256,20 @@ int main(int argc, char** argv) {
       }
     }
 
+    // Write time histories to binary container with JSON sidecar if requested
+    if (inputs.get_output_format() != "json") {
+      try {
+        utilities::write_binary_event(
+            std::move(event), inputs.get_event_file(),
+            inputs.get_output_format() == "binary32"
+                ? utilities::BinaryPrecision::Float32
+                : utilities::BinaryPrecision::Float64);
+      } catch (const std::exception& e) {
+        throwError("ERROR: In main() of StochasticGroundMotion: " + std::string(e.what()));
+      }
+      return 0;
+    }
+
     // Write prettyfied JSON to file
     std::ofstream event_file;
     event_file.open(inputs.get_event_file());
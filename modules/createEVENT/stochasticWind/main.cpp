@@ -5,6 +5,7 @@
 #include <stdexcept>
 #include <tuple>
 #include <common/Units.h>
+#include <binary_event.h>
 #include <configure.h>
 #include <nlohmann/json.hpp>
 #include "command_parser.h"
@@ -224,6 +225,22 @@ int main(int argc, char** argv) {
   json event;
   event.emplace("Events", events_array);
 
+  // Write time histories to binary container with JSON sidecar if requested
+  if (inputs.get_output_format() != "json") {
+    try {
+      utilities::write_binary_event(
+          std::move(event), inputs.get_event_file(),
+          inputs.get_output_format() == "binary32"
+              ? utilities::BinaryPrecision::Float32
+              : utilities::BinaryPrecision::Float64);
+    } catch (const std::exception& e) {
+      std::cerr << "ERROR: In main() of StochasticWindGenerator: " << e.what()
+                << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
   // Write prettyfied JSON to file
   std::ofstream event_file;
   event_file.open(inputs.get_event_file());
@@ -0,0 +1,182 @@
+"""Regression test of the wind tunnel load engine shared by the TPU-style apps.
+
+Every app is run on the same experiment data in an empty directory, once
+computing the tap weights, once reading them back from the weight cache
+written by the first run and once after the weights in the cache have been
+corrupted. All EVENT files have to reproduce the reference EVENT of the app
+in the expected folder value for value. The weight cache has to be written to
+a SimCenter directory in XDG_CACHE_HOME, or LOCALAPPDATA on Windows, that only
+the user can access, never
+to the working directory, and the corrupted cache has to be rewritten.
+
+Usage:
+    python runWindTunnelLoadsTest.py HighRiseTPU=<path to HighRiseTPU> ...
+"""  # noqa: INP001
+
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+test_dir = Path(__file__).resolve().parent
+
+# file each app reads the experiment data from
+tap_files = {
+    'HighRiseTPU': 'tmpSimCenterHighRiseTPU.json',
+    'LowRiseTPU': 'tmpSimCenterLowRiseTPU.json',
+    'NonIsolatedLowRiseTPU': 'tmpSimCenterNonIoslatedLowRiseTPU.json',
+    'WindTunnelExperiment': 'tapData.json',
+}
+
+
+def write_aim(app_name, aim_path):
+    """Write the AIM file of a 4 story building with an event of the app.
+
+    The faces are divided into the 10 x 10 cells per story the original apps
+    used, so the reference EVENT files can be generated with them.
+    """
+    aim = {
+        'GeneralInformation': {
+            'units': {'length': 'm'},
+            'height': 40.0,
+            'width': 10.0,
+            'depth': 8.0,
+            'stories': 4,
+        },
+        'Events': [
+            {
+                'type': app_name,
+                'windSpeed': 30.0,
+                'filename': 'tapData.json',
+                'numDivisionX': 10,
+                'numDivisionY': 10,
+            }
+        ],
+    }
+    with open(aim_path, 'w') as f:  # noqa: PTH123
+        json.dump(aim, f, indent=2)
+
+
+def compare(value, expected, path='EVENT'):
+    """Return a description of the first difference between two json values."""
+    if type(value) is not type(expected):
+        return f'{path}: {value!r} != {expected!r}'
+
+    if isinstance(value, dict):
+        if list(value.keys()) != list(expected.keys()):
+            return f'{path}: keys {list(value.keys())} != {list(expected.keys())}'
+        for key in value:
+            difference = compare(value[key], expected[key], f'{path}.{key}')
+            if difference:
+                return difference
+        return None
+
+    if isinstance(value, list):
+        if len(value) != len(expected):
+            return f'{path}: length {len(value)} != {len(expected)}'
+        for i, (item, expected_item) in enumerate(zip(value, expected)):
+            difference = compare(item, expected_item, f'{path}[{i}]')
+            if difference:
+                return difference
+        return None
+
+    if value != expected:
+        return f'{path}: {value!r} != {expected!r}'
+
+    return None
+
+
+def run_app(app_name, app_path, work_dir, cache_dir):
+    """Run an app three times and compare the EVENT files with the reference."""
+    shutil.copy(test_dir / 'tapData.json', work_dir / tap_files[app_name])
+    env = dict(os.environ, XDG_CACHE_HOME=str(cache_dir), LOCALAPPDATA=str(cache_dir))
+    weights_dir = cache_dir / 'SimCenter'
+    write_aim(app_name, work_dir / 'AIM.json')
+
+    with open(test_dir / 'expected' / f'{app_name}.EVENT.json') as f:  # noqa: PTH123
+        expected = json.load(f)
+
+    failures = []
+    cache_contents = None
+    for run in ('weights computed', 'weights cached', 'weights corrupted'):
+        cache_files = sorted(weights_dir.glob('*')) if weights_dir.is_dir() else []
+        if run == 'weights cached' and len(cache_files) == 1:
+            cache_contents = cache_files[0].read_bytes()
+        if run == 'weights corrupted' and cache_contents is not None:
+            # flip a bit of the last weight, which only the checksum detects
+            corrupted = bytearray(cache_contents)
+            corrupted[-1] ^= 1
+            cache_files[0].write_bytes(bytes(corrupted))
+
+        result = subprocess.run(  # noqa: S603
+            [
+                app_path,
+                '--filenameAIM',
+                'AIM.json',
+                '--filenameEVENT',
+                'EVENT.json',
+            ],
+            cwd=work_dir,
+            env=env,
+            capture_output=True,
+            text=True,
+            check=False,
+        )
+        if result.returncode != 0:
+            failures.append(f'{run}: exit code {result.returncode}\n{result.stderr}')
+            continue
+
+        with open(work_dir / 'EVENT.json') as f:  # noqa: PTH123
+            event = json.load(f)
+
+        difference = compare(event, expected)
+        if difference:
+            failures.append(f'{run}: {difference}')
+
+    stray_files = sorted(path.name for path in work_dir.glob('*Weights*'))
+    if stray_files:
+        failures.append(f'weight cache written to working directory: {stray_files}')
+    if not weights_dir.is_dir() or (os.name != 'nt' and weights_dir.stat().st_mode & 0o077):
+        failures.append(f'cache directory {weights_dir} missing or accessible by other users')
+        return failures
+    cache_files = sorted(weights_dir.iterdir())
+    if len(cache_files) != 1 or not cache_files[0].name.startswith(f'SimCenter{app_name}Weights'):
+        failures.append(f'expected one weight cache in cache directory: {[path.name for path in cache_files]}')
+    elif cache_files[0].read_bytes() != cache_contents:
+        failures.append('corrupted weight cache was not rewritten')
+
+    return failures
+
+
+def main(args):
+    """Run the apps given as name=path pairs, return the number of failures."""
+    if not args:
+        print(__doc__)  # noqa: T201
+        return 1
+
+    num_failed = 0
+    for arg in args:
+        app_name, app_path = arg.split('=', 1)
+        if app_name not in tap_files:
+            print(f'{app_name}: unknown app')  # noqa: T201
+            num_failed += 1
+            continue
+
+        with tempfile.TemporaryDirectory() as work_dir, tempfile.TemporaryDirectory() as cache_dir:
+            failures = run_app(app_name, app_path, Path(work_dir), Path(cache_dir))
+
+        if failures:
+            num_failed += 1
+            for failure in failures:
+                print(f'{app_name} FAILED {failure}')  # noqa: T201
+        else:
+            print(f'{app_name} passed')  # noqa: T201
+
+    return num_failed
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -12,6 +12,8 @@
 #include <regex>
 #include <cmath>
 
+#include "performUQ/templateSub/simCenterSubIndex.h"
+
 
 int getEDP(json_t *edp, std::vector<std::string> &edpList);
 int getRV(json_t *edp, std::vector<std::string> &rvList);
@@ -258,9 +260,15 @@ int main(int argc, const char **argv) {
   if (modelIndex > 0) {
     templateFileName = appendModelIndexToStem(modelIndex, templateFileName);
   }
-  std::ofstream templateFile(templateFileName);
+  // the offsets of the RV placeholders are recorded as the template is written, so that simCenterSub
+  // can substitute them without searching the template for every sample
+  std::ofstream templateFile(templateFileName, std::ios::binary);
+  std::vector<simCenterSubPlaceholder> placeholders;
   for(std::vector<std::string>::iterator itRV = rvList.begin(); itRV != rvList.end(); ++itRV) {
-    templateFile << "pset " << *itRV << " \"RV." << *itRV << "\"\n";
+    templateFile << "pset " << *itRV << " ";
+    std::string placeholder = "\"RV." + *itRV + "\"";
+    placeholders.push_back({(std::size_t)templateFile.tellp(), placeholder.length(), *itRV});
+    templateFile << placeholder << "\n";
   }
   
   templateFile << "\n set listQoI \"";
@@ -272,7 +280,8 @@ int main(int argc, const char **argv) {
 
   std::filesystem::path templateFilePath(templateFileName);
   std::string templateFileNameStem = templateFilePath.stem().string();
-  workflowDriverFile << dpreproCommand << " params.in " << templateFileName << " " << templateFileNameStem << ".tcl\n";
+  std::string templateIndexName = templateFileName + ".idx";
+  workflowDriverFile << dpreproCommand << " params.in " << templateFileName << " " << templateFileNameStem << ".tcl " << templateIndexName << "\n";
   bool suppressOutput = false;
   if (suppressOutput) {
       if (osType.compare("Windows") == 0) {
@@ -318,8 +327,13 @@ int main(int argc, const char **argv) {
     templateFile << " source " << postprocessScript << "\n";      
   }
   
+  std::size_t templateSize = templateFile.tellp();
   templateFile.close();
 
+  if (!writeSimCenterSubIndex(templateIndexName, templateSize, placeholders)) {
+    std::cerr << "createOpenSeesDriver:: could not write template index: " << templateIndexName << "\n";
+  }
+
   workflowDriverFile.close();
 
 
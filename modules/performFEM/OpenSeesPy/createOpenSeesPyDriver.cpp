@@ -16,6 +16,8 @@
 #include <exception>
 #include <csignal>
 
+#include "common/WorkflowStageTiming.h"
+
 
 int getEDP(json_t *edp, std::vector<std::string> &edpList);
 int getRV(json_t *edp, std::vector<std::string> &rvList);
@@ -314,34 +316,68 @@ int createDriver(int argc, const char **argv) {
       templateFile << line << std::endl; // Write line to template file
   }
   templateFile.close();
+
+  //
+  // the stages of a sample: substitution, solver and postprocessing, the output of the
+  // last stage goes to workflow.err
+  //
+
+  std::string substitutionCommand;
   if (strcmp(parametersScript.c_str(),"") == 0) {
 
     // workflowDriverFile << moveCommand << mainScript << " tmpSimCenter.script \n";
-    workflowDriverFile << dpreproCommand << "  params.in " << mainScriptTemplate << " " << mainScript << "\n";
+    substitutionCommand = dpreproCommand + "  params.in " + mainScriptTemplate + " " + mainScript;
   } else {
     // workflowDriverFile << moveCommand << parametersScript << " tmpSimCenter.params \n";
-    workflowDriverFile << dpreproCommand << "  params.in " << parametersScriptTemplate << " " << parametersScript << "\n";
+    substitutionCommand = dpreproCommand + "  params.in " + parametersScriptTemplate + " " + parametersScript;
   }
   
-  workflowDriverFile << pythonCommand << " " << mainScript; 
+  std::string solverCommand = pythonCommand + " " + mainScript;
+  std::string postprocessCommand;
   
   if (strcmp(postprocessScript,"") != 0) {
     if (strstr(postprocessScript,".py") != NULL) {
-      workflowDriverFile << "\n" << pythonCommand << " " << postprocessScript;
+      postprocessCommand = pythonCommand + " " + postprocessScript;
       for(std::vector<std::string>::iterator itEDP = edpList.begin(); itEDP != edpList.end(); ++itEDP) {
-        workflowDriverFile << " " << *itEDP;
+        postprocessCommand += " " + *itEDP;
       }
     }
     else if (strstr(postprocessScript,".tcl") != NULL) {
-      workflowDriverFile << "\n" << openSeesCommand << " " << postprocessScript;
+      postprocessCommand = openSeesCommand + " " + postprocessScript;
     }
   } else {
     for(std::vector<std::string>::iterator itEDP = edpList.begin(); itEDP != edpList.end(); ++itEDP) {
-      workflowDriverFile << " " << *itEDP;
+      solverCommand += " " + *itEDP;
     }
   }
 
-  workflowDriverFile << " 1> workflow.err 2>&1\n"; 
+  if (postprocessCommand.empty())
+    solverCommand += " 1> workflow.err 2>&1";
+  else
+    postprocessCommand += " 1> workflow.err 2>&1";
+
+  bool stageTiming = json_is_true(json_object_get(fem, "stageTiming"));
+  if (stageTiming && isWindows && isRunningLocal) {
+    std::cerr << "createOpenSeesPyDriver:: stageTiming not supported in a Windows batch driver\n";
+    stageTiming = false;
+  }
+
+  if (stageTiming)
+    workflowDriverFile << stageTimingFunctions;
+
+  workflowDriverFile << substitutionCommand << "\n";
+  if (stageTiming)
+    workflowDriverFile << "simCenterTime substitution\n";
+
+  workflowDriverFile << solverCommand << "\n";
+  if (stageTiming)
+    workflowDriverFile << "simCenterTime solver\n";
+
+  if (!postprocessCommand.empty()) {
+    workflowDriverFile << postprocessCommand << "\n";
+    if (stageTiming)
+      workflowDriverFile << "simCenterTime postprocess\n";
+  }
 
   workflowDriverFile.close();
   
@@ -10,6 +10,8 @@
 #include <filesystem>
 #include <algorithm>
 
+#include "common/WorkflowStageTiming.h"
+
 
 int getEDP(json_t *edp, std::vector<std::string> &edpList);
 int getRV(json_t *edp, std::vector<std::string> &rvList);
@@ -208,14 +210,28 @@ int main(int argc, const char **argv) {
   feapFile << "\n";
   feapFile.close();
   
+  bool stageTiming = json_is_true(json_object_get(fem, "stageTiming"));
+  if (stageTiming && (osType.compare("Windows") == 0) && (runType.compare("runningLocal") == 0)) {
+    std::cerr << "createFeapDriver:: stageTiming not supported in a Windows batch driver\n";
+    stageTiming = false;
+  }
+  
   // write driiver file
+  if (stageTiming)
+    workflowDriverFile << "#!/bin/bash\n" << stageTimingFunctions;
   workflowDriverFile << dpreproCommand << "  params.in " << mainInput  << " SimCenterIn.txt --formatFixed\n";
+  if (stageTiming)
+    workflowDriverFile << "simCenterTime substitution\n";
   workflowDriverFile << "echo y | " << feapCommand << "\n";
+  if (stageTiming)
+    workflowDriverFile << "simCenterTime solver\n";
   workflowDriverFile << pythonCommand << " " << postprocessScript;
   for(std::vector<std::string>::iterator itEDP = edpList.begin(); itEDP != edpList.end(); ++itEDP) {
     workflowDriverFile << " " << *itEDP;
   }
   workflowDriverFile << "\n";
+  if (stageTiming)
+    workflowDriverFile << "simCenterTime postprocess\n";
 
 
   workflowDriverFile.close();
@@ -0,0 +1,246 @@
+/*********************************************************************************
+**
+** Copyright (c) 2021 University of California, Berkeley
+** Copyright (c) 2021 Leland Stanford Junior University
+**
+** Redistribution and use in source and binary forms, with or without modification,
+** are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice, this
+** list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice, this
+** list of conditions and the following disclaimer in the documentation and/or other
+** materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors may
+** be used to endorse or promote products derived from this software without specific
+** prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+** EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+** SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+** TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+** BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+** CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+** IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+** SUCH DAMAGE.
+**
+***********************************************************************************/
+
+#include "BoundaryLayerKernel.h"
+#include <cmath>
+
+namespace
+{
+    // principal square root of re + i im, the branch taken by std::sqrt of a std::complex
+    inline void ComplexSqrt(double re, double im, double &out_re, double &out_im)
+    {
+        double m = sqrt(re * re + im * im);
+        if (m == 0.0)
+        {
+            out_re = 0.0;
+            out_im = im;
+        }
+        else if (re >= 0.0)
+        {
+            double t = sqrt(0.5 * (m + re));
+            out_re = t;
+            out_im = im / (2.0 * t);
+        }
+        else
+        {
+            double t = sqrt(0.5 * (m - re));
+            out_re = std::abs(im) / (2.0 * t);
+            out_im = std::copysign(t, im);
+        }
+    }
+
+    // (a_re + i a_im) / (b_re + i b_im)
+    inline void ComplexDivide(double a_re, double a_im, double b_re, double b_im, double &out_re, double &out_im)
+    {
+        double b2 = b_re * b_re + b_im * b_im;
+        out_re = (a_re * b_re + a_im * b_im) / b2;
+        out_im = (a_im * b_re - a_re * b_im) / b2;
+    }
+}
+
+
+BoundaryLayerKernel::BoundaryLayerKernel(const Eigen::ArrayXd &r, const Eigen::ArrayXd &theta, const Eigen::ArrayXd &zp,
+    double rho, double k_m)
+    : r(r), theta(theta), zp(zp), rho(rho), k_m(k_m)
+{
+    int num_points = int(r.size() * theta.size());
+    der_p = Eigen::ArrayXd::Zero(r.size());
+    der_p_2 = Eigen::ArrayXd::Zero(r.size());
+    sab = Eigen::ArrayXd::Zero(num_points);
+    p0 = sab;
+    p1_re = sab;
+    p1_im = sab;
+    pm_re = sab;
+    pm_im = sab;
+    a0_re = sab;
+    a0_im = sab;
+    a1_re = sab;
+    a1_im = sab;
+}
+
+
+void BoundaryLayerKernel::Compute(const Eigen::ArrayXd &z0, double del_p, double B, double c, double r_m, double f,
+    double beta, Eigen::MatrixXd &u, Eigen::MatrixXd &v, Eigen::MatrixXd &v_g1)
+{
+    int nr = int(r.size());
+    int nt = int(theta.size());
+    int nz = int(zp.size());
+    double ra = 180.0 / PI;
+
+    // Holland pressure gradient, it only depends on the radius so it is the same along every angle
+    double r_mB = pow(r_m, B);
+    for (int kk = 0; kk < nr; kk++)
+    {
+        double rB1 = pow(r(kk), -(B + 1.0));
+        der_p(kk) = B * r_mB * del_p * rB1 * exp(-pow(r_m / r(kk), B));
+        der_p_2(kk) = (-(B + 1.0) / r(kk) + B * r_mB * rB1) * der_p(kk);
+    }
+
+    double z10 = 10.0;
+    double A = 11.4;
+    double kappa = 0.40;
+    // exp(-i beta), with the heading taken in radians as the model always has
+    double eb_re = cos(-beta);
+    double eb_im = sin(-beta);
+
+    // Coefficients of each mesh point
+    for (int jj = 0; jj < nt; jj++)
+    {
+        double Ctheta = -c * sin((theta(jj) - beta) / ra);
+        double cos_theta = cos((theta(jj) - beta) / ra);
+
+        for (int kk = 0; kk < nr; kk++)
+        {
+            int n = jj * nr + kk;
+            double rk = r(kk);
+
+            // drag coefficient
+            double h = A * pow(z0(n), 0.86);
+            double d = 0.75 * h;
+            double log_z = log((z10 + h - d) / z0(n));
+            double Cd = kappa * kappa / (log_z * log_z);
+
+            // gradient wind and its derivatives
+            double half = 0.5 * (Ctheta - f * rk);
+            double Eta = sqrt(half * half + rk * der_p(kk) / rho);
+            double vg = half + Eta;
+            v_g1(jj, kk) = vg;
+            double der_v_g1_r = -0.5 * f + 0.5 / Eta * (-(Ctheta - f * rk) * f * 0.5
+                + der_p(kk) / rho + rk * der_p_2(kk) / rho);
+            double der_v_g1_theta = 0.25 * c * cos_theta * (-Ctheta + f * rk) / Eta - 0.5 * c * cos_theta;
+            double BB = der_v_g1_theta / (2.0 * k_m * rk);
+            double ALPHA = (f + 2.0 * vg / rk) / (2.0 * k_m);
+            double BETA = (f + vg / rk + der_v_g1_r) / (2.0 * k_m);
+            double GAMMA = vg / rk / (2.0 * k_m);
+
+            // PP_zero = XXX (1 + i)
+            double AB = ALPHA * BETA;
+            double XXX = -pow(AB, 0.25);
+            // sqrt(ALPHA BETA), imaginary when ALPHA BETA is negative
+            double sq_re = AB >= 0.0 ? sqrt(AB) : 0.0;
+            double sq_im = AB >= 0.0 ? 0.0 : sqrt(-AB);
+
+            // PP_one = -(1 + i) sqrt(GAMMA + sqrt(ALPHA BETA) - BB)
+            // PP_minus_one = -(1 + i) sqrt(-GAMMA + sqrt(ALPHA BETA) - BB)
+            double s_re, s_im;
+            ComplexSqrt(GAMMA + sq_re - BB, sq_im, s_re, s_im);
+            double p1r = -(s_re - s_im);
+            double p1i = -(s_re + s_im);
+            ComplexSqrt(-GAMMA + sq_re - BB, sq_im, s_re, s_im);
+            double pmr = -(s_re - s_im);
+            double pmi = -(s_re + s_im);
+
+            // D = PP_one - conj(PP_minus_one), and conj(PP_one) - PP_minus_one = conj(D), so the two
+            // terms c^2 Cd^2 / (4 k_m^2 conj(D)) - c^2 Cd^2 / (4 k_m^2 D) shared by X1 and X2 add up
+            // to the imaginary number i T_im
+            double D_re = p1r - pmr;
+            double D_im = p1i + pmi;
+            double T_im = 2.0 * c * c * Cd * Cd * D_im / (4.0 * k_m * k_m * (D_re * D_re + D_im * D_im));
+
+            // X1 = PP_zero + lin + i T_im, X2 = -conj(PP_zero) - lin + i T_im
+            double lin = (f / k_m) * rk * Cd - (2.0 / k_m) * Eta * Cd;
+            double X1_re = XXX + lin;
+            double X1_im = XXX + T_im;
+            double X2_re = -XXX - lin;
+            double X2_im = XXX + T_im;
+            double X3_im = -(2.0 / k_m) * Cd * (Eta - (f / 2.0) * rk) * (Eta - (f / 2.0) * rk);
+
+            // X4 = -(-PP_zero + s) / (-conj(PP_zero) + s)
+            double s = -(f / (2.0 * k_m)) * rk * Cd + (Eta / k_m) * Cd;
+            double X4_re, X4_im;
+            ComplexDivide(XXX - s, XXX, -XXX + s, XXX, X4_re, X4_im);
+
+            // A_zero = -X3 / (X1 + X2 X4)
+            double Y_re = X1_re + X2_re * X4_re - X2_im * X4_im;
+            double Y_im = X1_im + X2_re * X4_im + X2_im * X4_re;
+            double A0_re, A0_im;
+            ComplexDivide(0.0, -X3_im, Y_re, Y_im, A0_re, A0_im);
+
+            // A_one = i c Cd exp(-i beta) (A_zero + conj(A_zero)) / (4 k_m D)
+            double g = c * Cd * 2.0 * A0_re;
+            double A1_re, A1_im;
+            ComplexDivide(-g * eb_im, g * eb_re, 4.0 * k_m * D_re, 4.0 * k_m * D_im, A1_re, A1_im);
+
+            sab(n) = sqrt(ALPHA / BETA);
+            p0(n) = XXX;
+            p1_re(n) = p1r;
+            p1_im(n) = p1i;
+            pm_re(n) = pmr;
+            pm_im(n) = pmi;
+            a0_re(n) = A0_re;
+            a0_im(n) = A0_im;
+            a1_re(n) = A1_re;
+            a1_im(n) = A1_im;
+        }
+    }
+
+    // Wind at each height, as the sum of the three modes
+    // A_zero exp(PP_zero z) + A_one exp(PP_one z + i theta) + A_minus_one exp(PP_minus_one z - i theta)
+    // with A_minus_one = -conj(A_one)
+    for (int pp = 0; pp < nz; pp++)
+    {
+        double z = zp(pp);
+        double *u_z = u.col(pp).data();
+        double *v_z = v.col(pp).data();
+
+        for (int jj = 0; jj < nt; jj++)
+        {
+            double th = theta(jj) * (PI / 180.0);
+            for (int kk = 0; kk < nr; kk++)
+            {
+                int n = jj * nr + kk;
+
+                double e0 = exp(p0(n) * z);
+                double c0 = e0 * cos(p0(n) * z);
+                double s0 = e0 * sin(p0(n) * z);
+
+                double e1 = exp(p1_re(n) * z);
+                double c1 = e1 * cos(p1_im(n) * z + th);
+                double s1 = e1 * sin(p1_im(n) * z + th);
+
+                double em = exp(pm_re(n) * z);
+                double cm = em * cos(pm_im(n) * z - th);
+                double sm = em * sin(pm_im(n) * z - th);
+
+                double w_re = a0_re(n) * c0 - a0_im(n) * s0
+                    + a1_re(n) * c1 - a1_im(n) * s1
+                    - a1_re(n) * cm - a1_im(n) * sm;
+                double w_im = a0_re(n) * s0 + a0_im(n) * c0
+                    + a1_re(n) * s1 + a1_im(n) * c1
+                    - a1_re(n) * sm + a1_im(n) * cm;
+
+                u_z[n] = sab(n) * w_re;
+                v_z[n] = w_im;
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*********************************************************************************
+**
+** Copyright (c) 2021 University of California, Berkeley
+** Copyright (c) 2021 Leland Stanford Junior University
+**
+** Redistribution and use in source and binary forms, with or without modification,
+** are permitted provided that the following conditions are met:
+**
+** 1. Redistributions of source code must retain the above copyright notice, this
+** list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright notice, this
+** list of conditions and the following disclaimer in the documentation and/or other
+** materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its contributors may
+** be used to endorse or promote products derived from this software without specific
+** prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+** EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+** SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+** TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+** BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+** CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+** IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+** SUCH DAMAGE.
+**
+***********************************************************************************/
+
+// Boundary layer kernel of the height-resolving wind field model of
+// Snaiki and Wu (2017), see WindFieldModel.cpp for the references.
+
+#ifndef BOUNDARY_LAYER_KERNEL_H_
+#define BOUNDARY_LAYER_KERNEL_H_
+
+#include <Eigen/Dense>
+
+
+// The kernel evaluates the boundary layer wind over the whole polar mesh of a storm at once.
+// The complex coefficients of every mesh point are kept as separate real and imaginary arrays,
+// so the loops over the mesh run on contiguous doubles instead of std::complex values.
+class BoundaryLayerKernel
+{
+private:
+
+    const double PI = 3.14159265358979323846;
+
+    // polar mesh: radii in meter, angles in degree, and heights in meter
+    Eigen::ArrayXd r;
+    Eigen::ArrayXd theta;
+    Eigen::ArrayXd zp;
+    // air density and eddy viscosity
+    double rho;
+    double k_m;
+
+    // Holland pressure gradient and its derivative along the radius
+    Eigen::ArrayXd der_p;
+    Eigen::ArrayXd der_p_2;
+
+    // coefficients of each mesh point, theta by theta
+    // sab: sqrt(ALPHA / BETA)
+    // p0: real and imaginary part of PP_zero
+    // p1_re, p1_im, pm_re, pm_im: PP_one and PP_minus_one
+    // a0_re, a0_im, a1_re, a1_im: A_zero and A_one, A_minus_one being -conj(A_one)
+    Eigen::ArrayXd sab;
+    Eigen::ArrayXd p0;
+    Eigen::ArrayXd p1_re;
+    Eigen::ArrayXd p1_im;
+    Eigen::ArrayXd pm_re;
+    Eigen::ArrayXd pm_im;
+    Eigen::ArrayXd a0_re;
+    Eigen::ArrayXd a0_im;
+    Eigen::ArrayXd a1_re;
+    Eigen::ArrayXd a1_im;
+
+public:
+
+    BoundaryLayerKernel(const Eigen::ArrayXd &r, const Eigen::ArrayXd &theta, const Eigen::ArrayXd &zp,
+        double rho, double k_m);
+
+    // computing the wind at every mesh point and height for the storm at one track point
+    // z0: surface roughness of each mesh point, index jj * r.size() + kk for theta(jj) and r(kk)
+    // del_p: central pressure difference, B: Holland B parameter, c: translation speed,
+    // r_m: radius of the maximum wind, f: Coriolis parameter, beta: heading
+    // u, v: wind of each mesh point (rows) and height (columns)
+    // v_g1: gradient wind of each angle (rows) and radius (columns)
+    void Compute(const Eigen::ArrayXd &z0, double del_p, double B, double c, double r_m, double f,
+        double beta, Eigen::MatrixXd &u, Eigen::MatrixXd &v, Eigen::MatrixXd &v_g1);
+
+};
+
+#endif // BOUNDARY_LAYER_KERNEL_H_
@@ -50,13 +50,16 @@
 #include <math.h>
 #include <cmath>  // Needed for round()
 #include <algorithm>
-#include <complex>
+#include <cstdint>
 #include <iomanip>
+#include <random>
+#include <sstream>
 #include <string.h>
 #include <vector>
 #include <jansson.h>
 #include <Eigen/Dense>
 #include "WindFieldModel.h"
+#include "BoundaryLayerKernel.h"
 
 int WindFieldModel::ConfigSimu(std::string config_file, std::string stn_file, 
     std::string trk_file, std::string latw_file)
@@ -135,6 +138,11 @@ int WindFieldModel::ConfigSimu(std::string config_file, std::string stn_file,
     json_t *tmpDvA = json_object_get(mesh, "DivDeg");
     this->delta_p(4) = json_number_value(tmpDvA);
     this->delta_p(5) = 360.0;
+    // terrain index cell size in degrees (optional)
+    json_t *tmpDvT = json_object_get(mesh, "DivTerrain");
+    if (tmpDvT) {
+        this->terrain_div = json_number_value(tmpDvT);
+    }
     // wind speed measuring height
     json_t *tmpIM = json_object_get(evnt, "IntensityMeasure");
     json_t *tmpHgt = json_object_get(tmpIM, "MeasureHeight"); 
@@ -321,6 +329,22 @@ int WindFieldModel::PertubPath(std::string dpath_file)
     // \delta Radius
     this->dR = json_number_value(json_object_get(dpath_doc, "dR"));
 
+    // ensemble of perturbed tracks (optional)
+    // Number: number of members, Seed: seed of the random perturbations
+    // Perturbation: amplitudes of dLatitude, dLongitude, dAngle, dP, dV and dR, the members are
+    // spread around the track perturbed by the values above
+    json_t *ens = json_object_get(dpath_doc, "Ensemble");
+    if (ens) {
+        this->num_ensemble = int(json_integer_value(json_object_get(ens, "Number")));
+        this->ensemble_seed = (unsigned long long)json_integer_value(json_object_get(ens, "Seed"));
+        json_t *amp = json_object_get(ens, "Perturbation");
+        this->ensemble_amp = Eigen::ArrayXd::Zero(6);
+        for (int i = 0; i < 6 && i < int(json_array_size(amp)); i++)
+        {
+            this->ensemble_amp(i) = json_number_value(json_array_get(amp, i));
+        }
+    }
+
     return 0;
 }
 
@@ -366,37 +390,245 @@ int WindFieldModel::DefineTern(std::string refz0_file)
         }
     }
 
+    // indexing the polygons for the z0 lookups
+    this->IndexTern();
+
     return 0;
 }
 
 
+void WindFieldModel::IndexTern()
+{
+    // Bounding boxes of the regions, padded so the round-off in the polygon test can not put a
+    // point just outside a box inside its polygon
+    double pad = 1.0e-7;
+    double inf = std::numeric_limits<double>::infinity();
+    this->Wr_lat_min = Eigen::ArrayXd::Constant(this->num_region, inf);
+    this->Wr_lat_max = Eigen::ArrayXd::Constant(this->num_region, -inf);
+    this->Wr_long_min = this->Wr_lat_min;
+    this->Wr_long_max = this->Wr_lat_max;
+    for (int i = 0; i < this->num_region; i++)
+    {
+        int n = int(this->Wr_sizes(i));
+        if (n > 0)
+        {
+            this->Wr_lat_min(i) = this->Lat_wr.col(i).head(n).minCoeff() - pad;
+            this->Wr_lat_max(i) = this->Lat_wr.col(i).head(n).maxCoeff() + pad;
+            this->Wr_long_min(i) = this->Long_wr.col(i).head(n).minCoeff() - pad;
+            this->Wr_long_max(i) = this->Long_wr.col(i).head(n).maxCoeff() + pad;
+        }
+    }
+
+    this->grid_nlat = 0;
+    this->grid_nlong = 0;
+    this->grid_first.assign(1, 0);
+    this->grid_regions.clear();
+    if (this->num_region == 0 || !(this->Wr_lat_min.minCoeff() <= this->Wr_lat_max.maxCoeff()))
+    {
+        return;
+    }
+
+    // Grid over all boxes, with square cells of terrain_div degrees or about 64 cells per region,
+    // and at most max_cell cells
+    this->grid_lat0 = this->Wr_lat_min.minCoeff();
+    this->grid_lat1 = this->Wr_lat_max.maxCoeff();
+    this->grid_long0 = this->Wr_long_min.minCoeff();
+    this->grid_long1 = this->Wr_long_max.maxCoeff();
+    double span_lat = this->grid_lat1 - this->grid_lat0;
+    double span_long = this->grid_long1 - this->grid_long0;
+    const double max_cell = 4194304.0;
+    const double max_div = 4096.0;
+    double cell_size = this->terrain_div;
+    if (cell_size <= 0.0)
+    {
+        cell_size = sqrt(span_lat * span_long / (64.0 * this->num_region));
+    }
+    cell_size = std::max(cell_size, sqrt(span_lat * span_long / max_cell));
+    this->grid_nlat = int(std::min(std::ceil(span_lat / cell_size), max_div));
+    this->grid_nlong = int(std::min(std::ceil(span_long / cell_size), max_div));
+    this->grid_nlat = std::max(this->grid_nlat, 1);
+    this->grid_nlong = std::max(this->grid_nlong, 1);
+    this->grid_dlat = span_lat / this->grid_nlat;
+    this->grid_dlong = span_long / this->grid_nlong;
+
+    // Listing the regions of each cell in increasing order, by counting them first
+    int num_cell = this->grid_nlat * this->grid_nlong;
+    std::vector<int> cell_lat0(this->num_region), cell_lat1(this->num_region);
+    std::vector<int> cell_long0(this->num_region), cell_long1(this->num_region);
+    this->grid_first.assign(num_cell + 1, 0);
+    for (int i = 0; i < this->num_region; i++)
+    {
+        if (!(this->Wr_lat_min(i) <= this->Wr_lat_max(i)))
+        {
+            cell_lat0[i] = 0;
+            cell_lat1[i] = -1;
+            continue;
+        }
+        cell_lat0[i] = GridCell(this->Wr_lat_min(i), this->grid_lat0, this->grid_dlat, this->grid_nlat);
+        cell_lat1[i] = GridCell(this->Wr_lat_max(i), this->grid_lat0, this->grid_dlat, this->grid_nlat);
+        cell_long0[i] = GridCell(this->Wr_long_min(i), this->grid_long0, this->grid_dlong, this->grid_nlong);
+        cell_long1[i] = GridCell(this->Wr_long_max(i), this->grid_long0, this->grid_dlong, this->grid_nlong);
+        for (int a = cell_lat0[i]; a <= cell_lat1[i]; a++)
+        {
+            for (int b = cell_long0[i]; b <= cell_long1[i]; b++)
+            {
+                this->grid_first[a * this->grid_nlong + b + 1]++;
+            }
+        }
+    }
+    for (int k = 0; k < num_cell; k++)
+    {
+        this->grid_first[k + 1] += this->grid_first[k];
+    }
+    this->grid_regions.resize(this->grid_first[num_cell]);
+    std::vector<int> cell_next(this->grid_first.begin(), this->grid_first.end() - 1);
+    for (int i = 0; i < this->num_region; i++)
+    {
+        for (int a = cell_lat0[i]; a <= cell_lat1[i]; a++)
+        {
+            for (int b = cell_long0[i]; b <= cell_long1[i]; b++)
+            {
+                this->grid_regions[cell_next[a * this->grid_nlong + b]++] = i;
+            }
+        }
+    }
+
+    // Rasterizing z0: a cell that no polygon edge comes near is either inside or outside each of its
+    // regions as a whole, so its region is found once at its center and its points are not tested
+    // again. Cells with an edge are marked -2 and their points are tested against the regions
+    this->grid_cell_region.assign(num_cell, 0);
+    for (int i = 0; i < this->num_region; i++)
+    {
+        int n = int(this->Wr_sizes(i));
+        for (int j = 0; j < n; j++)
+        {
+            MarkEdgeCells(this->Lat_wr(j, i), this->Long_wr(j, i),
+                this->Lat_wr((j + 1) % n, i), this->Long_wr((j + 1) % n, i), pad);
+        }
+    }
+    int num_raster = 0;
+    for (int a = 0; a < this->grid_nlat; a++)
+    {
+        for (int b = 0; b < this->grid_nlong; b++)
+        {
+            int cell = a * this->grid_nlong + b;
+            if (this->grid_cell_region[cell] == 0)
+            {
+                this->grid_cell_region[cell] = FindRegionInCell(cell,
+                    this->grid_lat0 + (a + 0.5) * this->grid_dlat, this->grid_long0 + (b + 0.5) * this->grid_dlong);
+                num_raster++;
+            } else {
+                this->grid_cell_region[cell] = -2;
+            }
+        }
+    }
+
+    std::cout << "WindFieldSimulation: terrain indexed on a " << this->grid_nlat << " x " << this->grid_nlong << " grid, "
+        << num_raster << " cells rasterized." << std::endl;
+}
+
+
+void WindFieldModel::MarkEdgeCells(double x1, double y1, double x2, double y2, double pad)
+{
+    // Cells whose box, padded against round-off, the edge may cross are marked 1. The cells around
+    // the box of the edge are checked as well since the padded cell boxes overlap their neighbors
+    int a0 = std::max(GridCell(std::min(x1, x2), this->grid_lat0, this->grid_dlat, this->grid_nlat) - 1, 0);
+    int a1 = std::min(GridCell(std::max(x1, x2), this->grid_lat0, this->grid_dlat, this->grid_nlat) + 1, this->grid_nlat - 1);
+    int b0 = std::max(GridCell(std::min(y1, y2), this->grid_long0, this->grid_dlong, this->grid_nlong) - 1, 0);
+    int b1 = std::min(GridCell(std::max(y1, y2), this->grid_long0, this->grid_dlong, this->grid_nlong) + 1, this->grid_nlong - 1);
+    double ex = x2 - x1;
+    double ey = y2 - y1;
+    double len = sqrt(ex * ex + ey * ey);
+    for (int a = a0; a <= a1; a++)
+    {
+        double cx0 = this->grid_lat0 + a * this->grid_dlat - pad;
+        double cx1 = this->grid_lat0 + (a + 1) * this->grid_dlat + pad;
+        if (std::max(x1, x2) < cx0 || std::min(x1, x2) > cx1)
+            continue;
+        for (int b = b0; b <= b1; b++)
+        {
+            double cy0 = this->grid_long0 + b * this->grid_dlong - pad;
+            double cy1 = this->grid_long0 + (b + 1) * this->grid_dlong + pad;
+            if (std::max(y1, y2) < cy0 || std::min(y1, y2) > cy1)
+                continue;
+            // Short edges are taken to cross every cell their box overlaps, longer ones only when
+            // the corners of the cell are not all clearly on one side of the edge
+            bool cross = true;
+            if (len > 1.0e-3)
+            {
+                double d00 = (ex * (cy0 - y1) - ey * (cx0 - x1)) / len;
+                double d01 = (ex * (cy1 - y1) - ey * (cx0 - x1)) / len;
+                double d10 = (ex * (cy0 - y1) - ey * (cx1 - x1)) / len;
+                double d11 = (ex * (cy1 - y1) - ey * (cx1 - x1)) / len;
+                double dmin = std::min(std::min(d00, d01), std::min(d10, d11));
+                double dmax = std::max(std::max(d00, d01), std::max(d10, d11));
+                cross = !(dmin > 0.5 * pad || dmax < -0.5 * pad);
+            }
+            if (cross)
+                this->grid_cell_region[a * this->grid_nlong + b] = 1;
+        }
+    }
+}
+
+
+int WindFieldModel::FindRegion(double px, double py)
+{
+    // Points outside the grid (or nan) are not in any region
+    if (!(px >= this->grid_lat0 && px <= this->grid_lat1 && py >= this->grid_long0 && py <= this->grid_long1))
+    {
+        return -1;
+    }
+
+    int cell = GridCell(px, this->grid_lat0, this->grid_dlat, this->grid_nlat) * this->grid_nlong
+        + GridCell(py, this->grid_long0, this->grid_dlong, this->grid_nlong);
+    if (this->grid_cell_region[cell] != -2)
+    {
+        return this->grid_cell_region[cell];
+    }
+
+    return FindRegionInCell(cell, px, py);
+}
+
+
+int WindFieldModel::FindRegionInCell(int cell, double px, double py)
+{
+    // Only the regions whose box overlaps the cell of the point can contain it, they are tested in
+    // the same order as the regions so the first region containing the point is found
+    for (int k = this->grid_first[cell]; k < this->grid_first[cell + 1]; k++)
+    {
+        int oi = this->grid_regions[k];
+        if (px < this->Wr_lat_min(oi) || px > this->Wr_lat_max(oi) || py < this->Wr_long_min(oi) || py > this->Wr_long_max(oi))
+        {
+            continue;
+        }
+        if (inpolygon(this->Lat_wr.col(oi).data(), this->Long_wr.col(oi).data(), int(this->Wr_sizes(oi)), px, py) == 1)
+        {
+            return oi;
+        }
+    }
+
+    return -1;
+}
+
+
 int WindFieldModel::ComputeStationZ0(std::string dirOutput)
 {
     std::cout << "WindFieldSimulation: mapping station z0." << std::endl;
     // Calculating the surface roughness z0 for staitons
     // Mapping individual stations to the reference z0r values of polygons
     Eigen::ArrayXd z0_station = Eigen::ArrayXd::Zero(this->Lat_wout.size());
-    Eigen::ArrayXd PolyX = this->Lat_wr.block(0, int(this->Wr_sizes.size()) - 1, int(this->Wr_sizes(int(this->Wr_sizes.size()) - 1)), 1);
-    Eigen::ArrayXd PolyY = this->Long_wr.block(0, int(this->Wr_sizes.size()) - 1, int(this->Wr_sizes(int(this->Wr_sizes.size()) - 1)), 1);
     for (int ii = 0; ii < this->Lat_wout.size(); ii++)
     {
         double stationX = this->Lat_wout(ii);
         double stationY = this->Long_wout(ii);
-        //z0_station(ii) = 0.1;
-        int aux = 0;
-        int oi = 0;
-        while ((aux == 0) && (oi < this->Wr_sizes.size() - 1))
-        {
-            Eigen::ArrayXd PolyX = this->Lat_wr.block(0, oi, int(this->Wr_sizes(oi)), 1);
-            Eigen::ArrayXd PolyY = this->Long_wr.block(0, oi, int(this->Wr_sizes(oi)), 1);
-            aux = WindFieldModel::inpolygon(PolyX, PolyY, int(this->Wr_sizes(oi)), stationX, stationY);
-            oi++;
-        }
-
-        if (aux == 1)
+        int oi = FindRegion(stationX, stationY);
+        if (oi >= 0)
         {
             z0_station(ii) = this->z0r(oi);
-        }        
+        } else {
+            std::cout << "Warning: The provided z0 polygon does not cover the station #" << ii << " located at " << stationX << " and " << stationY << ". Default 0.01 used" << std::endl;
+            z0_station(ii) = 0.01;
+        }
     }
     // Writing out z0_station to a result file
     std::ofstream z0File(dirOutput + "/StationZ0.csv");
@@ -407,7 +639,40 @@ int WindFieldModel::ComputeStationZ0(std::string dirOutput)
 }
 
 
+Eigen::ArrayXd WindFieldModel::MeasureHeights()
+{
+    int size = 1 + int((this->delta_p(8) - this->delta_p(6)) / this->delta_p(7));
+    Eigen::ArrayXd zp = Eigen::ArrayXd::Zero(size);
+    for (int ii = 0; ii < size; ii++)
+    {
+        zp(ii) = this->delta_p(6) + ii * this->delta_p(7);
+    }
+
+    return zp;
+}
+
+
 int WindFieldModel::SimulateWind(std::string dirOutput)
+{
+    // Writing out zp to a result file
+    std::ofstream zpFile(dirOutput + "/MeasureHeight.csv");
+    zpFile << std::setprecision(4) << MeasureHeights() << "\n";
+    zpFile.close();
+
+    Eigen::MatrixXd u_max = SimulateTrack(this->del_par, this->dP, this->dV, this->dR, true);
+
+    // Writing out u_max to a result file
+    std::cout << "WindFieldSimulation: saving simulation results." << std::endl;
+    std::ofstream resultFile(dirOutput + "/MaxWindSpeed.csv");
+    const static Eigen::IOFormat CSVFormat(Eigen::StreamPrecision, Eigen::DontAlignCols, ", ", "\n");
+    resultFile << u_max.format(CSVFormat);
+    resultFile.close();
+
+    return 0;
+}
+
+
+Eigen::MatrixXd WindFieldModel::SimulateTrack(const Eigen::ArrayXd &dPar, double dPrs, double dSpd, double dRad, bool verbose)
 {
     // // central pressure difference
     // double del_p = (this->param(3) + this->dP) * 100.0;
@@ -428,16 +693,18 @@ int WindFieldModel::SimulateWind(std::string dirOutput)
     // ra 
     double ra = 180.0 / this->PI;
 
-    std::cout << "rho: " << rho << std::endl;
-    std::cout << "k_m: " << k_m << std::endl;
-    std::cout << "R: " << R << std::endl;
-    std::cout << "eps: " << eps << std::endl;
-    std::cout << "ra: " << ra << std::endl;
-
-    //rho = 1.2;
-    //k_m = 100;
-    std::cout << "rho: " << rho << std::endl;
-    std::cout << "k_m: " << k_m << std::endl;
+    if (verbose) {
+        std::cout << "rho: " << rho << std::endl;
+        std::cout << "k_m: " << k_m << std::endl;
+        std::cout << "R: " << R << std::endl;
+        std::cout << "eps: " << eps << std::endl;
+        std::cout << "ra: " << ra << std::endl;
+
+        //rho = 1.2;
+        //k_m = 100;
+        std::cout << "rho: " << rho << std::endl;
+        std::cout << "k_m: " << k_m << std::endl;
+    }
 
 
     // Calculating heading
@@ -446,7 +713,7 @@ int WindFieldModel::SimulateWind(std::string dirOutput)
     for (int ii = 0; ii < this->Lat_w.size() - 1; ii++)
     {
         double Delta = abs(this->Long_w(ii + 1)) - abs(this->Long_w(ii)) + eps * eps;
-        beta_c(ii) = -this->del_par(2) + 90 + ra * atan2(sin(Delta / ra) * cos((this->Lat_w(ii + 1)) / ra), 
+        beta_c(ii) = -dPar(2) + 90 + ra * atan2(sin(Delta / ra) * cos((this->Lat_w(ii + 1)) / ra), 
             cos((this->Lat_w(ii)) / ra) * sin((this->Lat_w(ii + 1)) / ra) - sin((this->Lat_w(ii)) / ra) 
             * cos((this->Lat_w(ii + 1)) / ra) * cos(Delta / ra));
 
@@ -473,319 +740,296 @@ int WindFieldModel::SimulateWind(std::string dirOutput)
     {
         theta(ii) = this->delta_p(3) + ii * this->delta_p(4);
     }
-    size = 1 + int((this->delta_p(8) - this->delta_p(6)) / this->delta_p(7));
-    Eigen::ArrayXd zp = Eigen::ArrayXd::Zero(size);
-    for (int ii = 0; ii < size; ii++)
-    {
-        zp(ii) = this->delta_p(6) + ii * this->delta_p(7);
-    }
-
-    // Writing out zp to a result file
-    std::ofstream zpFile(dirOutput + "/MeasureHeight.csv");
-    zpFile << std::setprecision(4) << zp << "\n";
-    zpFile.close();
+    Eigen::ArrayXd zp = MeasureHeights();
 
-    // Initialize matrices for later usage
-    Eigen::ArrayXd u_max_tmp = Eigen::ArrayXd::Zero(this->Lat_wout.size());
+    // Maximum wind speed of each station at each height over the whole storm path
     Eigen::MatrixXd u_max = Eigen::MatrixXd::Zero(this->Lat_wout.size(), zp.size());
-    Eigen::MatrixXd u_tmp = Eigen::MatrixXd::Zero(zp.size(), r.size());
-    Eigen::MatrixXd v_tmp = u_tmp;
-    Eigen::MatrixXd u = Eigen::MatrixXd::Zero(theta.size() * r.size(), zp.size());
-    Eigen::MatrixXd v = u;
-    Eigen::MatrixXd v_g1 = Eigen::MatrixXd::Zero(theta.size(), r.size());
-    Eigen::ArrayXd z0 = Eigen::ArrayXd::Zero(r.size());
-    Eigen::VectorXd Wind_speed = Eigen::VectorXd::Zero(this->Lat_wout.size());
-    Eigen::MatrixXd jvar2 = Eigen::MatrixXd::Zero(this->num_station, this->Lat_w.size());
-    Eigen::MatrixXd kvar2 = Eigen::MatrixXd::Zero(this->num_station, this->Lat_w.size());
-
-    // Perform the loop for different reference points
-    // i.e., different instance locations in the entire storm path
-
-    
 
     int disp_interval = std::max(floor(static_cast<double>(this->Lat_w.size()) / 10.0), 1.0);
-    std::cout << disp_interval << std::endl;
+    if (verbose) {
+        std::cout << disp_interval << std::endl;
+    }
 
-    bool disp_flag;
-    double Lat, Long;
-    for (int ii = 0; ii < this->Lat_w.size(); ii++)
+    // Perform the loop for different reference points
+    // i.e., different instance locations in the entire storm path
+    // The reference points are independent of each other, so they are run in parallel with each
+    // thread keeping the maximum wind speeds of its own points, and the maxima of the threads are
+    // combined at the end. Taking the maximum does not depend on the order of the points, so the
+    // results are the same for any number of threads
+    int num_track = int(this->Lat_w.size());
+#pragma omp parallel
     {
-
-        if (ii % disp_interval == 0) {
-            disp_flag = true;
-            std::cout << "WindFieldSimulation: computing wind speed field - storm track location #" << ii + 1 << "/" << this->Lat_w.size() << std::endl;
-        } else {
-            disp_flag = false;
-        }
-
-
-        // central pressure difference
-        double del_p = (this->P(ii) + this->dP) * 100.0;  // hPa into newton/square meter
-        // Holland B parameter
-        double B = 1.38 + 0.00184 * (del_p / 100.0) - 0.00309 * (this->Rad(ii) + this->dR);
-        // translation speed
-        double c = ((this->V(ii) + this->dV) * 1000.0) / 3600.0; // from km/h to m/s
-        // radius in meter
-        double r_m = (this->Rad(ii) + this->dR) * 1000.0; // from km to meter
-
-        if (disp_flag) {
-            std::cout << "del_p: " << del_p << " (N/m^2)" << std::endl;
-            std::cout << "B: " << B << std::endl;
-            std::cout << "c: " << c << std::endl;
-            std::cout << "r_m: " << r_m << std::endl;
-        }
-        // B = 1;
-        //del_p = 60*100;
-        //std::cout << "B: " << B << std::endl;
-        //std::cout << "del_p: " << del_p << std::endl;
-
-
-        // location and deading, including perturbation for MC case
-        Lat = this->Lat_w(ii); // + 0*del_par(0);
-        Long = abs(this->Long_w(ii)) - 0.3 * this->del_par(1);
-        double beta = beta_c(ii);
-        // double beta;
-
-        // if ((beta_c(ii)>= 0.0) && (beta_c(ii)<= 90.0))
-        //     beta = 90.0 - beta_c(ii);
-        // else
-        //     beta = 450.0 - beta_c(ii);
-
-        if (disp_flag) {
-            std::cout << "beta: " << beta << std::endl;
-        }   
-
-
-        // Coriolis
-        double omega = 0.00007292;
-        double f = 2.0 * omega * sin((Lat * this->PI) / 180.0);
-
-        Eigen::ArrayXd dd = acos(cos(this->Lat_wout / ra) * cos(Lat / ra) * cos((abs(this->Long_wout) - Long) / ra) 
-            + sin(this->Lat_wout / ra) * sin(Lat / ra));
-        double temp100 = 6371.0 * 180.0 / this->PI / ra * 1000.0;
-        dd = dd * temp100;
-        Eigen::ArrayXd Delta2 = abs(this->Long_wout) - Long + pow(eps, 2);
-
-        // Bearing angle in degrees
-        Eigen::ArrayXd bearing = Eigen::ArrayXd::Zero(this->Lat_wout.size());
-        Eigen::ArrayXd jvar = Eigen::ArrayXd::Zero(this->Lat_wout.size());
-        Eigen::ArrayXd kvar = Eigen::ArrayXd::Zero(this->Lat_wout.size());
-        for (int mm = 0; mm < this->Lat_wout.size(); mm++)
+        // Initialize matrices for later usage
+        Eigen::MatrixXd u_max_thread = Eigen::MatrixXd::Zero(this->Lat_wout.size(), zp.size());
+        Eigen::MatrixXd u = Eigen::MatrixXd::Zero(theta.size() * r.size(), zp.size());
+        Eigen::MatrixXd v = u;
+        Eigen::MatrixXd v_g1 = Eigen::MatrixXd::Zero(theta.size(), r.size());
+        Eigen::ArrayXd z0 = Eigen::ArrayXd::Zero(theta.size() * r.size());
+        BoundaryLayerKernel kernel(r, theta, zp, rho, k_m);
+
+#pragma omp for schedule(dynamic)
+        for (int ii = 0; ii < num_track; ii++)
         {
-            bearing(mm) = 90.0 + ra * atan2(sin(Delta2(mm) / ra) * cos(this->Lat_wout(mm) / ra),
-                cos(Lat / ra) * sin(this->Lat_wout(mm) / ra) - sin(Lat / ra) * cos(this->Lat_wout(mm) / ra) * cos(Delta2(mm) / ra));
-            if (bearing(mm) < 0)
-            {
-                bearing(mm) = bearing(mm) + 360.0;
+            // Messages of the reference point are collected and printed together so the messages of
+            // different threads are not interleaved
+            std::ostringstream log;
+            bool disp_flag;
+            if (ii % disp_interval == 0) {
+                disp_flag = true;
+                log << "WindFieldSimulation: computing wind speed field - storm track location #" << ii + 1 << "/" << this->Lat_w.size() << std::endl;
+            } else {
+                disp_flag = false;
             }
-            jvar(mm) = int(trunc(bearing(mm) / this->delta_p(4))) + 1;
-            kvar(mm) = int(min(int(trunc(dd(mm) / this->delta_p(1))), int(r.size()) - 1)) + 1;
-        }
-
-        jvar2.col(ii) = jvar;
-        kvar2.col(ii) = kvar;
-
-        // Calculate wind field model, for loop for different polar coordinates
-        // theta in for loop and r element-wise
-        for (int jj = 0; jj < theta.size(); jj++) //theta.size()
-        {
-
-            double Ctheta = -c * sin((theta(jj) - beta) / ra);
-            double THETA;
-            if ((theta(jj) >= 0.0) && (theta(jj) <= 90.0))
-                THETA = 90.0 - theta(jj);
-            else
-                THETA = 450.0 - theta(jj);
-
 
-            //std::cout << "Theta: " << THETA << std::endl;
-
-            Eigen::ArrayXd Lat_t = Eigen::ArrayXd::Zero(r.size());
-            Eigen::ArrayXd Long_t = Eigen::ArrayXd::Zero(r.size());
-            Lat_t = ra * asin(sin(Lat / ra) * cos(r / R) + cos(Lat / ra) * sin(r / R) * cos(THETA / ra));
-            for (int kk = 0; kk < r.size(); kk++)
+            // central pressure difference
+            double del_p = (this->P(ii) + dPrs) * 100.0;  // hPa into newton/square meter
+            // Holland B parameter
+            double B = 1.38 + 0.00184 * (del_p / 100.0) - 0.00309 * (this->Rad(ii) + dRad);
+            // translation speed
+            double c = ((this->V(ii) + dSpd) * 1000.0) / 3600.0; // from km/h to m/s
+            // radius in meter
+            double r_m = (this->Rad(ii) + dRad) * 1000.0; // from km to meter
+
+            if (disp_flag) {
+                log << "del_p: " << del_p << " (N/m^2)" << std::endl;
+                log << "B: " << B << std::endl;
+                log << "c: " << c << std::endl;
+                log << "r_m: " << r_m << std::endl;
+            }
+            // B = 1;
+            //del_p = 60*100;
+            //log << "B: " << B << std::endl;
+            //log << "del_p: " << del_p << std::endl;
+
+
+            // location and deading, including perturbation for MC case
+            double Lat = this->Lat_w(ii); // + 0*del_par(0);
+            double Long = abs(this->Long_w(ii)) - 0.3 * dPar(1);
+            double beta = beta_c(ii);
+            // double beta;
+
+            // if ((beta_c(ii)>= 0.0) && (beta_c(ii)<= 90.0))
+            //     beta = 90.0 - beta_c(ii);
+            // else
+            //     beta = 450.0 - beta_c(ii);
+
+            if (disp_flag) {
+                log << "beta: " << beta << std::endl;
+            }   
+
+
+            // Coriolis
+            double omega = 0.00007292;
+            double f = 2.0 * omega * sin((Lat * this->PI) / 180.0);
+
+            Eigen::ArrayXd dd = acos(cos(this->Lat_wout / ra) * cos(Lat / ra) * cos((abs(this->Long_wout) - Long) / ra) 
+                + sin(this->Lat_wout / ra) * sin(Lat / ra));
+            double temp100 = 6371.0 * 180.0 / this->PI / ra * 1000.0;
+            dd = dd * temp100;
+            Eigen::ArrayXd Delta2 = abs(this->Long_wout) - Long + pow(eps, 2);
+
+            // Bearing angle in degrees
+            Eigen::ArrayXd bearing = Eigen::ArrayXd::Zero(this->Lat_wout.size());
+            Eigen::ArrayXd jvar = Eigen::ArrayXd::Zero(this->Lat_wout.size());
+            Eigen::ArrayXd kvar = Eigen::ArrayXd::Zero(this->Lat_wout.size());
+            for (int mm = 0; mm < this->Lat_wout.size(); mm++)
             {
-                Long_t(kk) = Long + ra * atan2(sin(THETA / ra) * sin(r(kk) / R) * cos(Lat / ra), cos(r(kk) / R) 
-                    - sin(Lat / ra) * sin(Lat_t(kk)));
-                Long_t(kk) = wrapTo360(Long_t(kk) + 540.0) - 180.0;
+                bearing(mm) = 90.0 + ra * atan2(sin(Delta2(mm) / ra) * cos(this->Lat_wout(mm) / ra),
+                    cos(Lat / ra) * sin(this->Lat_wout(mm) / ra) - sin(Lat / ra) * cos(this->Lat_wout(mm) / ra) * cos(Delta2(mm) / ra));
+                if (bearing(mm) < 0)
+                {
+                    bearing(mm) = bearing(mm) + 360.0;
+                }
+                jvar(mm) = int(trunc(bearing(mm) / this->delta_p(4))) + 1;
+                kvar(mm) = int(min(int(trunc(dd(mm) / this->delta_p(1))), int(r.size()) - 1)) + 1;
             }
 
-            // Check if point is inside the polygon
-            for (int kk = 0; kk < r.size(); kk++)
+            // Surface roughness of the polar mesh, theta in for loop and r element-wise
+            for (int jj = 0; jj < theta.size(); jj++) //theta.size()
             {
-                // Create arrays
-                Eigen::ArrayXd PolyX = this->Lat_wr.block(0, int(Wr_sizes.size()) - 1, int(this->Wr_sizes(int(this->Wr_sizes.size()) - 1)), 1);
-                Eigen::ArrayXd PolyY = this->Long_wr.block(0, int(Wr_sizes.size()) - 1, int(this->Wr_sizes(int(this->Wr_sizes.size()) - 1)), 1);
+                double THETA;
+                if ((theta(jj) >= 0.0) && (theta(jj) <= 90.0))
+                    THETA = 90.0 - theta(jj);
+                else
+                    THETA = 450.0 - theta(jj);
 
 
-                //z0(kk) = 0.1;
-                int aux = 0;
-                int oi = 0;
+                //std::cout << "Theta: " << THETA << std::endl;
 
-                //while ((aux == 0) && (oi < this->Wr_sizes.size() - 2))
-                while ((aux == 0) && (oi < this->Wr_sizes.size()))
+                Eigen::ArrayXd Lat_t = Eigen::ArrayXd::Zero(r.size());
+                Eigen::ArrayXd Long_t = Eigen::ArrayXd::Zero(r.size());
+                Lat_t = ra * asin(sin(Lat / ra) * cos(r / R) + cos(Lat / ra) * sin(r / R) * cos(THETA / ra));
+                for (int kk = 0; kk < r.size(); kk++)
                 {
-                    Eigen::ArrayXd PolyX = this->Lat_wr.block(0, oi, int(this->Wr_sizes(oi)), 1);
-                    Eigen::ArrayXd PolyY = this->Long_wr.block(0, oi, int(this->Wr_sizes(oi)), 1);
-                    aux = inpolygon(PolyX, PolyY, int(this->Wr_sizes(oi)), Lat_t(kk), Long_t(kk));
-
-                    oi++;
+                    Long_t(kk) = Long + ra * atan2(sin(THETA / ra) * sin(r(kk) / R) * cos(Lat / ra), cos(r(kk) / R) 
+                        - sin(Lat / ra) * sin(Lat_t(kk)));
+                    Long_t(kk) = wrapTo360(Long_t(kk) + 540.0) - 180.0;
                 }
-                if (aux == 1)
+
+                // Check if point is inside the polygon
+                for (int kk = 0; kk < r.size(); kk++)
                 {
-                    z0(kk) = this->z0r(oi-1);
+                    int oi = FindRegion(Lat_t(kk), Long_t(kk));
+                    if (oi >= 0)
+                    {
+                        z0(jj * r.size() + kk) = this->z0r(oi);
 
-                } else {
-                    std::cout << "Warning: The provided z0 polygon does not cover the asset #" << kk << " located at " << Lat_t(kk) << " and " << Long_t(kk) << ". Default 0.01 used" << std::endl;
-                    z0(kk) = 0.01;
+                    } else {
+                        log << "Warning: The provided z0 polygon does not cover the asset #" << kk << " located at " << Lat_t(kk) << " and " << Long_t(kk) << ". Default 0.01 used" << std::endl;
+                        z0(jj * r.size() + kk) = 0.01;
+                    }
                 }
-            }
 
-            if (jj==0 && disp_flag) {
-               std::cout << "z0: " << z0(0) << std::endl;
+                if (jj==0 && disp_flag) {
+                   log << "z0: " << z0(0) << std::endl;
+                }
             }
-            
-            double z10 = 10.0;
-            double A = 11.4;
-            Eigen::ArrayXd h = A * (z0.array().pow(0.86));
-            Eigen::ArrayXd d = 0.75 * h;
-            double kappa = 0.40;
-            Eigen::ArrayXd Cd = (z10 + h - d) * z0.inverse();
-            Cd = ((Cd.log()).pow(2)).inverse();
-            Cd = kappa * kappa * Cd;
-            Eigen::ArrayXd temp = r_m * (r.inverse());
-            Eigen::ArrayXd temp5 = -(temp.pow(B));
-            Eigen::ArrayXd temp6 = temp5.exp();
-            Eigen::ArrayXd der_p = B * (pow(r_m, B)) * del_p * (r.pow(-(B + 1))) * temp6;
-            Eigen::ArrayXd der_p_2 = (-(B + 1.0) * r.inverse() + B * (pow(r_m, B)) * r.pow(-(B + 1.0))) * der_p;
-            v_g1.row(jj) = (0.5) * (Ctheta - f * r) + (((0.5) * (Ctheta - f * r)).array().pow(2) 
-                + (1.0 / rho) * (r.cwiseProduct(der_p))).array().pow(0.5);
-
-            Eigen::ArrayXd der_v_g1_r = -0.5 * f + (0.5) * ((((0.5) * (Ctheta - f * r)).array().pow(2) 
-                + (1 / rho) * (r * der_p)).array().pow(-0.5)) * (-(Ctheta - f * r) * f * 0.5 
-                + (1.0 / rho) * der_p + (1.0 / rho) * r * der_p_2);
-            Eigen::ArrayXd der_v_g1_theta = (0.25 * c) * (cos((theta(jj) - beta) / ra)) * (-Ctheta + f * r) 
-                * ((0.5 * (-Ctheta + f * r)).array().pow(2) + (1 / rho) * r * der_p).array().pow(-0.5) 
-                - (0.5 * c) * cos((theta(jj) - beta) / ra);
-            Eigen::ArrayXd BB = ((2.0 * k_m * r).inverse()) * der_v_g1_theta;
-            Eigen::ArrayXd Eta = (((0.5) * (Ctheta - f * r)).pow(2) + (1.0 / rho) * (r * der_p)).pow(0.5);
-            temp = v_g1.row(jj);
-            Eigen::ArrayXd ALPHA = (1.0 / (2.0 * k_m)) * (f + 2.0 * (temp * r.inverse()));
-            Eigen::ArrayXd BETA = (1.0 / (2.0 * k_m)) * (f + temp * r.inverse() + der_v_g1_r);
-            Eigen::ArrayXd GAMMA = (1.0 / (2.0 * k_m)) * (temp * r.inverse());
-            Eigen::ArrayXcd ALPHA_C = Eigen::ArrayXcd::Zero(ALPHA.size());
-            Eigen::ArrayXcd BETA_C = Eigen::ArrayXcd::Zero(BETA.size());
-            Eigen::ArrayXcd GAMMA_C = Eigen::ArrayXcd::Zero(GAMMA.size());
-            Eigen::ArrayXcd BB_C = Eigen::ArrayXcd::Zero(BB.size());
-            ALPHA_C.real() = ALPHA;
-            BETA_C.real() = BETA;
-            GAMMA_C.real() = GAMMA;
-            BB_C.real() = BB;
-            Eigen::ArrayXd XXX = -(ALPHA * BETA).pow(0.25);
-            Eigen::ArrayXd YYY = -(ALPHA * BETA).pow(0.25);
-
-            Eigen::ArrayXcd PP_zero = Eigen::ArrayXcd::Zero(XXX.size());
-            Eigen::ArrayXcd PP_one = Eigen::ArrayXcd::Zero(XXX.size());
-            Eigen::ArrayXcd PP_minus_one = Eigen::ArrayXcd::Zero(XXX.size());
-            PP_zero.real() = XXX;
-            PP_zero.imag() = YYY;
-            std::complex<double> sc(1.0, 1.0);
-            PP_one = -sc * (GAMMA_C + (ALPHA_C * BETA_C).pow(0.5) - BB_C).pow(0.5);
-            PP_minus_one = -sc * (-GAMMA_C + (ALPHA_C * BETA_C).pow(0.5) - BB_C).pow(0.5);
-
-            Eigen::ArrayXcd X1 = PP_zero + (f / k_m) * r * Cd - (2.0 / k_m) * Eta * Cd -
-                                 (c * c * Cd.pow(2)) * ((4.0 * k_m * k_m * (PP_one - PP_minus_one.conjugate())).inverse()) +
-                                 (c * c * Cd.pow(2)) * ((4.0 * k_m * k_m * (PP_one.conjugate() - PP_minus_one)).inverse());
-
-            Eigen::ArrayXcd X2 = -PP_zero.conjugate() - (f / k_m) * r * Cd + (2.0 / k_m) * Eta * Cd -
-                                 (c * c * Cd.pow(2)) * ((4.0 * k_m * k_m * (PP_one - PP_minus_one.conjugate())).inverse()) +
-                                 (c * c * Cd.pow(2)) * ((4.0 * k_m * k_m * (PP_one.conjugate() - PP_minus_one)).inverse());
-
-            Eigen::ArrayXcd X3 = Eigen::ArrayXcd::Zero(r.size());
-            X3.imag() = -(2.0 / k_m) * Cd * (Eta - (f / 2.0) * r).pow(2);
-
-            Eigen::ArrayXcd X4 = -(-PP_zero - (f / (2.0 * k_m)) * r * Cd + (Eta / k_m) * Cd) *
-                                 (-PP_zero.conjugate() - (f / (2.0 * k_m)) * r * Cd + (Eta / k_m) * Cd).inverse();
-
-            Eigen::ArrayXcd A_zero = -X3 * ((X1 + (X2 * X4)).inverse());
-            std::complex<double> temvar1(0, 1);
-            std::complex<double> temvar2(0, -beta);
-            Eigen::ArrayXcd A_one = Eigen::ArrayXcd::Zero(Cd.size());
-            A_one = temvar1 * c * Cd * exp(temvar2) * (A_zero + A_zero.conjugate()) * (4.0 * k_m * (PP_one - PP_minus_one.conjugate())).inverse();
-            Eigen::ArrayXcd A_minus_one = -A_one.conjugate();
-
-            // Loop for different heights currently only done for z=0
-            for (int kk = 0; kk < zp.size(); kk++)
+
+            // Boundary layer wind at every mesh point and height
+            kernel.Compute(z0, del_p, B, c, r_m, f, beta, u, v, v_g1);
+
+            // Looping over each height in zp
+            for (int pp = 0; pp < zp.size(); pp++)
             {
-                //int kk = 0;
-                Eigen::ArrayXd u_zero = sqrt(ALPHA * inverse(BETA)) * (A_zero * exp(PP_zero * zp(kk))).real();
-                Eigen::ArrayXd v_zero = (A_zero * exp(PP_zero * zp(kk))).imag();
-
-                Eigen::ArrayXd u_one = sqrt(ALPHA * inverse(BETA)) * (A_one * exp(PP_one * zp(kk) + temvar1 * theta(jj) * (PI / 180.0))).real();
-                Eigen::ArrayXd v_one = (A_one * exp(PP_one * zp(kk) + temvar1 * theta(jj) * (PI / 180.0))).imag();
-                Eigen::ArrayXd u_minus_one = sqrt(ALPHA * inverse(BETA)) * (A_minus_one * exp(PP_minus_one * zp(kk) 
-                    - temvar1 * theta(jj) * (PI / 180.0))).real();
-                Eigen::ArrayXd v_minus_one = (A_minus_one * exp(PP_minus_one * zp(kk) - temvar1 * theta(jj) * (PI / 180.0))).imag();
-
-                u_tmp.row(kk) = u_zero + u_one + u_minus_one;
-                v_tmp.row(kk) = v_zero + v_one + v_minus_one;
+                Eigen::Map<Eigen::MatrixXd> tmp_v(v.col(pp).data(), r.size(), theta.size());
+                Eigen::Map<Eigen::MatrixXd> tmp_u(u.col(pp).data(), r.size(), theta.size());
+                Eigen::MatrixXd v_1 = v_g1.transpose() + tmp_v;
+                Eigen::MatrixXd Uvel = (v_1.array().pow(2) + tmp_u.array().pow(2)).array().sqrt();
+                for (int mm = 0; mm < Lat_wout.size(); mm++)
+                {
+                    double Wind_speed = Uvel(int(kvar(mm)) - 1, int(jvar(mm)) - 1);
+                    u_max_thread(mm, pp) = std::max(u_max_thread(mm, pp), Wind_speed);
+                }
             }
 
-            // Saving u_tmp and v_tmp to u and v
-            for (int pp = 0; pp < r.size(); pp++)
+            std::string messages = log.str();
+            if (verbose && !messages.empty())
             {
-                u.row(jj * r.size() + pp) = u_tmp.col(pp).array();
-                v.row(jj * r.size() + pp) = v_tmp.col(pp).array();
+#pragma omp critical (WindFieldModel_log)
+                std::cout << messages << std::flush;
             }
         }
 
-        // Looping over each height in zp
+        // Combining the maximum wind speeds of the threads
+#pragma omp critical (WindFieldModel_u_max)
         for (int pp = 0; pp < zp.size(); pp++)
         {
-            Eigen::Map<Eigen::MatrixXd> tmp_v(v.col(pp).data(), r.size(), theta.size());
-            Eigen::Map<Eigen::MatrixXd> tmp_u(u.col(pp).data(), r.size(), theta.size());
-            Eigen::MatrixXd v_1 = v_g1.transpose() + tmp_v;
-            Eigen::MatrixXd Uvel = (v_1.array().pow(2) + tmp_u.array().pow(2)).array().sqrt();
             for (int mm = 0; mm < Lat_wout.size(); mm++)
             {
-                Wind_speed(mm) = Uvel(int(kvar(mm)) - 1, int(jvar(mm)) - 1);
-                u_max_tmp(mm) = std::max(u_max(mm), Wind_speed(mm));
+                u_max(mm, pp) = std::max(u_max(mm, pp), u_max_thread(mm, pp));
             }
+        }
+    }
 
-            u_max.col(pp) = u_max_tmp;
+    return u_max;
+}
+
+
+int WindFieldModel::SimulateEnsemble(std::string dirOutput)
+{
+    std::cout << "WindFieldSimulation: simulating an ensemble of " << this->num_ensemble << " perturbed tracks." << std::endl;
+
+    // Writing out zp to a result file
+    Eigen::ArrayXd zp = MeasureHeights();
+    std::ofstream zpFile(dirOutput + "/MeasureHeight.csv");
+    zpFile << std::setprecision(4) << zp << "\n";
+    zpFile.close();
+
+    // Sampling the perturbations of the members, each from its own stream seeded by the ensemble
+    // seed and the member number, so a member does not depend on the number of members or threads.
+    // seed_seq takes 32 bit words, so both are split into their low and high words.
+    // The members are spread around the track perturbed by dLatitude, dLongitude, dAngle, dP, dV
+    // and dR of the perturbation file, every perturbation uniform over +-half its amplitude, as in
+    // ComputeIntensityMeasure.py
+    Eigen::ArrayXd base(6);
+    base << this->del_par(0), this->del_par(1), this->del_par(2), this->dP, this->dV, this->dR;
+    Eigen::MatrixXd pert = Eigen::MatrixXd::Zero(this->num_ensemble, 6);
+    for (int k = 0; k < this->num_ensemble; k++)
+    {
+        unsigned long long member = (unsigned long long)k;
+        std::seed_seq seq{uint32_t(this->ensemble_seed), uint32_t(this->ensemble_seed >> 32),
+                          uint32_t(member), uint32_t(member >> 32)};
+        std::mt19937_64 gen(seq);
+        for (int j = 0; j < 6; j++)
+        {
+            double u = double(gen() >> 11) * (1.0 / 9007199254740992.0);
+            pert(k, j) = base(j) + (u - 0.5) * this->ensemble_amp(j);
         }
     }
 
-    // Writing out u_max to a result file
-    std::cout << "WindFieldSimulation: saving simulation results." << std::endl;
-    std::ofstream resultFile(dirOutput + "/MaxWindSpeed.csv");
-    const static Eigen::IOFormat CSVFormat(Eigen::StreamPrecision, Eigen::DontAlignCols, ", ", "\n");
-    resultFile << u_max.format(CSVFormat);
+    std::ofstream pertFile(dirOutput + "/EnsemblePerturbation.csv");
+    pertFile << "dLatitude,dLongitude,dAngle,dP,dV,dR\n";
+    const static Eigen::IOFormat PertFormat(Eigen::FullPrecision, Eigen::DontAlignCols, ",", "\n");
+    pertFile << pert.format(PertFormat) << "\n";
+    pertFile.close();
+
+    // The members are run in parallel, each running its track points in one thread
+    int num_station = int(this->Lat_wout.size());
+    int num_height = int(zp.size());
+    std::vector<double> u_max_ensemble((size_t)this->num_ensemble * num_station * num_height);
+    int num_done = 0;
+#pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < this->num_ensemble; k++)
+    {
+        Eigen::ArrayXd dPar(3);
+        dPar << pert(k, 0), pert(k, 1), pert(k, 2);
+        Eigen::MatrixXd u_max = SimulateTrack(dPar, pert(k, 3), pert(k, 4), pert(k, 5), false);
+
+        // station by station, heights next to each other as in MaxWindSpeed.csv
+        double *u_max_k = &u_max_ensemble[(size_t)k * num_station * num_height];
+        for (int mm = 0; mm < num_station; mm++)
+        {
+            for (int pp = 0; pp < num_height; pp++)
+            {
+                u_max_k[mm * num_height + pp] = u_max(mm, pp);
+            }
+        }
+
+#pragma omp critical (WindFieldModel_log)
+        {
+            num_done++;
+            std::cout << "WindFieldSimulation: ensemble member #" << k + 1 << " done (" << num_done << "/" << this->num_ensemble << ")." << std::endl;
+        }
+    }
+
+    // Writing out the maximum wind speeds of all members to one binary file: the header
+    // "WFSE", then the int32 numbers of members, stations and heights, then the float64 wind
+    // speeds member by member, station by station and height by height
+    std::cout << "WindFieldSimulation: saving ensemble results." << std::endl;
+    std::ofstream resultFile(dirOutput + "/MaxWindSpeedEnsemble.bin", std::ios::binary);
+    int32_t dims[3] = {this->num_ensemble, num_station, num_height};
+    resultFile.write("WFSE", 4);
+    resultFile.write(reinterpret_cast<const char *>(dims), sizeof(dims));
+    resultFile.write(reinterpret_cast<const char *>(u_max_ensemble.data()), u_max_ensemble.size() * sizeof(double));
     resultFile.close();
+    if (!resultFile) {
+        std::cout << "WindFieldSimulation: error - can't write " << dirOutput << "/MaxWindSpeedEnsemble.bin" << std::endl;
+        return 1;
+    }
 
     return 0;
 }
 
 
-int WindFieldModel::inpolygon(Eigen::ArrayXd PolyX, Eigen::ArrayXd PolyY, int N, double px, double py)
+int WindFieldModel::inpolygon(const double *PolyX, const double *PolyY, int N, double px, double py)
 {
     int counter = 0;
     double xinters;
-    double P1x = PolyX(0);
-    double P1y = PolyY(0);
+    double P1x = PolyX[0];
+    double P1y = PolyY[0];
     double P2x, P2y;
 
     for (int ii = 1; ii < N + 1; ii++)
     {
         if (ii < N)
         {
-            P2x = PolyX(ii);
-            P2y = PolyY(ii);
+            P2x = PolyX[ii];
+            P2y = PolyY[ii];
         }
         else
         {
-            P2x = PolyX(0);
-            P2y = PolyY(0);
+            P2x = PolyX[0];
+            P2y = PolyY[0];
         }
         if (py > std::min(P1y, P2y))
         {
@@ -825,6 +1069,18 @@ double WindFieldModel::wrapTo360(double angle)
 }
 
 
+int WindFieldModel::GridCell(double x, double x0, double dx, int n)
+{
+    int cell = int((x - x0) / dx);
+    if (cell < 0)
+        return 0;
+    else if (cell > n - 1)
+        return n - 1;
+    else
+        return cell;
+}
+
+
 int WindFieldModel::min(int a, int b)
 {
     if (a > b)
@@ -862,6 +1118,9 @@ int main(int argc, char *argv[])
     a.DefineTern(terrain_file);
 
     a.ComputeStationZ0(z0_dir);
+    if (a.EnsembleSize() > 0) {
+        return a.SimulateEnsemble(pws_dir);
+    }
     a.SimulateWind(pws_dir);
     return 0;
 }
@@ -1,6 +1,7 @@
 #ifndef WIND_FIELD_MODEL_H_
 #define WIND_FIELD_MODEL_H_
 
+#include <vector>
 #include <Eigen/Dense>
 
 
@@ -48,6 +49,30 @@ private:
     Eigen::ArrayXd Wr_sizes;
     int num_region;
 
+    // uniform grid index of the terrain polygons over latitude and longitude
+    // terrain_div: cell size in degrees, automatic when not positive
+    // Wr_lat_min, ...: padded bounding boxes of the regions
+    // grid_first: first entry of each cell in grid_regions, the last entry closes the last cell
+    // grid_regions: regions whose bounding box overlaps each cell, in increasing order
+    double terrain_div = 0.0;
+    int grid_nlat = 0;
+    int grid_nlong = 0;
+    double grid_lat0 = 0.0;
+    double grid_long0 = 0.0;
+    double grid_dlat = 1.0;
+    double grid_dlong = 1.0;
+    double grid_lat1 = 0.0;
+    double grid_long1 = 0.0;
+    Eigen::ArrayXd Wr_lat_min;
+    Eigen::ArrayXd Wr_lat_max;
+    Eigen::ArrayXd Wr_long_min;
+    Eigen::ArrayXd Wr_long_max;
+    std::vector<int> grid_first;
+    std::vector<int> grid_regions;
+    // grid_cell_region: region of each cell found once for the whole cell, -1 for no region and
+    // -2 for cells crossed by a polygon edge, whose points are tested against the regions
+    std::vector<int> grid_cell_region;
+
     // stations
     Eigen::ArrayXd Lat_wout;
     Eigen::ArrayXd Long_wout;
@@ -67,10 +92,24 @@ private:
     Eigen::ArrayXd V;
     Eigen::ArrayXd Rad;
 
+    // ensemble of perturbed tracks
+    // num_ensemble: number of members, no ensemble when 0
+    // ensemble_amp: amplitudes of dLatitude, dLongitude, dAngle, dP, dV and dR
+    int num_ensemble = 0;
+    unsigned long long ensemble_seed = 0;
+    Eigen::ArrayXd ensemble_amp;
+
     // methods
     double wrapTo360(double angle);
-    int inpolygon(Eigen::ArrayXd PolyX, Eigen::ArrayXd PolyY, int N, double px, double py);
+    int inpolygon(const double *PolyX, const double *PolyY, int N, double px, double py);
+    void IndexTern();
+    int FindRegion(double px, double py);
+    int FindRegionInCell(int cell, double px, double py);
+    void MarkEdgeCells(double x1, double y1, double x2, double y2, double pad);
+    static int GridCell(double x, double x0, double dx, int n);
     int min(int a, int b);
+    Eigen::ArrayXd MeasureHeights();
+    Eigen::MatrixXd SimulateTrack(const Eigen::ArrayXd &dPar, double dPrs, double dSpd, double dRad, bool verbose);
 
 public:
 
@@ -90,6 +129,10 @@ public:
     // simulating wind field
     int SimulateWind(std::string dirOutput);
 
+    // simulating the wind fields of an ensemble of perturbed tracks
+    int SimulateEnsemble(std::string dirOutput);
+    int EnsembleSize() { return num_ensemble; }
+
 };
 
 #endif // WIND_FIELD_MODEL_H_
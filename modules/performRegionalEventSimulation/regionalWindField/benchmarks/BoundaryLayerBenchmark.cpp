@@ -0,0 +1,228 @@
+// Microbenchmark of the boundary layer kernel of WindFieldSimulation
+//
+// The kernel is run on polar meshes with random surface roughness and timed against the reference
+// implementation below, which is the std::complex formulation the kernel replaced. The number of
+// mesh point and height evaluations per second of both is reported, and the kernel benchmark reports
+// the largest difference between its wind speeds and those of the reference as max_diff in m/s.
+//
+// Usage: BoundaryLayerBenchmark [Google Benchmark options]
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <random>
+#include <Eigen/Dense>
+// Google Benchmark
+#include <benchmark/benchmark.h>
+#include "BoundaryLayerKernel.h"
+
+namespace
+{
+    const double PI = 3.14159265358979323846;
+
+    // Boundary layer wind of one track point, computed one angle at a time with std::complex arrays
+    void ReferenceCompute(const Eigen::ArrayXd &r, const Eigen::ArrayXd &theta, const Eigen::ArrayXd &zp,
+        double rho, double k_m, const Eigen::ArrayXd &z0_mesh, double del_p, double B, double c,
+        double r_m, double f, double beta, Eigen::MatrixXd &u, Eigen::MatrixXd &v, Eigen::MatrixXd &v_g1)
+    {
+        double ra = 180.0 / PI;
+        Eigen::MatrixXd u_tmp = Eigen::MatrixXd::Zero(zp.size(), r.size());
+        Eigen::MatrixXd v_tmp = u_tmp;
+
+        for (int jj = 0; jj < theta.size(); jj++)
+        {
+            double Ctheta = -c * sin((theta(jj) - beta) / ra);
+            Eigen::ArrayXd z0 = z0_mesh.segment(jj * r.size(), r.size());
+
+            double z10 = 10.0;
+            double A = 11.4;
+            Eigen::ArrayXd h = A * (z0.array().pow(0.86));
+            Eigen::ArrayXd d = 0.75 * h;
+            double kappa = 0.40;
+            Eigen::ArrayXd Cd = (z10 + h - d) * z0.inverse();
+            Cd = ((Cd.log()).pow(2)).inverse();
+            Cd = kappa * kappa * Cd;
+            Eigen::ArrayXd temp = r_m * (r.inverse());
+            Eigen::ArrayXd temp5 = -(temp.pow(B));
+            Eigen::ArrayXd temp6 = temp5.exp();
+            Eigen::ArrayXd der_p = B * (pow(r_m, B)) * del_p * (r.pow(-(B + 1))) * temp6;
+            Eigen::ArrayXd der_p_2 = (-(B + 1.0) * r.inverse() + B * (pow(r_m, B)) * r.pow(-(B + 1.0))) * der_p;
+            v_g1.row(jj) = (0.5) * (Ctheta - f * r) + (((0.5) * (Ctheta - f * r)).array().pow(2)
+                + (1.0 / rho) * (r.cwiseProduct(der_p))).array().pow(0.5);
+
+            Eigen::ArrayXd der_v_g1_r = -0.5 * f + (0.5) * ((((0.5) * (Ctheta - f * r)).array().pow(2)
+                + (1 / rho) * (r * der_p)).array().pow(-0.5)) * (-(Ctheta - f * r) * f * 0.5
+                + (1.0 / rho) * der_p + (1.0 / rho) * r * der_p_2);
+            Eigen::ArrayXd der_v_g1_theta = (0.25 * c) * (cos((theta(jj) - beta) / ra)) * (-Ctheta + f * r)
+                * ((0.5 * (-Ctheta + f * r)).array().pow(2) + (1 / rho) * r * der_p).array().pow(-0.5)
+                - (0.5 * c) * cos((theta(jj) - beta) / ra);
+            Eigen::ArrayXd BB = ((2.0 * k_m * r).inverse()) * der_v_g1_theta;
+            Eigen::ArrayXd Eta = (((0.5) * (Ctheta - f * r)).pow(2) + (1.0 / rho) * (r * der_p)).pow(0.5);
+            temp = v_g1.row(jj);
+            Eigen::ArrayXd ALPHA = (1.0 / (2.0 * k_m)) * (f + 2.0 * (temp * r.inverse()));
+            Eigen::ArrayXd BETA = (1.0 / (2.0 * k_m)) * (f + temp * r.inverse() + der_v_g1_r);
+            Eigen::ArrayXd GAMMA = (1.0 / (2.0 * k_m)) * (temp * r.inverse());
+            Eigen::ArrayXcd ALPHA_C = Eigen::ArrayXcd::Zero(ALPHA.size());
+            Eigen::ArrayXcd BETA_C = Eigen::ArrayXcd::Zero(BETA.size());
+            Eigen::ArrayXcd GAMMA_C = Eigen::ArrayXcd::Zero(GAMMA.size());
+            Eigen::ArrayXcd BB_C = Eigen::ArrayXcd::Zero(BB.size());
+            ALPHA_C.real() = ALPHA;
+            BETA_C.real() = BETA;
+            GAMMA_C.real() = GAMMA;
+            BB_C.real() = BB;
+            Eigen::ArrayXd XXX = -(ALPHA * BETA).pow(0.25);
+            Eigen::ArrayXd YYY = -(ALPHA * BETA).pow(0.25);
+
+            Eigen::ArrayXcd PP_zero = Eigen::ArrayXcd::Zero(XXX.size());
+            Eigen::ArrayXcd PP_one = Eigen::ArrayXcd::Zero(XXX.size());
+            Eigen::ArrayXcd PP_minus_one = Eigen::ArrayXcd::Zero(XXX.size());
+            PP_zero.real() = XXX;
+            PP_zero.imag() = YYY;
+            std::complex<double> sc(1.0, 1.0);
+            PP_one = -sc * (GAMMA_C + (ALPHA_C * BETA_C).pow(0.5) - BB_C).pow(0.5);
+            PP_minus_one = -sc * (-GAMMA_C + (ALPHA_C * BETA_C).pow(0.5) - BB_C).pow(0.5);
+
+            Eigen::ArrayXcd X1 = PP_zero + (f / k_m) * r * Cd - (2.0 / k_m) * Eta * Cd -
+                                 (c * c * Cd.pow(2)) * ((4.0 * k_m * k_m * (PP_one - PP_minus_one.conjugate())).inverse()) +
+                                 (c * c * Cd.pow(2)) * ((4.0 * k_m * k_m * (PP_one.conjugate() - PP_minus_one)).inverse());
+
+            Eigen::ArrayXcd X2 = -PP_zero.conjugate() - (f / k_m) * r * Cd + (2.0 / k_m) * Eta * Cd -
+                                 (c * c * Cd.pow(2)) * ((4.0 * k_m * k_m * (PP_one - PP_minus_one.conjugate())).inverse()) +
+                                 (c * c * Cd.pow(2)) * ((4.0 * k_m * k_m * (PP_one.conjugate() - PP_minus_one)).inverse());
+
+            Eigen::ArrayXcd X3 = Eigen::ArrayXcd::Zero(r.size());
+            X3.imag() = -(2.0 / k_m) * Cd * (Eta - (f / 2.0) * r).pow(2);
+
+            Eigen::ArrayXcd X4 = -(-PP_zero - (f / (2.0 * k_m)) * r * Cd + (Eta / k_m) * Cd) *
+                                 (-PP_zero.conjugate() - (f / (2.0 * k_m)) * r * Cd + (Eta / k_m) * Cd).inverse();
+
+            Eigen::ArrayXcd A_zero = -X3 * ((X1 + (X2 * X4)).inverse());
+            std::complex<double> temvar1(0, 1);
+            std::complex<double> temvar2(0, -beta);
+            Eigen::ArrayXcd A_one = Eigen::ArrayXcd::Zero(Cd.size());
+            A_one = temvar1 * c * Cd * exp(temvar2) * (A_zero + A_zero.conjugate()) * (4.0 * k_m * (PP_one - PP_minus_one.conjugate())).inverse();
+            Eigen::ArrayXcd A_minus_one = -A_one.conjugate();
+
+            for (int kk = 0; kk < zp.size(); kk++)
+            {
+                Eigen::ArrayXd u_zero = sqrt(ALPHA * inverse(BETA)) * (A_zero * exp(PP_zero * zp(kk))).real();
+                Eigen::ArrayXd v_zero = (A_zero * exp(PP_zero * zp(kk))).imag();
+
+                Eigen::ArrayXd u_one = sqrt(ALPHA * inverse(BETA)) * (A_one * exp(PP_one * zp(kk) + temvar1 * theta(jj) * (PI / 180.0))).real();
+                Eigen::ArrayXd v_one = (A_one * exp(PP_one * zp(kk) + temvar1 * theta(jj) * (PI / 180.0))).imag();
+                Eigen::ArrayXd u_minus_one = sqrt(ALPHA * inverse(BETA)) * (A_minus_one * exp(PP_minus_one * zp(kk)
+                    - temvar1 * theta(jj) * (PI / 180.0))).real();
+                Eigen::ArrayXd v_minus_one = (A_minus_one * exp(PP_minus_one * zp(kk) - temvar1 * theta(jj) * (PI / 180.0))).imag();
+
+                u_tmp.row(kk) = u_zero + u_one + u_minus_one;
+                v_tmp.row(kk) = v_zero + v_one + v_minus_one;
+            }
+
+            for (int pp = 0; pp < r.size(); pp++)
+            {
+                u.row(jj * r.size() + pp) = u_tmp.col(pp).array();
+                v.row(jj * r.size() + pp) = v_tmp.col(pp).array();
+            }
+        }
+    }
+
+    // Wind speed of each mesh point and height, as in WindFieldModel::SimulateTrack
+    Eigen::MatrixXd WindSpeed(const Eigen::MatrixXd &u, const Eigen::MatrixXd &v, const Eigen::MatrixXd &v_g1)
+    {
+        Eigen::MatrixXd speed(u.rows(), u.cols());
+        for (int pp = 0; pp < u.cols(); pp++)
+        {
+            for (int jj = 0; jj < v_g1.rows(); jj++)
+            {
+                for (int kk = 0; kk < v_g1.cols(); kk++)
+                {
+                    int n = jj * int(v_g1.cols()) + kk;
+                    double v_1 = v_g1(jj, kk) + v(n, pp);
+                    speed(n, pp) = sqrt(v_1 * v_1 + u(n, pp) * u(n, pp));
+                }
+            }
+        }
+        return speed;
+    }
+
+    // A category 3 storm heading north east over a mesh with 5 degree divisions, numRadii radial
+    // divisions out to 996 km and three heights. The default mesh of WindFieldSimulation has 200
+    struct Storm
+    {
+        Eigen::ArrayXd r, theta, zp, z0;
+        double rho = 1.225;
+        double k_m = 50.0;
+        double del_p = 6000.0;
+        double B = 1.38 + 0.00184 * 60.0 - 0.00309 * 40.0;
+        double c = 20.0 * 1000.0 / 3600.0;
+        double r_m = 40000.0;
+        double f = 2.0 * 0.00007292 * sin(30.0 * PI / 180.0);
+        double beta = 45.0;
+        Eigen::MatrixXd u, v, v_g1;
+
+        explicit Storm(int numRadii)
+        {
+            r = Eigen::ArrayXd::LinSpaced(numRadii, 1000.0, 996000.0);
+            theta = Eigen::ArrayXd::LinSpaced(73, 0.0, 360.0);
+            zp = Eigen::ArrayXd(3);
+            zp << 10.0, 20.0, 30.0;
+
+            std::mt19937_64 gen(100);
+            std::uniform_real_distribution<double> roughness(0.001, 1.0);
+            z0 = Eigen::ArrayXd(theta.size() * r.size());
+            for (int n = 0; n < z0.size(); n++)
+                z0(n) = roughness(gen);
+
+            u = Eigen::MatrixXd::Zero(theta.size() * r.size(), zp.size());
+            v = u;
+            v_g1 = Eigen::MatrixXd::Zero(theta.size(), r.size());
+        }
+
+        void Reference()
+        {
+            ReferenceCompute(r, theta, zp, rho, k_m, z0, del_p, B, c, r_m, f, beta, u, v, v_g1);
+        }
+
+        int64_t Evaluations() const
+        {
+            return int64_t(z0.size()) * zp.size();
+        }
+    };
+
+    // Benchmark the reference implementation for the input number of radial divisions
+    void reference_compute(benchmark::State &state)
+    {
+        Storm storm(int(state.range(0)));
+        for (auto _ : state)
+        {
+            storm.Reference();
+            benchmark::DoNotOptimize(storm.u.data());
+        }
+        state.SetItemsProcessed(state.iterations() * storm.Evaluations());
+    }
+
+    // Benchmark the kernel for the input number of radial divisions
+    void kernel_compute(benchmark::State &state)
+    {
+        Storm storm(int(state.range(0)));
+        BoundaryLayerKernel kernel(storm.r, storm.theta, storm.zp, storm.rho, storm.k_m);
+        for (auto _ : state)
+        {
+            kernel.Compute(storm.z0, storm.del_p, storm.B, storm.c, storm.r_m, storm.f, storm.beta, storm.u,
+                           storm.v, storm.v_g1);
+            benchmark::DoNotOptimize(storm.u.data());
+        }
+        state.SetItemsProcessed(state.iterations() * storm.Evaluations());
+
+        Storm reference(int(state.range(0)));
+        reference.Reference();
+        Eigen::MatrixXd speed = WindSpeed(storm.u, storm.v, storm.v_g1);
+        Eigen::MatrixXd speed_ref = WindSpeed(reference.u, reference.v, reference.v_g1);
+        state.counters["max_diff"] = (speed - speed_ref).cwiseAbs().maxCoeff();
+    }
+}
+
+BENCHMARK(reference_compute)->Arg(50)->Arg(200);
+BENCHMARK(kernel_compute)->Arg(50)->Arg(200);
+
+BENCHMARK_MAIN();
@@ -6,10 +6,13 @@
 #include <fstream>
 #include <iostream>
 #include <cmath>
+#include <unordered_map>
+#include <vector>
 using namespace std;
 
 #include <jansson.h>  // for Json
 #include "common/Units.h"
+#include "common/EnvelopeKernels.h"
 
 int main(int argc, char **argv)
 {
@@ -130,11 +133,42 @@ int main(int argc, char **argv)
       tDOFs = new int[numPattern];
       double *maxPGAs = new double[numPattern];
 
+      // index the time series by name, if a name is repeated the first series is used
+      std::unordered_map<std::string, int> seriesIndex;
+      for (int i=0; i<numSeries; i++) {
+	const char *seriesName = json_string_value(json_object_get(json_array_get(timeSeriesArray, i), "name"));
+	if (seriesName != NULL)
+	  seriesIndex.emplace(seriesName, i);
+      }
+
+      // the accelerations of the patterns are copied once into a single array, the
+      // acceleration of pattern ii in accels[accelStart[ii]] to accels[accelStart[ii+1]-1],
+      // and the PGAs are then computed for all patterns at once
+      std::vector<double> accels;
+      std::vector<size_t> accelStart(1, 0);
+
       if (numPattern != 0) {
+	// the time series of each pattern, NULL if there is none, and the number of values to copy,
+	// so that accels is allocated once
+	std::vector<json_t *> patternSeries(numPattern, (json_t *)NULL);
+	size_t numValues = 0;
+	for (int ii=0; ii<numPattern; ii++) {
+	  const char *timeSeriesName = json_string_value(json_object_get(json_array_get(patternArray, ii), "timeSeries"));
+	  if (timeSeriesName != NULL) {
+	    std::unordered_map<std::string, int>::iterator seriesIt = seriesIndex.find(timeSeriesName);
+	    if (seriesIt != seriesIndex.end()) {
+	      patternSeries[ii] = json_array_get(timeSeriesArray, seriesIt->second);
+	      const char *subType = json_string_value(json_object_get(patternSeries[ii],"type"));
+	      if (subType != NULL && strcmp(subType,"Value") == 0)
+		numValues += json_array_size(json_object_get(patternSeries[ii],"data"));
+	    }
+	  }
+	}
+	accels.reserve(numValues);
+
 	for (int ii=0; ii<numPattern; ii++) {
 	  json_t *thePattern = json_array_get(patternArray, ii);
 	  json_t *theDof = json_object_get(thePattern, "dof");
-	  json_t *theSeries = json_object_get(thePattern, "timeSeries");
 	  tDOFs[ii] = json_integer_value(theDof);
 	  if (theDof != 0) {
 	    json_array_append(theDOFs, theDof);
@@ -144,47 +178,38 @@ int main(int argc, char **argv)
 	    exit(-1);
 	  }
 
-	  double PGA = 0.0;
-	  
-	  const char *timeSeriesName = json_string_value(theSeries);
-
-	  // loop over time series & find one wmatching name, loop over data & get Value
-	  for (int i=0; i<numSeries; i++) {
-	    json_t *theSeries = json_array_get(timeSeriesArray, i);
-	    json_t *theName = json_object_get(theSeries, "name");	    
-	    
-	    if (strcmp(timeSeriesName, json_string_value(theName)) == 0) {
-	      i = numSeries;
-	      const char *subType = json_string_value(json_object_get(theSeries,"type"));
-	      std::cerr << "subType: " << subType << "\n";
-	      if (strcmp(subType,"Value")  == 0) {
+	  // copy the values of the time series with matching name
+	  if (patternSeries[ii] != NULL) {
+	    json_t *theSeries = patternSeries[ii];
+	    const char *subType = json_string_value(json_object_get(theSeries,"type"));
+	    std::cerr << "subType: " << subType << "\n";
+	    if (strcmp(subType,"Value")  == 0) {
 		
-		double seriesFactor = 1.0;
-		json_t *seriesFactorObj = json_object_get(theSeries,"factor");
-		if (seriesFactorObj != NULL) {
-		  if (json_is_real(seriesFactorObj))
-		    seriesFactor = json_number_value(seriesFactorObj);
-		}
+	      double seriesFactor = 1.0;
+	      json_t *seriesFactorObj = json_object_get(theSeries,"factor");
+	      if (seriesFactorObj != NULL) {
+		if (json_is_real(seriesFactorObj))
+		  seriesFactor = json_number_value(seriesFactorObj);
+	      }
 		
-		double dt = json_number_value(json_object_get(theSeries,"dT"));
-		json_t *data = json_object_get(theSeries,"data");
+	      json_t *data = json_object_get(theSeries,"data");
 		
-		json_t *dataV;
-		int dataIndex;
-		json_array_foreach(data, dataIndex, dataV) {
-		  double accel = json_number_value(dataV) * unitConversionFactor * seriesFactor;
-		  double absAccel = fabs(accel);
-		  if (absAccel > PGA)
-		    PGA = absAccel;
-		}
+	      json_t *dataV;
+	      int dataIndex;
+	      json_array_foreach(data, dataIndex, dataV) {
+		accels.push_back(json_number_value(dataV) * unitConversionFactor * seriesFactor);
 	      }
 	    }
 	  }
 
-	  maxPGAs[ii] = PGA;
-	  json_array_append(thePGAs, json_real(PGA));
-
+	  // a pattern without a Value time series has a PGA of 0
+	  accelStart.push_back(accels.size());
 	}
+
+	EnvelopeKernels::Peak(accels.data(), accelStart.data(), numPattern, maxPGAs);
+	for (int ii=0; ii<numPattern; ii++)
+	  json_array_append(thePGAs, json_real(maxPGAs[ii]));
+
       } else {
 	printf("ERROR no patterns with Seismic event");
 	exit(-1);
@@ -0,0 +1,209 @@
+// Throughput benchmark of the envelope kernels used by ExtractPGA
+//
+// A set of ground motion records is built as jansson time series, like those of an EVENT file. Their
+// PGAs are computed as ExtractPGA used to, walking each json data array, and as it does now, copying all
+// records once into a contiguous array and running the peak kernel on it. The mean, rms and percentile
+// kernels are timed on the same array. Every kernel is checked against a plain scalar loop, and the
+// records per second and values per second of each step are reported.
+//
+// Usage: EnvelopeBenchmark [number of records] [steps per record] [repetitions]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <jansson.h>
+#include "common/EnvelopeKernels.h"
+
+namespace
+{
+    double Seconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Report(const std::string& step, double seconds, int repetitions, int numRecords, size_t numValues)
+    {
+        seconds /= repetitions;
+        std::cout << std::left << std::setw(34) << step << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(12) << seconds * 1000
+                  << std::setprecision(0) << std::setw(16) << numRecords / seconds
+                  << std::setprecision(1) << std::setw(14) << numValues / seconds / 1e6 << "\n";
+    }
+
+    // Percentile of the absolute values, from a fully sorted copy of the channel
+    double ReferencePercentile(const double* data, size_t numValues, double percentile)
+    {
+        if (numValues == 0)
+            return 0.0;
+        std::vector<double> sorted(numValues);
+        for (size_t i = 0; i < numValues; i++)
+            sorted[i] = std::fabs(data[i]);
+        std::sort(sorted.begin(), sorted.end());
+        double rank = percentile / 100.0 * (numValues - 1);
+        size_t below = (size_t)std::floor(rank);
+        size_t above = std::min(below + 1, numValues - 1);
+        return sorted[below] + (rank - below) * (sorted[above] - sorted[below]);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int numRecords = (argc > 1) ? std::atoi(argv[1]) : 10000;
+    int numSteps = (argc > 2) ? std::atoi(argv[2]) : 2000;
+    int repetitions = (argc > 3) ? std::atoi(argv[3]) : 5;
+
+    // records of slightly different lengths, so the channels are not all aligned alike
+    std::mt19937 generator(1);
+    std::normal_distribution<double> normal(0.0, 0.3);
+    json_t* timeSeriesArray = json_array();
+    size_t numValues = 0;
+    for (int record = 0; record < numRecords; record++)
+    {
+        int length = numSteps + record % 7;
+        json_t* data = json_array();
+        for (int step = 0; step < length; step++)
+            json_array_append_new(data, json_real(normal(generator)));
+        json_t* series = json_object();
+        json_object_set_new(series, "data", data);
+        json_array_append_new(timeSeriesArray, series);
+        numValues += length;
+    }
+
+    std::cout << numRecords << " records, " << numValues << " values\n\n"
+              << "step                                 time (ms)     records/s   Mvalues/s\n";
+
+    // PGAs from the json arrays, one value at a time
+    std::vector<double> jsonPGAs(numRecords);
+    auto start = std::chrono::steady_clock::now();
+    for (int repetition = 0; repetition < repetitions; repetition++)
+    {
+        for (int record = 0; record < numRecords; record++)
+        {
+            json_t* data = json_object_get(json_array_get(timeSeriesArray, record), "data");
+            double PGA = 0.0;
+            json_t* dataV;
+            size_t dataIndex;
+            json_array_foreach(data, dataIndex, dataV)
+            {
+                double absAccel = std::fabs(json_number_value(dataV));
+                if (absAccel > PGA)
+                    PGA = absAccel;
+            }
+            jsonPGAs[record] = PGA;
+        }
+    }
+    Report("PGA walking the json arrays", Seconds(start), repetitions, numRecords, numValues);
+
+    // one-shot conversion to a contiguous array
+    std::vector<double> values;
+    std::vector<size_t> channelStart;
+    start = std::chrono::steady_clock::now();
+    for (int repetition = 0; repetition < repetitions; repetition++)
+    {
+        values.resize(numValues);
+        channelStart.assign(1, 0);
+        for (int record = 0; record < numRecords; record++)
+        {
+            json_t* data = json_object_get(json_array_get(timeSeriesArray, record), "data");
+            double* channel = &values[channelStart.back()];
+            json_t* dataV;
+            size_t dataIndex;
+            json_array_foreach(data, dataIndex, dataV)
+                channel[dataIndex] = json_number_value(dataV);
+            channelStart.push_back(channelStart.back() + json_array_size(data));
+        }
+    }
+    double conversionSeconds = Seconds(start);
+    Report("json to contiguous conversion", conversionSeconds, repetitions, numRecords, numValues);
+
+    int numFailed = 0;
+    std::vector<double> results(numRecords), reference(numRecords);
+
+    // scalar loop over the contiguous array, the reference of the kernels
+    start = std::chrono::steady_clock::now();
+    for (int repetition = 0; repetition < repetitions; repetition++)
+    {
+        for (int record = 0; record < numRecords; record++)
+        {
+            double peak = 0.0;
+            for (size_t i = channelStart[record]; i < channelStart[record + 1]; i++)
+                peak = std::max(peak, std::fabs(values[i]));
+            reference[record] = peak;
+        }
+    }
+    Report("peak, scalar loop", Seconds(start), repetitions, numRecords, numValues);
+
+    start = std::chrono::steady_clock::now();
+    for (int repetition = 0; repetition < repetitions; repetition++)
+        EnvelopeKernels::Peak(values.data(), channelStart.data(), numRecords, results.data());
+    double peakSeconds = Seconds(start);
+    Report("peak kernel", peakSeconds, repetitions, numRecords, numValues);
+    Report("PGA, conversion and peak kernel", conversionSeconds + peakSeconds, repetitions, numRecords, numValues);
+    if (results != reference || results != jsonPGAs)
+    {
+        std::cout << "peak kernel FAILED, differs from the scalar loop\n";
+        numFailed++;
+    }
+
+    // mean and rms, checked to a relative tolerance as the lanes sum in a different order
+    for (int envelope = 0; envelope < 2; envelope++)
+    {
+        start = std::chrono::steady_clock::now();
+        for (int repetition = 0; repetition < repetitions; repetition++)
+        {
+            if (envelope == 0)
+                EnvelopeKernels::Mean(values.data(), channelStart.data(), numRecords, results.data());
+            else
+                EnvelopeKernels::Rms(values.data(), channelStart.data(), numRecords, results.data());
+        }
+        Report(envelope == 0 ? "mean kernel" : "rms kernel", Seconds(start), repetitions, numRecords, numValues);
+
+        double largestError = 0.0;
+        for (int record = 0; record < numRecords; record++)
+        {
+            double sum = 0.0, sumSquares = 0.0;
+            size_t length = channelStart[record + 1] - channelStart[record];
+            for (size_t i = channelStart[record]; i < channelStart[record + 1]; i++)
+            {
+                sum += values[i];
+                sumSquares += values[i] * values[i];
+            }
+            double expected = (envelope == 0) ? sum / length : std::sqrt(sumSquares / length);
+            largestError = std::max(largestError, std::fabs(results[record] - expected) / std::max(1e-3, std::fabs(expected)));
+        }
+        if (largestError > 1e-10)
+        {
+            std::cout << (envelope == 0 ? "mean" : "rms") << " kernel FAILED, relative error " << largestError << "\n";
+            numFailed++;
+        }
+    }
+
+    // percentiles of the absolute values
+    for (double percentile : {50.0, 95.0})
+    {
+        start = std::chrono::steady_clock::now();
+        for (int repetition = 0; repetition < repetitions; repetition++)
+            EnvelopeKernels::AbsPercentile(values.data(), channelStart.data(), numRecords, percentile, results.data());
+        Report("percentile " + std::to_string((int)percentile) + " kernel", Seconds(start), repetitions, numRecords, numValues);
+
+        for (int record = 0; record < numRecords; record++)
+        {
+            size_t start = channelStart[record];
+            if (results[record] != ReferencePercentile(&values[start], channelStart[record + 1] - start, percentile))
+            {
+                std::cout << "percentile " << percentile << " kernel FAILED, differs from a full sort\n";
+                numFailed++;
+                break;
+            }
+        }
+    }
+
+    json_decref(timeSeriesArray);
+    return numFailed;
+}
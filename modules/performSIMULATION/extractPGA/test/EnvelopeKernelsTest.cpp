@@ -0,0 +1,153 @@
+// Unit test of the envelope kernels of common used by ExtractPGA
+//
+// The percentiles of small channels are checked against the values numpy.percentile gives with its default
+// linear interpolation, and the peak, mean and rms of channels of every length up to a few lanes against
+// plain scalar loops. Empty channels have to give 0, and channels holding a NaN a NaN mean, rms and
+// percentile and the peak of their other values.
+//
+// Usage: EnvelopeKernelsTest
+// Returns the number of failures.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "common/EnvelopeKernels.h"
+
+namespace
+{
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+    //Channels stored one after the other, as the kernels take them
+    struct Channels
+    {
+        std::vector<double> values;
+        std::vector<size_t> start = {0};
+
+        void Add(const std::vector<double>& channel)
+        {
+            values.insert(values.end(), channel.begin(), channel.end());
+            start.push_back(values.size());
+        }
+
+        int Size() const
+        {
+            return (int)start.size() - 1;
+        }
+    };
+
+    //Equal to a relative tolerance, or both NaN
+    bool Same(double value, double expected, double tolerance)
+    {
+        if (std::isnan(expected))
+            return std::isnan(value);
+        return std::fabs(value - expected) <= tolerance * std::max(1.0, std::fabs(expected));
+    }
+
+    int Check(const std::string& name, const std::vector<double>& values, const std::vector<double>& expected,
+              double tolerance)
+    {
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            if (!Same(values[i], expected[i], tolerance))
+            {
+                std::cout << name << " FAILED: channel " << i << " gives " << values[i] << " instead of "
+                          << expected[i] << "\n";
+                return 1;
+            }
+        }
+        std::cout << name << " passed\n";
+        return 0;
+    }
+
+    //Percentiles against numpy.percentile(np.abs(channel), percentile)
+    int CheckPercentiles()
+    {
+        Channels channels;
+        channels.Add({-1.0, 2.0, -3.0, 4.0});
+        channels.Add({5.0, -1.0, 3.0, 3.0, -9.0, 0.0, 2.0});
+        channels.Add({-2.5});
+        channels.Add({});
+        channels.Add({1.0, NaN, -3.0});
+
+        struct Case
+        {
+            double percentile;
+            std::vector<double> expected;
+        };
+        const std::vector<Case> cases = {
+            {0.0, {1.0, 0.0, 2.5, 0.0, NaN}},
+            {10.0, {1.3, 0.6, 2.5, 0.0, NaN}},
+            {25.0, {1.75, 1.5, 2.5, 0.0, NaN}},
+            {50.0, {2.5, 3.0, 2.5, 0.0, NaN}},
+            {90.0, {3.7, 6.6, 2.5, 0.0, NaN}},
+            {95.0, {3.85, 7.8, 2.5, 0.0, NaN}},
+            {100.0, {4.0, 9.0, 2.5, 0.0, NaN}}};
+
+        int numFailed = 0;
+        std::vector<double> percentiles(channels.Size());
+        for (const Case& current : cases)
+        {
+            EnvelopeKernels::AbsPercentile(channels.values.data(), channels.start.data(), channels.Size(),
+                                           current.percentile, percentiles.data());
+            numFailed += Check("percentile " + std::to_string((int)current.percentile), percentiles,
+                               current.expected, 1e-12);
+        }
+        return numFailed;
+    }
+
+    //Peak, mean and rms against scalar loops on random channels of 0 to 33 values, which covers channels
+    //shorter than a lane block and every length of the remainder
+    int CheckReductions()
+    {
+        std::mt19937_64 generator(100);
+        std::normal_distribution<double> distribution(0.0, 1.0);
+
+        Channels channels;
+        std::vector<double> peaks, means, rms;
+        for (int length = 0; length <= 33; length++)
+        {
+            std::vector<double> channel(length);
+            double peak = 0.0, sum = 0.0, sumSquares = 0.0;
+            for (double& value : channel)
+            {
+                value = distribution(generator);
+                peak = std::max(peak, std::fabs(value));
+                sum += value;
+                sumSquares += value * value;
+            }
+            channels.Add(channel);
+            peaks.push_back(peak);
+            means.push_back(length > 0 ? sum / length : 0.0);
+            rms.push_back(length > 0 ? std::sqrt(sumSquares / length) : 0.0);
+        }
+
+        //A NaN among the values is skipped by the peak and carried by the mean and rms
+        channels.Add({1.0, -4.0, NaN, 2.0, 0.5, 3.0, -1.0, 2.0, 1.5, NaN});
+        peaks.push_back(4.0);
+        means.push_back(NaN);
+        rms.push_back(NaN);
+
+        int numChannels = channels.Size();
+        std::vector<double> values(numChannels);
+        int numFailed = 0;
+
+        EnvelopeKernels::Peak(channels.values.data(), channels.start.data(), numChannels, values.data());
+        numFailed += Check("peak", values, peaks, 0.0);
+        EnvelopeKernels::Mean(channels.values.data(), channels.start.data(), numChannels, values.data());
+        numFailed += Check("mean", values, means, 1e-12);
+        EnvelopeKernels::Rms(channels.values.data(), channels.start.data(), numChannels, values.data());
+        numFailed += Check("rms", values, rms, 1e-12);
+
+        return numFailed;
+    }
+}
+
+int main()
+{
+    int numFailed = CheckPercentiles() + CheckReductions();
+    return numFailed;
+}
@@ -1,6 +1,10 @@
 
 #include "OpenSeesPostprocessor.h"
+#include "OpenSeesRecorderGroups.h"
+#include "OpenSeesResponseBuffer.h"
 #include <jansson.h> 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <string>
@@ -13,8 +17,10 @@
 
 int main(int argc, char **argv)
 {
-  if (argc != 5) {
-    printf("ERROR %d: correct usage: postprocessOpenSees fileNameAIM fileNameSAM fileNameEVENT filenameEDP\n", argc);
+  // the responses are read from a binary buffer written by the analysis when
+  // one is given, see OpenSeesResponseBuffer.h
+  if (argc != 5 && !(argc == 7 && strcmp(argv[5],"--responseBuffer") == 0)) {
+    printf("ERROR %d: correct usage: postprocessOpenSees fileNameAIM fileNameSAM fileNameEVENT filenameEDP <--responseBuffer name>\n", argc);
     return -1;
   }
 
@@ -22,10 +28,11 @@ int main(int argc, char **argv)
   char *filenameSAM = argv[2];
   char *filenameEVENT = argv[3];
   char *filenameEDP = argv[4];
+  char *responseBuffer = (argc == 7) ? argv[6] : 0;
 
   OpenSeesPostprocessor thePostprocessor;
 
-  thePostprocessor.processResults(filenameAIM, filenameSAM, filenameEDP);
+  thePostprocessor.processResults(filenameAIM, filenameSAM, filenameEDP, responseBuffer);
 
   return 0;
 }
@@ -50,7 +57,8 @@ OpenSeesPostprocessor::~OpenSeesPostprocessor(){
 }
 
 int 
-OpenSeesPostprocessor::processResults(const char *AIM, const char *SAM, const char *EDP)
+OpenSeesPostprocessor::processResults(const char *AIM, const char *SAM, const char *EDP,
+				      const char *responseBufferName)
 {
   //
   // make copies of filenames in case methods need them
@@ -114,14 +122,144 @@ OpenSeesPostprocessor::processResults(const char *AIM, const char *SAM, const ch
     unitConversionFactorAcceleration = Units::GetAccelerationFactor(samUnits, bimUnits);    
   } 
 
-  processEDPs();
+  //
+  // if the analysis wrote its responses to a buffer they are only read from it,
+  // no recorder file is read, and results.out is written directly instead of
+  // EDP.json, so it is the one file the UQ engine gets the results from
+  //
+
+  if (responseBufferName != 0) {
+    if (!responseBuffer.open(responseBufferName)) {
+      fprintf(stderr, "OpenSeesPostprocessor: response buffer %s could not be read\n", responseBufferName);
+      std::cout<< "The OpenSees simulation was not successful";
+      exit(-1);
+    }
+    if (!responseBuffer.isComplete()) {
+      responseBuffer.close();
+      std::cout<< "The OpenSees simulation was not successful";
+      exit(-1);
+    }
+
+    processEDPs();
+    responseBuffer.close();
+
+    if (writeResults("results.out") != 0) {
+      fprintf(stderr, "OpenSeesPostprocessor: could not write results.out\n");
+      exit(-1);
+    }
+  } else {
+    processEDPs();
+    json_dump_file(rootEDP,filenameEDP,0);
+  }
 
-  json_dump_file(rootEDP,filenameEDP,0);
   json_object_clear(rootEDP);  
   return 0;
 }
 
 
+//
+// writes the scalar data of all the responses, in order, to a single line, the
+// responses, user specific responses and loads of each event as extractEDP does
+//
+
+int
+OpenSeesPostprocessor::writeResults(const char *fileName) {
+
+  string line;
+  char value[32];
+
+  json_t *edps = json_object_get(rootEDP,"EngineeringDemandParameters");  
+  int numEvents = json_array_size(edps);
+  for (int i=0; i<numEvents; i++) {
+    json_t *eventEDPs = json_array_get(edps,i);
+    for (const char *section : {"responses", "userSpecificResponses", "loads"}) {
+      json_t *eventEDP = json_object_get(eventEDPs,section);
+      int numResponses = json_array_size(eventEDP);
+      for (int k=0; k<numResponses; k++) {
+	json_t *data = json_object_get(json_array_get(eventEDP,k),"scalar_data");
+	if (json_is_array(data)) {
+	  int numData = json_array_size(data);
+	  for (int jj=0; jj<numData; jj++) {
+	    snprintf(value, sizeof(value), "%.17g ", json_number_value(json_array_get(data,jj)));
+	    line += value;
+	  }
+	} else if (json_is_number(data)) {
+	  snprintf(value, sizeof(value), "%.17g ", json_number_value(data));
+	  line += value;
+	}
+      }
+    }
+  }
+  if (!line.empty())
+    line.erase(line.size() - 1);
+
+  FILE *file = fopen(fileName, "wb");
+  if (file == NULL)
+    return -1;
+  fwrite(line.data(), 1, line.size(), file);
+  fclose(file);
+
+  return 0;
+}
+
+
+//
+// reads all the values written by a recorder, the file is read with a single
+// read and parsed in memory, returns false if the file can not be opened
+//
+
+static bool
+readRecorderFile(const char *fileName, vector<double> &values) {
+
+  values.clear();
+
+  FILE *file = fopen(fileName, "rb");
+  if (file == NULL)
+    return false;
+
+  string text;
+  char buffer[65536];
+  size_t numRead;
+  while ((numRead = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    text.append(buffer, numRead);
+  fclose(file);
+
+  const char *next = text.c_str();
+  char *end;
+  while (true) {
+    double value = strtod(next, &end);
+    if (end == next)
+      break;
+    values.push_back(value);
+    next = end;
+  }
+
+  return true;
+}
+
+
+//
+// points values at the responses the recorder would have written to fileName,
+// in the response buffer if one is open, otherwise they are read from the file
+// into storage, returns false if there are no responses
+//
+
+bool
+OpenSeesPostprocessor::readResponses(const string &fileName, vector<double> &storage,
+				     const double *&values, size_t &numValues) {
+
+  if (responseBuffer.isOpen())
+    return responseBuffer.find(fileName, values, numValues);
+
+  if (!readRecorderFile(fileName.c_str(), storage))
+    return false;
+
+  values = storage.data();
+  numValues = storage.size();
+  return true;
+}
+
+
 int 
 OpenSeesPostprocessor::processEDPs(){
 
@@ -159,159 +297,79 @@ OpenSeesPostprocessor::processEDPs(){
 
     json_t *eventEDP = json_object_get(eventEDPs,"responses");
     int numResponses = json_array_size(eventEDP);
+
+    //
+    // node responses are read from the recorder of their group, each recorder
+    // file is read once, when the first of its responses is processed
+    //
+
+    OpenSeesRecorderGroups recorderGroups;
+    vector<int> responseGroup(numResponses);
+    vector<int> responseColumn(numResponses);
+    for (int k=0; k<numResponses; k++)
+      responseGroup[k] = recorderGroups.addResponse(json_array_get(eventEDP, k), responseColumn[k]);
+
+    int numGroups = recorderGroups.getNumGroups();
+    vector<int> groupRead(numGroups, 0);   // 0 not read yet, 1 read, -1 no file
+    vector<vector<double> > groupStorage(numGroups);
+    vector<const double *> groupValues(numGroups);
+    vector<size_t> groupSize(numGroups, 0);
     
     for (int k=0; k<numResponses; k++) {
 
       json_t *response = json_array_get(eventEDP, k);
       const char *type = json_string_value(json_object_get(response, "type"));
+      int group = responseGroup[k];
+
+      if (group >= 0) {
 
-      if (strcmp(type,"max_abs_acceleration") == 0) {
-	const char * cline = json_string_value(json_object_get(response, "cline"));
-	const char * floor = json_string_value(json_object_get(response, "floor"));
+	// max_abs_acceleration, rms_acceleration and max_rel_disp
 	json_t *dofs = json_object_get(response, "dofs");
 	int numDOFs = json_array_size(dofs);
 
-	string fileString;
-	ostringstream temp;  //temp as in temporary
-	temp << filenameAIM << edpEventName << "." << type << "." << cline << "." << floor << ".out";
-	fileString=temp.str(); 
-	
-	const char *fileName = fileString.c_str();
-
-	//
-	// open file & process data into a json array called: data
-	//
-	
-	json_t *data = json_array();
-	
-	// open file
-	ifstream myfile;
-	myfile.open (fileName);
-
-	double tmp;
-	
-	if (myfile.is_open()) {
-
-	  if (myfile.peek() == std::ifstream::traits_type::eof()) {
-	    std::cout<< "The OpenSees simulation was not successful";
-	    exit(-1);
-  	}
-	  
-	  // read first 2 rows of useless data
-	  for (int ii=0; ii<2; ii++)
-	    for (int jj=0; jj<numDOFs; jj++) 
-	      myfile >> tmp;
-	  // read last row and add components to data
-	  for (int jj=0; jj<numDOFs; jj++) {
-	    myfile >> tmp;
-
-	    tmp *= unitConversionFactorAcceleration;
-	    
-	    json_array_append(data, json_real(tmp));
-	  }
-	  myfile.close();
+	if (groupRead[group] == 0) {
+	  string fileString = recorderGroups.getFileName(filenameAIM, edpEventName, group);
+	  if (readResponses(fileString, groupStorage[group], groupValues[group], groupSize[group])) {
+	    if (groupSize[group] == 0) {
+	      std::cout<< "The OpenSees simulation was not successful";
+	      exit(-1);
+	    }
+	    groupRead[group] = 1;
+	  } else
+	    groupRead[group] = -1;
 	}
-	
-	// set the response
-	json_object_set(response,"scalar_data",data);
-
-      }
 
-      else if (strcmp(type,"rms_acceleration") == 0) {
-	const char * cline = json_string_value(json_object_get(response, "cline"));
-	const char * floor = json_string_value(json_object_get(response, "floor"));
-	json_t *dofs = json_object_get(response, "dofs");
-	int numDOFs = json_array_size(dofs);
-
-	string fileString;
-	ostringstream temp;  //temp as in temporary
-	temp << filenameAIM << edpEventName << "." << type << "." << cline << "." << floor << ".out";
-	fileString=temp.str(); 
-	
-	const char *fileName = fileString.c_str();
-	
 	//
-	// open file & process data into a json array called: data
+	// process data into a json array called: data
 	//
-	
-	json_t *data = json_array();
-	
-	// open file
-	ifstream myfile;
-	myfile.open (fileName);
-	double tmp;
-	
-	if (myfile.is_open()) {
-
-	  if (myfile.peek() == std::ifstream::traits_type::eof()) {
-		    std::cout<< "The OpenSees simulation was not successful";
-		    exit(-1);
-	  }
-
-
-	  
-	  for (int jj=0; jj<numDOFs; jj++) {
-	    myfile >> tmp;
-	    tmp *= unitConversionFactorAcceleration;
-	    json_array_append(data, json_real(tmp));
-	  }
-	  myfile.close();
-	}
-	
-	// set the response
-	json_object_set(response,"scalar_data",data);
-	
-      } 
 
-      else if (strcmp(type,"max_rel_disp") == 0) {
-	const char * cline = json_string_value(json_object_get(response, "cline"));
-	const char * floor = json_string_value(json_object_get(response, "floor"));
-	json_t *dofs = json_object_get(response, "dofs");
-	int numDOFs = json_array_size(dofs);
-	
-	string fileString;
-	ostringstream temp;  //temp as in temporary
-	temp << filenameAIM << edpEventName << "." << type << "." << cline << "." << floor << ".out";
-	fileString=temp.str(); 
-	
-	const char *fileName = fileString.c_str();
-	
-	//
-	// opencfile & process data into a json array called: data
-				//
-	
 	json_t *data = json_array();
-	
-	// open file
-	ifstream myfile;
-	myfile.open (fileName);
-	double tmp;
-	
-	if (myfile.is_open()) {
 
+	if (groupRead[group] == 1) {
+
+	  // the envelope recorders write rows of min, max and max abs values, of which
+	  // the last is the response, the rms recorder writes a single row
+	  const double *values = groupValues[group];
+	  size_t numColumns = recorderGroups.getNodes(group).size() * numDOFs;
+	  size_t start = responseColumn[k];
+	  double factor = unitConversionFactorAcceleration;
+	  if (strcmp(type,"rms_acceleration") != 0)
+	    start += 2 * numColumns;
+	  if (strcmp(type,"max_rel_disp") == 0)
+	    factor = unitConversionFactorLength;
 
-	  if (myfile.peek() == std::ifstream::traits_type::eof()) {
-	    std::cout<< "The OpenSees simulation was not successful";
-	    exit(-1);
-  	}	
-	  
-	  // read first 2 rows of useless data
-	  for (int ii=0; ii<2; ii++)
-	    for (int jj=0; jj<numDOFs; jj++) 
-	      myfile >> tmp;
-	  // read last row and add components to data
 	  for (int jj=0; jj<numDOFs; jj++) {
-	    myfile >> tmp;
-	    tmp *= unitConversionFactorLength;
+	    double tmp = 0.0;
+	    if (start + jj < groupSize[group])
+	      tmp = values[start + jj];
+	    tmp *= factor;
 	    json_array_append(data, json_real(tmp));
 	  }
-	  myfile.close();
 	}
 	
 	// set the response
 	json_object_set(response,"scalar_data",data);
-	
-      } 
+      }
 
       else if ((strcmp(type,"max_drift") == 0) || 
 	       (strcmp(type,"max_roof_drift") == 0)) {
@@ -331,23 +389,20 @@ OpenSeesPostprocessor::processEDPs(){
 	  temp1 << filenameAIM << edpEventName << "." << type << "." << cline << "." << floor1 << "." << floor2 << "." << dof << ".out";
 	  fileString1=temp1.str(); 
 	  
-	  const char *fileName1 = fileString1.c_str();	
-	  
-	  // openfile & process data
-	  ifstream myfile;
-	  myfile.open (fileName1);
-	  double absMin, absMax, absValue;
-	  
-	  absValue = 0.0;
-	  if (myfile.is_open()) {
-
-		  if (myfile.peek() == std::ifstream::traits_type::eof()) {
-			    std::cout<< "The OpenSees simulation was not successful";
-			    exit(-1);
-		  }
-	  	
-	    myfile >> absMin >> absMax >> absValue;
-	    myfile.close();
+	  // openfile & process data, the file holds the min, max and max abs drift
+	  vector<double> storage;
+	  const double *values;
+	  size_t numValues;
+	  double absValue = 0.0;
+	  if (readResponses(fileString1, storage, values, numValues)) {
+
+	    if (numValues == 0) {
+	      std::cout<< "The OpenSees simulation was not successful";
+	      exit(-1);
+	    }
+
+	    if (numValues >= 3)
+	      absValue = values[2];
 	  } 
 	  json_array_append(data, json_real(absValue));
 	}
@@ -2,6 +2,9 @@
 #define OPENSEES_POSTPROCESSOR_H
 class json_t;
 #include <fstream>
+#include <string>
+#include <vector>
+#include "OpenSeesResponseBuffer.h"
 using namespace::std;
 
 class OpenSeesPostprocessor {
@@ -10,10 +13,18 @@ class OpenSeesPostprocessor {
   OpenSeesPostprocessor();
   ~OpenSeesPostprocessor();
 
-  int processResults(const char *AIM, const char *SAM, const char *EDP);
+  int processResults(const char *AIM, const char *SAM, const char *EDP,
+		     const char *responseBuffer = 0);
 
   int processEDPs();
 
+  // writes the scalar data of the EDPs to the results file read by the UQ engine
+  int writeResults(const char *fileName);
+
+ private:
+  bool readResponses(const string &fileName, vector<double> &storage,
+		     const double *&values, size_t &numValues);
+
  private:
   char *filenameEDP;
   char *filenameAIM;
@@ -26,6 +37,8 @@ class OpenSeesPostprocessor {
   double unitConversionFactorLength;
   double unitConversionFactorForce;
   double unitConversionFactorAcceleration;
+
+  OpenSeesResponseBuffer responseBuffer;
 };
 
 #endif // OPENSEES_POSTPROCESSOR_H
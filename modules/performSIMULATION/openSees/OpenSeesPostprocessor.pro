@@ -4,7 +4,7 @@ CONFIG -= debug_and_release
 
 OBJECTS_DIR = $${OUT_PWD}/obj
 
-SOURCES += OpenSeesPostprocessor.cpp
+SOURCES += OpenSeesPostprocessor.cpp OpenSeesRecorderGroups.cpp OpenSeesResponseBuffer.cpp
 
 macx{
     CONFIG-=app_bundle
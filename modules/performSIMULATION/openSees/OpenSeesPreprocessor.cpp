@@ -1,10 +1,14 @@
 #include "OpenSeesPreprocessor.h"
+#include "OpenSeesRecorderGroups.h"
 #include "iostream"
 #include <jansson.h> 
 #include <string.h>
 #include <string>
 #include <sstream>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
 #include <vector>
 
 #include "common/Units.h"
@@ -12,7 +16,8 @@
 OpenSeesPreprocessor::OpenSeesPreprocessor()
   :rootAIM(0), rootSAM(0), rootEVENT(0), rootEDP(0), rootSIM(0), 
    fileAIM(0), fileSAM(0), fileEVENT(0), fileEDP(0), fileSIM(0),
-   analysisType(-1), numSteps(0), dT(0.0), nStory(0), mapping(0)
+   analysisType(-1), numSteps(0), dT(0.0), nStory(0), mapping(0),
+   useTimeSeriesFiles(false), timeSeriesDirectory(".")
 {
   dampingRatio = -1.0;
 }
@@ -135,6 +140,20 @@ OpenSeesPreprocessor::createInputFile(const char *AIM,
     return -1;
   }
 
+  // index the mapping once, getNode is called for every recorder and pattern,
+  // if a cline and floor is repeated the first entry is used as before
+  int numMapObjects = json_array_size(mapping);
+  nodeMap.reserve(numMapObjects);
+  for (int i=0; i<numMapObjects; i++) {
+    json_t *mapObject = json_array_get(mapping, i);
+    const char *c = json_string_value(json_object_get(mapObject,"cline"));
+    const char *f = json_string_value(json_object_get(mapObject,"floor"));
+    if (c != NULL && f != NULL) {
+      string key = string(c) + '\n' + f;
+      nodeMap.emplace(key, json_integer_value(json_object_get(mapObject,"node")));
+    }
+  }
+
   if (processedSAM == false) {
     // a regular SAM file, create node elements and materials as normal
     processNodes(tclFile);
@@ -148,6 +167,16 @@ OpenSeesPreprocessor::createInputFile(const char *AIM,
   // do not prescribe damping for custom analysis scripts
   json_t *fileScript = json_object_get(rootSIM,"fileName");
 
+  // optionally write the time series to files instead of inline in the script,
+  // the directory may be shared by the samples so unchanged series are written once
+  json_t *seriesFiles = json_object_get(rootSIM,"timeSeriesFiles");
+  if (seriesFiles != NULL && json_is_true(seriesFiles)) {
+    useTimeSeriesFiles = true;
+    json_t *seriesDirectory = json_object_get(rootSIM,"timeSeriesDirectory");
+    if (seriesDirectory != NULL)
+      timeSeriesDirectory = json_string_value(seriesDirectory);
+  }
+
   // 
   // process events
   //   - creates events and does analysis
@@ -699,6 +728,8 @@ OpenSeesPreprocessor::processEvents(ofstream &s){
 
 
       if (eventEDP != NULL) {
+
+	OpenSeesRecorderGroups recorderGroups;
       
 	int numResponses = json_array_size(eventEDP);
 	// std::cerr << "numResponse: " << numResponses <<"\n";	
@@ -709,111 +740,19 @@ OpenSeesPreprocessor::processEvents(ofstream &s){
 
 	  // std::cerr << "type: " << type <<"\n";
 
-	  if (strcmp(type,"max_abs_acceleration") == 0) {
-	    
-	    const char *cline = json_string_value(json_object_get(response, "cline"));
-	    const char *floor = json_string_value(json_object_get(response, "floor"));
-	    
-	    int nodeTag = this->getNode(cline,floor);	    
-	    
-	    json_t *theDOFs = json_object_get(response, "dofs");
-	    int sizeDOFs = json_array_size(theDOFs);
-	    int *dof = new int[sizeDOFs];
-	    for (int ii=0; ii<sizeDOFs; ii++)
-	      dof[ii] = json_integer_value(json_array_get(theDOFs,ii));
-
-	    string fileString;
-	    ostringstream temp;  //temp as in temporary
-
-	    temp << fileAIM << edpEventName << "." << type << "." << cline << "." << floor << ".out";
-	    // temp << edpEventName << "." << type << "." << cline << "." << floor << ".out";
- 
-	    fileString=temp.str(); 
-
-	    const char *fileName = fileString.c_str();
-
-	    int startTimeSeries = 101;
-	    s << "recorder EnvelopeNode -file " << fileName;
-	    if (seismicEventType == true) {
-	      s << " -timeSeries ";
-	      for (int ii=0; ii<sizeDOFs; ii++)
-		s << ii+startTimeSeries << " " ;
-	    }
-	    s << " -node " << nodeTag << " -dof ";
-	    for (int ii=0; ii<sizeDOFs; ii++)
-	      s << dof[ii] << " " ;
-	    s << " accel\n";
+	  // node responses are recorded with the other responses of their group below
+	  int column;
 
-	    delete [] dof;
+	  if (strcmp(type,"max_abs_acceleration") == 0) {
+	    recorderGroups.addResponse(response, column);
 	  }
 
 	  if (strcmp(type,"rms_acceleration") == 0) {
-	    
-	    const char *cline = json_string_value(json_object_get(response, "cline"));
-	    const char *floor = json_string_value(json_object_get(response, "floor"));
-	    
-	    int nodeTag = this->getNode(cline,floor);	    
-	    
-	    json_t *theDOFs = json_object_get(response, "dofs");
-	    int sizeDOFs = json_array_size(theDOFs);
-	    int *dof = new int[sizeDOFs];
-	    for (int ii=0; ii<sizeDOFs; ii++)
-	      dof[ii] = json_integer_value(json_array_get(theDOFs,ii));
-
-	    string fileString;
-	    ostringstream temp;  //temp as in temporary
-
-	    temp << fileAIM << edpEventName << "." << type << "." << cline << "." << floor << ".out";
-
-	    fileString=temp.str(); 
-
-	    const char *fileName = fileString.c_str();
-
-	    int startTimeSeries = 101;
-	    s << "recorder NodeRMS -file " << fileName;
-	    if (seismicEventType == true) {
-	      s << " -timeSeries ";
-	      for (int ii=0; ii<sizeDOFs; ii++)
-		s << ii+startTimeSeries << " " ;
-	    }
-	    s << " -node " << nodeTag << " -dof ";
-	    for (int ii=0; ii<sizeDOFs; ii++)
-	      s << dof[ii] << " " ;
-	    s << " accel\n";
-
-	    delete [] dof;
+	    recorderGroups.addResponse(response, column);
 	  }
 
 	  else if (strcmp(type,"max_rel_disp") == 0) {
-
-	    const char *cline = json_string_value(json_object_get(response, "cline"));
-	    const char *floor = json_string_value(json_object_get(response, "floor"));
-
-	    int nodeTag = this->getNode(cline,floor);	    
-
-	    json_t *theDOFs = json_object_get(response, "dofs");
-	    int sizeDOFs = json_array_size(theDOFs);
-	    int *dof = new int[sizeDOFs];
-	    for (int ii=0; ii<sizeDOFs; ii++)
-	      dof[ii] = json_integer_value(json_array_get(theDOFs,ii));
-
-	    string fileString;
-	    ostringstream temp;  //temp as in temporary
-
-	    temp << fileAIM << edpEventName << "." << type << "." << cline << "." << floor << ".out";
-
-	    fileString=temp.str(); 
-
-	    const char *fileName = fileString.c_str();
-
-	    int startTimeSeries = 101;
-	    s << "recorder EnvelopeNode -file " << fileName;
-	    s << " -node " << nodeTag << " -dof ";
-	    for (int ii=0; ii<sizeDOFs; ii++)
-	      s << dof[ii] << " " ;
-	    s << " disp\n";
-
-	    delete [] dof;
+	    recorderGroups.addResponse(response, column);
 	  }
     
     else if ((strcmp(type,"max_drift") == 0) || 
@@ -883,6 +822,43 @@ OpenSeesPreprocessor::processEvents(ofstream &s){
 	    edpList.push_back(newEDP);
 	  }
 	}
+
+	//
+	// one recorder for each group of node responses, with the nodes of the group
+	// in the order of their columns
+	//
+
+	for (int g=0; g<recorderGroups.getNumGroups(); g++) {
+
+	  const string &type = recorderGroups.getType(g);
+	  const vector<int> &dof = recorderGroups.getDOFs(g);
+	  const vector<pair<string,string> > &nodes = recorderGroups.getNodes(g);
+	  int sizeDOFs = dof.size();
+
+	  string fileString = recorderGroups.getFileName(fileAIM, edpEventName, g);
+	  const char *fileName = fileString.c_str();
+
+	  int startTimeSeries = 101;
+	  if (type == "rms_acceleration")
+	    s << "recorder NodeRMS -file " << fileName;
+	  else
+	    s << "recorder EnvelopeNode -file " << fileName;
+	  if (type != "max_rel_disp" && seismicEventType == true) {
+	    s << " -timeSeries ";
+	    for (int ii=0; ii<sizeDOFs; ii++)
+	      s << ii+startTimeSeries << " " ;
+	  }
+	  s << " -node ";
+	  for (size_t jj=0; jj<nodes.size(); jj++)
+	    s << this->getNode(nodes[jj].first.c_str(), nodes[jj].second.c_str()) << " ";
+	  s << " -dof ";
+	  for (int ii=0; ii<sizeDOFs; ii++)
+	    s << dof[ii] << " " ;
+	  if (type == "max_rel_disp")
+	    s << " disp\n";
+	  else
+	    s << " accel\n";
+	}
       }
     }
    
@@ -1202,8 +1178,6 @@ OpenSeesPreprocessor::processEvent(ofstream &s,
 	  s << "timeSeries Path " << numSeries << " -dt " << dt << " -factor [expr " << seriesFactor << " ] ";
 	}
 	
-	s << " -values { ";	
-
 	json_t *dataV;
 	int dataIndex;
 
@@ -1211,6 +1185,7 @@ OpenSeesPreprocessor::processEvent(ofstream &s,
 	// write data to file, multiply it by conversion factor and eventFactor
 	//
 
+	ostringstream values;
 	int count = 0;
 	double val0 = 0.0;
 	json_array_foreach(data, dataIndex, dataV) {
@@ -1221,12 +1196,19 @@ OpenSeesPreprocessor::processEvent(ofstream &s,
 	    val0 = valCount;
 	    count++;
 	  }
-	  s << valCount-val0 << " " ;
+	  values << valCount-val0 << " " ;
 	  */
-	  s << valCount << " " ;
+	  values << valCount << " " ;
 	}
 
-	s << " }\n";
+	// the values are written with the same precision either way, so the
+	// analysis does not depend on where OpenSees reads them from
+	string valuesText = values.str();
+	string seriesFile;
+	if (useTimeSeriesFiles && writeTimeSeriesFile(valuesText, seriesFile) == 0)
+	  s << " -filePath \"" << seriesFile << "\"\n";
+	else
+	  s << " -values { " << valuesText << " }\n";
 	
 	string name(json_string_value(json_object_get(timeSeries,"name")));
 	
@@ -1329,20 +1311,60 @@ OpenSeesPreprocessor::processEvent(ofstream &s,
 int
 OpenSeesPreprocessor:: getNode(const char * cline,const char * floor){
 
-  int numMapObjects = json_array_size(mapping);
-  for (int i=0; i<numMapObjects; i++) {
-    json_t *mapObject = json_array_get(mapping, i); 
-    const char *c = json_string_value(json_object_get(mapObject,"cline"));
-    if (strcmp(c, cline) == 0) {
-      const char * f = json_string_value(json_object_get(mapObject,"floor"));
-      if (strcmp(f,floor) == 0) {
-	int node = json_integer_value(json_object_get(mapObject,"node"));
-	//	printf("cline : %s floor %s node %d\n",cline, floor, node);
-	return json_integer_value(json_object_get(mapObject,"node"));
-      }
+  auto it = nodeMap.find(string(cline) + '\n' + floor);
+  if (it != nodeMap.end())
+    return it->second;
+  return -1;
+}
+
+int
+OpenSeesPreprocessor::writeTimeSeriesFile(const string &values, string &fileName) {
+
+  // name the file after a 64 bit FNV-1a hash of the values
+  uint64_t key = 14695981039346656037ULL;
+  for (size_t i=0; i<values.size(); i++) {
+    key ^= (unsigned char)values[i];
+    key *= 1099511628211ULL;
+  }
+
+  char keyString[20];
+  snprintf(keyString, sizeof(keyString), "%016llx", (unsigned long long)key);
+  fileName = timeSeriesDirectory + "/TimeSeries." + keyString + ".txt";
+
+  // reuse the file if an earlier sample has written it
+  ifstream existing(fileName.c_str(), ios::in | ios::binary | ios::ate);
+  if (existing.is_open() && (size_t)existing.tellg() == values.size())
+    return 0;
+  existing.close();
+
+  // write to a temporary file first, so samples running at the same time
+  // never read a partly written file
+  std::random_device seed;
+  string tmpName = fileName + "." + std::to_string(seed()) + ".tmp";
+  ofstream out(tmpName.c_str(), ios::out | ios::binary);
+  if (!out.is_open()) {
+    std::cerr << "OpenSeesPreprocessor - could not write " << tmpName << ", time series written to script\n";
+    return -1;
+  }
+  out << values;
+  out.close();
+  if (!out) {
+    remove(tmpName.c_str());
+    std::cerr << "OpenSeesPreprocessor - could not write " << tmpName << ", time series written to script\n";
+    return -1;
+  }
+
+  if (rename(tmpName.c_str(), fileName.c_str()) != 0) {
+    // another sample may have written the file in the meantime
+    remove(tmpName.c_str());
+    ifstream written(fileName.c_str(), ios::in | ios::binary | ios::ate);
+    if (!written.is_open() || (size_t)written.tellg() != values.size()) {
+      std::cerr << "OpenSeesPreprocessor - could not write " << fileName << ", time series written to script\n";
+      return -1;
     }
   }
-  return -1;
+
+  return 0;
 }
 
 
@@ -4,6 +4,7 @@ class json_t;
 #include <fstream>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 using namespace::std;
 
@@ -38,6 +39,10 @@ class OpenSeesPreprocessor {
 
   int getNode(const char *cline, const char *floor);
 
+  // writes the values of a time series to a file named after its contents, the file
+  // is reused if it already exists, returns 0 and the file name if successful
+  int writeTimeSeriesFile(const string &values, string &fileName);
+
  private:
   const char *fileAIM;
   const char *fileSAM;
@@ -51,6 +56,8 @@ class OpenSeesPreprocessor {
   json_t *rootEDP;
   json_t *rootEVENT;
   json_t *mapping;
+  // node of each cline and floor in the mapping, keyed by cline + '\n' + floor
+  std::unordered_map<string,int> nodeMap;
 
   int analysisType;
   int numSteps;
@@ -62,6 +69,10 @@ class OpenSeesPreprocessor {
   int NDM;
   int NDF;
   int numStories;
+
+  // write the values of the time series to files read with -filePath
+  bool useTimeSeriesFiles;
+  string timeSeriesDirectory;
 };
 
 #endif // OPENSEES_PREPROCESSOR_H
@@ -5,6 +5,7 @@ CONFIG -= debug_and_release
 OBJECTS_DIR = $${OUT_PWD}/obj
 
 SOURCES += OpenSeesPreprocessor.cpp \
+           OpenSeesRecorderGroups.cpp \
            $$PWD/../../common/Units.cpp
 
 INCLUDEPATH += $$PWD/../../common
@@ -0,0 +1,89 @@
+#include "OpenSeesRecorderGroups.h"
+#include <jansson.h>
+#include <string.h>
+#include <sstream>
+
+int
+OpenSeesRecorderGroups::addResponse(json_t *response, int &column) {
+
+  const char *type = json_string_value(json_object_get(response, "type"));
+  if (type == NULL ||
+      (strcmp(type,"max_abs_acceleration") != 0 &&
+       strcmp(type,"rms_acceleration") != 0 &&
+       strcmp(type,"max_rel_disp") != 0))
+    return -1;
+
+  const char *cline = json_string_value(json_object_get(response, "cline"));
+  const char *floor = json_string_value(json_object_get(response, "floor"));
+  if (cline == NULL || floor == NULL)
+    return -1;
+
+  // group by type and dofs
+  json_t *theDOFs = json_object_get(response, "dofs");
+  int sizeDOFs = json_array_size(theDOFs);
+  vector<int> dofs(sizeDOFs);
+  ostringstream key;
+  key << type;
+  for (int ii=0; ii<sizeDOFs; ii++) {
+    dofs[ii] = json_integer_value(json_array_get(theDOFs,ii));
+    key << "_" << dofs[ii];
+  }
+
+  int group;
+  map<string,int>::iterator it = groupIndex.find(key.str());
+  if (it != groupIndex.end()) {
+    group = it->second;
+  } else {
+    group = groups.size();
+    groupIndex[key.str()] = group;
+    groups.push_back(Group());
+    groups[group].type = type;
+    groups[group].dofs = dofs;
+  }
+
+  // a node asked for more than once is recorded once
+  Group &theGroup = groups[group];
+  pair<string,string> node(cline, floor);
+  map<pair<string,string>,int>::iterator nodeIt = theGroup.nodeColumns.find(node);
+  if (nodeIt != theGroup.nodeColumns.end()) {
+    column = nodeIt->second;
+  } else {
+    column = theGroup.nodes.size() * sizeDOFs;
+    theGroup.nodeColumns[node] = column;
+    theGroup.nodes.push_back(node);
+  }
+
+  return group;
+}
+
+int
+OpenSeesRecorderGroups::getNumGroups(void) const {
+  return groups.size();
+}
+
+const string &
+OpenSeesRecorderGroups::getType(int group) const {
+  return groups[group].type;
+}
+
+const vector<int> &
+OpenSeesRecorderGroups::getDOFs(int group) const {
+  return groups[group].dofs;
+}
+
+const vector<pair<string,string> > &
+OpenSeesRecorderGroups::getNodes(int group) const {
+  return groups[group].nodes;
+}
+
+string
+OpenSeesRecorderGroups::getFileName(const char *fileAIM, const char *edpEventName, int group) const {
+
+  ostringstream temp;
+  temp << fileAIM << edpEventName << "." << groups[group].type << ".dofs";
+  for (size_t ii=0; ii<groups[group].dofs.size(); ii++)
+    temp << "_" << groups[group].dofs[ii];
+  temp << ".out";
+
+  return temp.str();
+}
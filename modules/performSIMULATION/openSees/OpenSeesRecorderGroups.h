@@ -0,0 +1,44 @@
+#ifndef OPENSEES_RECORDER_GROUPS_H
+#define OPENSEES_RECORDER_GROUPS_H
+class json_t;
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace::std;
+
+// The node responses of an EDP set that are read from the same kind of recorder
+// for the same dofs share one recorder, with a column per node and dof. The
+// preprocessor and postprocessor both add the responses of the set in order, so
+// they agree on the recorders, their files and the columns of each response.
+
+class OpenSeesRecorderGroups {
+
+ public:
+  // adds a max_abs_acceleration, rms_acceleration or max_rel_disp response and
+  // returns its group, with column set to the column of its first dof, returns
+  // -1 for the other responses
+  int addResponse(json_t *response, int &column);
+
+  int getNumGroups(void) const;
+  const string &getType(int group) const;
+  const vector<int> &getDOFs(int group) const;
+  // cline and floor of the nodes of the group, in the order of their columns
+  const vector<pair<string,string> > &getNodes(int group) const;
+  // output file of the group for the EDP set
+  string getFileName(const char *fileAIM, const char *edpEventName, int group) const;
+
+ private:
+  struct Group {
+    string type;
+    vector<int> dofs;
+    vector<pair<string,string> > nodes;
+    map<pair<string,string>,int> nodeColumns;
+  };
+
+  vector<Group> groups;
+  map<string,int> groupIndex;
+};
+
+#endif // OPENSEES_RECORDER_GROUPS_H
@@ -0,0 +1,177 @@
+#include "OpenSeesResponseBuffer.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+OpenSeesResponseBuffer::OpenSeesResponseBuffer()
+  :data(0), size(0), mapped(false),
+   header(0), segments(0), names(0), values(0)
+{
+
+}
+
+OpenSeesResponseBuffer::~OpenSeesResponseBuffer() {
+  close();
+}
+
+bool
+OpenSeesResponseBuffer::open(const char *name) {
+
+  close();
+
+  string theName(name);
+  bool shm = (theName.compare(0, 4, "shm:") == 0);
+
+#ifndef _WIN32
+
+  int fd;
+  if (shm) {
+    shmName = theName.substr(4);
+    if (shmName.empty() || shmName[0] != '/')
+      shmName = "/" + shmName;
+    fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+  } else
+    fd = ::open(name, O_RDONLY);
+
+  if (fd < 0) {
+    shmName.clear();
+    return false;
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+    void *theData = mmap(0, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (theData != MAP_FAILED) {
+      data = (const char *)theData;
+      size = fileStat.st_size;
+      mapped = true;
+    }
+  }
+  ::close(fd);
+
+#else
+
+  // no shared memory, the file is read in one go
+  if (!shm) {
+    FILE *file = fopen(name, "rb");
+    if (file != NULL) {
+      char buffer[65536];
+      size_t numRead;
+      while ((numRead = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        fileData.insert(fileData.end(), buffer, buffer + numRead);
+      fclose(file);
+      data = fileData.data();
+      size = fileData.size();
+    }
+  }
+
+#endif
+
+  if (data == 0) {
+    close();
+    return false;
+  }
+
+  //
+  // check the header and that the segments, names and values lie in the buffer
+  //
+
+  if (size < sizeof(OpenSeesResponseBufferHeader)) {
+    close();
+    return false;
+  }
+
+  header = (const OpenSeesResponseBufferHeader *)data;
+  if (memcmp(header->magic, "SCEDPBUF", 8) != 0 || header->version != 1) {
+    close();
+    return false;
+  }
+
+  uint64_t available = size - sizeof(OpenSeesResponseBufferHeader);
+  uint64_t numSegments = header->numSegments;
+  uint64_t namesSize = header->namesSize;
+  uint64_t numValues = header->numValues;
+  if (numSegments > available / sizeof(OpenSeesResponseBufferSegment)) {
+    close();
+    return false;
+  }
+  available -= numSegments * sizeof(OpenSeesResponseBufferSegment);
+
+  uint64_t paddedNamesSize = (namesSize + 7) / 8 * 8;
+  if (namesSize > available || paddedNamesSize > available ||
+      numValues > (available - paddedNamesSize) / sizeof(double)) {
+    close();
+    return false;
+  }
+
+  segments = (const OpenSeesResponseBufferSegment *)(data + sizeof(OpenSeesResponseBufferHeader));
+  names = (const char *)(segments + numSegments);
+  values = (const double *)(names + paddedNamesSize);
+
+  segmentIndex.reserve(numSegments);
+  for (uint64_t i=0; i<numSegments; i++) {
+    const OpenSeesResponseBufferSegment &segment = segments[i];
+    if (segment.nameOffset > namesSize || segment.nameLength > namesSize - segment.nameOffset ||
+        segment.valueOffset > numValues || segment.numValues > numValues - segment.valueOffset) {
+      close();
+      return false;
+    }
+    segmentIndex.emplace(string(names + segment.nameOffset, segment.nameLength), i);
+  }
+
+  return true;
+}
+
+void
+OpenSeesResponseBuffer::close(void) {
+
+#ifndef _WIN32
+  if (mapped)
+    munmap((void *)data, size);
+
+  // the analysis that wrote the segment is done with it
+  if (!shmName.empty() && values != 0)
+    shm_unlink(shmName.c_str());
+#endif
+
+  data = 0;
+  size = 0;
+  mapped = false;
+  shmName.clear();
+  fileData.clear();
+
+  header = 0;
+  segments = 0;
+  names = 0;
+  values = 0;
+  segmentIndex.clear();
+}
+
+bool
+OpenSeesResponseBuffer::isOpen(void) const {
+  return header != 0;
+}
+
+bool
+OpenSeesResponseBuffer::isComplete(void) const {
+  return header != 0 && header->complete == 1;
+}
+
+bool
+OpenSeesResponseBuffer::find(const string &fileName, const double *&theValues, size_t &numValues) const {
+
+  unordered_map<string,size_t>::const_iterator it = segmentIndex.find(fileName);
+  if (it == segmentIndex.end())
+    return false;
+
+  const OpenSeesResponseBufferSegment &segment = segments[it->second];
+  theValues = values + segment.valueOffset;
+  numValues = segment.numValues;
+  return true;
+}
@@ -0,0 +1,76 @@
+#ifndef OPENSEES_RESPONSE_BUFFER_H
+#define OPENSEES_RESPONSE_BUFFER_H
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace::std;
+
+// An analysis can hand its envelope and rms responses to the postprocessor in a
+// binary buffer instead of recorder text files. The buffer is a file, or a POSIX
+// shared memory segment when its name starts with "shm:", and holds in native
+// byte order
+//
+//   header     OpenSeesResponseBufferHeader
+//   segments   numSegments OpenSeesResponseBufferSegment
+//   names      namesSize bytes, padded to a multiple of 8
+//   values     numValues doubles
+//
+// Each segment holds the values a recorder would have written to its file, in the
+// same order, and is named after that file, e.g. AIM.json0.max_rel_disp.dofs_1.out
+// for an envelope with rows of min, max and max abs values. The producer sets
+// complete to 1 once all values are written, a buffer that is not complete is
+// taken as a failed analysis. A shared memory segment is removed once it has
+// been read.
+
+struct OpenSeesResponseBufferHeader {
+  char magic[8];            // "SCEDPBUF"
+  uint32_t version;         // 1
+  uint32_t complete;
+  uint64_t numSegments;
+  uint64_t namesSize;
+  uint64_t numValues;
+};
+
+struct OpenSeesResponseBufferSegment {
+  uint64_t nameOffset;      // into the names
+  uint64_t nameLength;
+  uint64_t valueOffset;     // into the values
+  uint64_t numValues;
+};
+
+class OpenSeesResponseBuffer {
+
+ public:
+  OpenSeesResponseBuffer();
+  ~OpenSeesResponseBuffer();
+
+  // maps the buffer read only, returns false if it does not exist or its header
+  // and segments are not valid, the buffer is then not used
+  bool open(const char *name);
+  void close(void);
+
+  bool isOpen(void) const;
+  bool isComplete(void) const;
+
+  // points values at the values of the segment named fileName, without copying
+  // them, returns false if the buffer has no such segment
+  bool find(const string &fileName, const double *&values, size_t &numValues) const;
+
+ private:
+  const char *data;
+  size_t size;
+  bool mapped;
+  string shmName;
+  vector<char> fileData;    // where mapping is not available
+
+  const OpenSeesResponseBufferHeader *header;
+  const OpenSeesResponseBufferSegment *segments;
+  const char *names;
+  const double *values;
+  unordered_map<string,size_t> segmentIndex;
+};
+
+#endif // OPENSEES_RESPONSE_BUFFER_H
@@ -170,8 +170,15 @@ def main(args):  # noqa: D103
 
 
 
-        # Run postprocessor
-        postprocessorCommand = f'"{scriptDir}/OpenSeesPostprocessor" {aimName} {samName} {evtName} {edpName}  >> workflow.err 2>&1'  # noqa: N806
+        # Run postprocessor, reading the responses from the buffer the analysis
+        # wrote them to if the SIM file names one
+        responseBuffer = ''  # noqa: N806
+        if os.path.isfile(simName):  # noqa: PTH113
+            with open(simName, 'r') as simFile:  # noqa: PTH123
+                simData = json.load(simFile)  # noqa: N806
+            if simData.get('responseBuffer'):
+                responseBuffer = f' --responseBuffer "{simData["responseBuffer"]}"'  # noqa: N806
+        postprocessorCommand = f'"{scriptDir}/OpenSeesPostprocessor" {aimName} {samName} {evtName} {edpName}{responseBuffer}  >> workflow.err 2>&1'  # noqa: N806
         exit_code = subprocess.Popen(postprocessorCommand, shell=True).wait()  # noqa: S602, F841
         # exit_code = subprocess.run(postprocessorCommand, shell=True).returncode # Maybe better for compatibility - jb
         # if not exit_code==0:
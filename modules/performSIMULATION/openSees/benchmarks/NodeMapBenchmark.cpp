@@ -0,0 +1,184 @@
+// Benchmark of the node mapping lookup of OpenSeesPreprocessor
+//
+// For each model size a shear frame with the given numbers of storeys and column lines is written to a
+// temporary folder: its SAM NodeMapping, an EDP file with acceleration, displacement and drift responses
+// at every cline and floor, a short EVENT and the AIM and SIM files. Every OpenSeesPreprocessor given is
+// run on it, getNode being called for every response, and the wall time per run is reported. Pass builds
+// from before and after a change to compare them, the scripts they write are checked to be identical to
+// the one of the first preprocessor, a run writing another script is reported as an error.
+//
+// Usage: NodeMapBenchmark [Google Benchmark options] <path to OpenSeesPreprocessor> [more ...]
+
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+// Google Benchmark
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    void WriteFile(const std::string &fileName, const std::string &text)
+    {
+        std::ofstream out(fileName);
+        out << text;
+    }
+
+    std::string Response(const std::string &type, int cline, const std::string &floors)
+    {
+        return "{\"type\":\"" + type + "\",\"cline\":\"" + std::to_string(cline) + "\"," + floors +
+               ",\"dofs\":[1,2]}";
+    }
+
+    // Writes AIM, SAM, EVENT, EDP and SIM files of a frame with numStories storeys and numClines clines
+    void WriteInputs(const std::string &dir, int numStories, int numClines)
+    {
+        const int numSteps = 1000;
+        const std::string units = "{\"length\":\"m\",\"force\":\"kN\",\"time\":\"sec\"}";
+
+        std::ostringstream nodes, elements, mapping, responses;
+        int tag = 1;
+        for (int c = 1; c <= numClines; c++)
+        {
+            for (int f = 0; f <= numStories; f++, tag++)
+            {
+                std::string floor = "\"floor\":\"" + std::to_string(f) + "\"";
+                nodes << (tag > 1 ? "," : "") << "{\"name\":" << tag << ",\"crd\":[" << c << "," << 3 * f
+                      << "],\"ndf\":3,\"mass\":1.0" << (f == 0 ? ",\"constraints\":[1,1,1]}" : "}");
+                mapping << (tag > 1 ? "," : "") << "{\"cline\":\"" << c << "\"," << floor << ",\"node\":" << tag
+                        << "}";
+                if (f > 0)
+                    elements << (elements.tellp() > 0 ? "," : "") << "{\"name\":" << tag
+                             << ",\"type\":\"shear_beam2d\",\"nodes\":[" << tag - 1 << "," << tag
+                             << "],\"uniaxial_material\":1}";
+
+                responses << (tag > 1 ? "," : "") << Response("max_abs_acceleration", c, floor) << ","
+                          << Response("rms_acceleration", c, floor) << "," << Response("max_rel_disp", c, floor)
+                          << "," << Response("residual_disp", c, floor);
+                if (f > 0)
+                    responses << "," << Response("max_drift", c, "\"floor1\":\"" + std::to_string(f - 1) +
+                                                                  "\",\"floor2\":\"" + std::to_string(f) + "\"");
+            }
+        }
+        for (int f = 0; f <= numStories; f++)
+        {
+            for (const char *cline : {"centroid", "response"})
+                mapping << ",{\"cline\":\"" << cline << "\",\"floor\":\"" << f << "\",\"node\":" << f + 1 << "}";
+        }
+
+        WriteFile(dir + "/SAM.json",
+                  "{\"units\":" + units + ",\"NodeMapping\":[" + mapping.str() + "],\"numStory\":" +
+                  std::to_string(numStories) + ",\"Properties\":{\"dampingRatio\":0.02,\"uniaxialMaterials\":"
+                  "[{\"name\":1,\"type\":\"elastic\",\"K\":1e5}]},\"Geometry\":{\"nodes\":[" + nodes.str() +
+                  "],\"elements\":[" + elements.str() + "]}}");
+        WriteFile(dir + "/AIM.json", "{\"GeneralInformation\":{\"NumberOfStories\":" + std::to_string(numStories) +
+                                     ",\"units\":" + units + "}}");
+
+        std::ostringstream data;
+        for (int i = 0; i < numSteps; i++)
+            data << (i > 0 ? "," : "") << 0.3 * std::sin(0.01 * i);
+        WriteFile(dir + "/EVENT.json",
+                  "{\"randomVariables\":[],\"Events\":[{\"name\":\"ev\",\"type\":\"Seismic\",\"dT\":0.01,"
+                  "\"numSteps\":" + std::to_string(numSteps) + ",\"units\":{\"length\":\"m\",\"time\":\"sec\"},"
+                  "\"timeSeries\":[{\"name\":\"accel_x\",\"type\":\"Value\",\"dT\":0.01,\"factor\":1.0,"
+                  "\"data\":[" + data.str() + "]}],\"pattern\":[{\"type\":\"UniformAcceleration\","
+                  "\"timeSeries\":\"accel_x\",\"dof\":1}]}]}");
+        WriteFile(dir + "/EDP.json", "{\"EngineeringDemandParameters\":[{\"name\":\"ev\",\"responses\":[" +
+                                     responses.str() + "]}]}");
+        WriteFile(dir + "/SIM.json",
+                  "{\"type\":\"OpenSees\",\"integration\":\"Newmark 0.5 0.25\","
+                  "\"convergenceTest\":\"NormUnbalance 1.0e-2 10\",\"algorithm\":\"Newton\","
+                  "\"dampingModel\":\"Rayleigh Damping\",\"firstMode\":1,\"secondMode\":-1,"
+                  "\"rayleighTangent\":\"Initial\"}");
+    }
+
+    // Runs the preprocessor once in dir, returns false if it failed
+    bool Run(const std::string &preprocessor, const std::string &dir, const std::string &output)
+    {
+        std::string command = "cd \"" + dir + "\" && \"" + preprocessor +
+                              "\" AIM.json SAM.json EVENT.json EDP.json SIM.json " + output + " > preprocessor.log 2>&1";
+        return std::system(command.c_str()) == 0;
+    }
+
+    std::string ReadFile(const std::string &fileName)
+    {
+        std::ifstream in(fileName, std::ios::binary);
+        std::ostringstream text;
+        text << in.rdbuf();
+        return text.str();
+    }
+
+    int numFailed = 0;
+
+    // Benchmark preprocessor number index on the model in dir
+    void preprocess(benchmark::State &state, const std::string &preprocessor, int index, const std::string &dir,
+                    int numResponses)
+    {
+        std::string output = "run" + std::to_string(index + 1) + ".tcl";
+        for (auto _ : state)
+        {
+            if (!Run(preprocessor, dir, output))
+            {
+                state.SkipWithError((preprocessor + " failed, see preprocessor.log in " + dir).c_str());
+                numFailed++;
+                return;
+            }
+        }
+        state.counters["responses"] = numResponses;
+
+        // the script of the first preprocessor is the reference, unless it was filtered out
+        std::string reference = dir + "/run1.tcl";
+        if (index > 0 && std::filesystem::exists(reference) && ReadFile(dir + "/" + output) != ReadFile(reference))
+        {
+            state.SkipWithError((output + " differs from run1.tcl").c_str());
+            numFailed++;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (argc < 2)
+    {
+        std::cerr << "Usage: NodeMapBenchmark [Google Benchmark options] <path to OpenSeesPreprocessor> "
+                     "[more OpenSeesPreprocessors ...]\n";
+        return 1;
+    }
+
+    std::vector<std::string> preprocessors;
+    for (int i = 1; i < argc; i++)
+        preprocessors.push_back(std::filesystem::absolute(argv[i]).string());
+
+    // storeys and clines of each model
+    const std::vector<std::pair<int, int>> sizes = {{10, 2}, {25, 5}, {50, 10}, {100, 20}};
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "NodeMapBenchmark";
+    std::filesystem::remove_all(root);
+
+    for (const auto &size : sizes)
+    {
+        std::string name = std::to_string(size.first) + "x" + std::to_string(size.second);
+        std::string dir = (root / name).string();
+        std::filesystem::create_directories(dir);
+        WriteInputs(dir, size.first, size.second);
+
+        int numResponses = size.second * (5 * size.first + 4);
+        for (size_t p = 0; p < preprocessors.size(); p++)
+        {
+            std::string benchmarkName = "preprocess/" + name + "/run" + std::to_string(p + 1);
+            benchmark::RegisterBenchmark(benchmarkName.c_str(), preprocess, preprocessors[p], int(p), dir,
+                                         numResponses)
+                ->Unit(benchmark::kMillisecond)
+                ->UseRealTime();
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    std::filesystem::remove_all(root);
+    return numFailed;
+}
@@ -0,0 +1,266 @@
+"""End to end test of the response buffer path of OpenSeesPostprocessor.
+
+A mock analysis, standing in for OpenSees, produces the envelope, rms and
+drift responses of an EDP set, once as recorder text files and once as a
+response buffer, in a file and in a POSIX shared memory segment. From the
+recorder files the postprocessor writes the EDP file and no results.out. From
+the buffer it writes only results.out, which has to hold the values of the EDP
+file written from the recorder files in order, and leaves the EDP file as it
+was. An incomplete or missing buffer has to fail the simulation, the recorder
+files are never read in its place.
+
+Usage:
+    python runResponseBufferTest.py <path to OpenSeesPostprocessor>
+"""  # noqa: INP001
+
+import json
+import random
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+try:
+    from multiprocessing import resource_tracker, shared_memory
+except ImportError:  # pragma: no cover
+    shared_memory = None
+
+aim_name = 'AIM.json'
+
+# responses of the EDP set, the node responses of a type and dofs share a recorder
+responses = [
+    {'type': 'max_abs_acceleration', 'cline': '1', 'floor': '0', 'dofs': [1, 2]},
+    {'type': 'max_abs_acceleration', 'cline': '1', 'floor': '1', 'dofs': [1, 2]},
+    {'type': 'max_abs_acceleration', 'cline': '1', 'floor': '2', 'dofs': [1, 2]},
+    {'type': 'rms_acceleration', 'cline': '1', 'floor': '2', 'dofs': [1, 2]},
+    {'type': 'rms_acceleration', 'cline': '1', 'floor': '1', 'dofs': [1, 2]},
+    {'type': 'max_rel_disp', 'cline': '1', 'floor': '2', 'dofs': [1]},
+    {'type': 'max_drift', 'cline': '1', 'floor1': '0', 'floor2': '1', 'dofs': [1, 2]},
+    {'type': 'max_drift', 'cline': '1', 'floor1': '1', 'floor2': '2', 'dofs': [1, 2]},
+    {'type': 'max_roof_drift', 'cline': '1', 'floor1': '0', 'floor2': '2', 'dofs': [1]},
+]
+
+
+def write_inputs(work_dir):
+    """Write the AIM, SAM, EVENT and EDP files, with SAM in inches and AIM in feet."""
+    aim = {'GeneralInformation': {'units': {'length': 'ft', 'force': 'kips', 'time': 'sec'}}}
+    sam = {'units': {'length': 'in', 'force': 'kips', 'time': 'sec'}}
+    edp = {
+        'EngineeringDemandParameters': [
+            {'name': '1', 'responses': [dict(response) for response in responses]}
+        ]
+    }
+    for name, content in (
+        (aim_name, aim),
+        ('SAM.json', sam),
+        ('EVENT.json', {}),
+        ('EDP.json', edp),
+    ):
+        with open(work_dir / name, 'w') as f:  # noqa: PTH123
+            json.dump(content, f, indent=2)
+
+
+def mock_analysis():
+    """Return the values each recorder would write, keyed by its file name."""
+    rng = random.Random('response buffer')  # noqa: S311
+    recorders = {}
+
+    # node recorders, with a column per node and dof in the order the nodes are asked for
+    groups = {}
+    for response in responses:
+        if 'floor' not in response:
+            continue
+        dofs = '_'.join(str(dof) for dof in response['dofs'])
+        name = f'{aim_name}0.{response["type"]}.dofs_{dofs}.out'
+        nodes = groups.setdefault(name, (response['type'], len(response['dofs']), []))[2]
+        if response['floor'] not in nodes:
+            nodes.append(response['floor'])
+
+    for name, (response_type, num_dofs, nodes) in groups.items():
+        num_columns = len(nodes) * num_dofs
+        if response_type == 'rms_acceleration':
+            recorders[name] = [rng.uniform(0, 5) for i in range(num_columns)]
+        else:
+            rows = [[-rng.uniform(0, 5) for i in range(num_columns)]]
+            rows.append([rng.uniform(0, 5) for i in range(num_columns)])
+            rows.append([max(-low, high) for low, high in zip(*rows)])
+            recorders[name] = rows[0] + rows[1] + rows[2]
+
+    # drift recorders, one per dof with the min, max and max abs drift
+    for response in responses:
+        if 'floor1' not in response:
+            continue
+        for dof in response['dofs']:
+            name = f'{aim_name}0.{response["type"]}.{response["cline"]}.{response["floor1"]}.{response["floor2"]}.{dof}.out'
+            low, high = -rng.uniform(0, 0.05), rng.uniform(0, 0.05)
+            recorders[name] = [low, high, max(-low, high)]
+
+    return recorders
+
+
+def write_recorder_files(work_dir, recorders):
+    """Write the recorder text files OpenSees would have written."""
+    for name, values in recorders.items():
+        with open(work_dir / name, 'w') as f:  # noqa: PTH123
+            f.write(' '.join(repr(value) for value in values) + '\n')
+
+
+def response_buffer(recorders, complete=True):  # noqa: FBT002
+    """Return the bytes of a response buffer holding the recorder values."""
+    names = b''
+    values = []
+    segments = b''
+    for name, recorder_values in recorders.items():
+        encoded = name.encode()
+        segments += struct.pack('=4Q', len(names), len(encoded), len(values), len(recorder_values))
+        names += encoded
+        values += recorder_values
+
+    header = struct.pack(
+        '=8sII3Q',
+        b'SCEDPBUF',
+        1,
+        1 if complete else 0,
+        len(recorders),
+        len(names),
+        len(values),
+    )
+    padding = b'\0' * (-len(names) % 8)
+    return header + segments + names + padding + struct.pack(f'={len(values)}d', *values)
+
+
+def run_postprocessor(app_path, work_dir, buffer_name=None):
+    """Run the postprocessor, return the result, EDP file and results.out text."""
+    command = [app_path, aim_name, 'SAM.json', 'EVENT.json', 'EDP.json']
+    if buffer_name is not None:
+        command += ['--responseBuffer', buffer_name]
+
+    result = subprocess.run(  # noqa: S603
+        command, cwd=work_dir, capture_output=True, text=True, check=False
+    )
+
+    with open(work_dir / 'EDP.json') as f:  # noqa: PTH123
+        edp = json.load(f)
+
+    results = None
+    if (work_dir / 'results.out').exists():
+        results = (work_dir / 'results.out').read_text()
+
+    return result, edp, results
+
+
+def check_buffer_run(result, edp, results, reference, inputs):
+    """Return a description of what a run reading a buffer got wrong."""
+    if result.returncode != 0:
+        return f'exit code {result.returncode}\n{result.stdout}'
+    if edp != inputs:
+        return 'EDP.json written from the buffer'
+    if results is None:
+        return 'results.out not written'
+
+    expected = []
+    for response in reference['EngineeringDemandParameters'][0]['responses']:
+        expected += response['scalar_data']
+
+    values = [float(value) for value in results.split()]
+    if values != expected:
+        return f'results.out {values} != {expected}'
+
+    return None
+
+
+def check_failed(result, results):
+    """Return a description of what a run that has to fail got wrong."""
+    if result.returncode == 0 or 'not successful' not in result.stdout:
+        return 'the simulation did not fail'
+    if results is not None:
+        return 'results.out written'
+    return None
+
+
+def main(args):  # noqa: C901
+    """Run the postprocessor given as argument, return the number of failures."""
+    if len(args) != 1:
+        print(__doc__)  # noqa: T201
+        return 1
+
+    app_path = str(Path(args[0]).resolve())
+    recorders = mock_analysis()
+    buffer = response_buffer(recorders)
+
+    failures = {}
+    with tempfile.TemporaryDirectory() as temp_dir:
+        temp_dir = Path(temp_dir)  # noqa: PLW2901
+
+        def new_dir(name):
+            work_dir = temp_dir / name
+            work_dir.mkdir()
+            write_inputs(work_dir)
+            return work_dir
+
+        # reference, from the recorder files
+        files_dir = new_dir('files')
+        with open(files_dir / 'EDP.json') as f:  # noqa: PTH123
+            inputs = json.load(f)
+        write_recorder_files(files_dir, recorders)
+        result, reference, results = run_postprocessor(app_path, files_dir)
+        if result.returncode != 0:
+            print(f'recorder files FAILED exit code {result.returncode}\n{result.stdout}')  # noqa: T201
+            return 1
+        failures['recorder files'] = None
+        if results is not None:
+            failures['recorder files'] = 'results.out written without a buffer'
+
+        # the buffer in a file, without recorder files
+        file_dir = new_dir('bufferFile')
+        (file_dir / 'responses.bin').write_bytes(buffer)
+        result, edp, results = run_postprocessor(app_path, file_dir, 'responses.bin')
+        failures['buffer file'] = check_buffer_run(result, edp, results, reference, inputs)
+
+        # the buffer in shared memory, written by the mock analysis
+        if shared_memory is not None and sys.platform != 'win32':
+            shm_dir = new_dir('bufferShm')
+            shm_name = f'SimCenterEDP{random.randrange(1 << 30)}'  # noqa: S311
+            segment = shared_memory.SharedMemory(name=shm_name, create=True, size=len(buffer))
+            # the postprocessor removes the segment once it is read
+            resource_tracker.unregister(segment._name, 'shared_memory')  # noqa: SLF001
+            segment.buf[: len(buffer)] = buffer
+            segment.close()
+
+            result, edp, results = run_postprocessor(app_path, shm_dir, f'shm:{shm_name}')
+            failures['shared memory'] = check_buffer_run(result, edp, results, reference, inputs)
+
+            try:
+                shared_memory.SharedMemory(name=shm_name).unlink()
+                failures['shared memory'] = 'segment not removed'
+            except FileNotFoundError:
+                pass
+
+        # an analysis that did not finish
+        incomplete_dir = new_dir('incomplete')
+        (incomplete_dir / 'responses.bin').write_bytes(response_buffer(recorders, complete=False))
+        result, edp, results = run_postprocessor(app_path, incomplete_dir, 'responses.bin')
+        failures['incomplete buffer'] = check_failed(result, results)
+
+        # no buffer, the recorder files next to it are not read in its place
+        missing_dir = new_dir('missing')
+        for name in recorders:
+            shutil.copy(files_dir / name, missing_dir / name)
+        result, edp, results = run_postprocessor(app_path, missing_dir, 'responses.bin')
+        failures['missing buffer'] = check_failed(result, results)
+
+    num_failed = 0
+    for case, failure in failures.items():
+        if failure:
+            num_failed += 1
+            print(f'{case} FAILED {failure}')  # noqa: T201
+        else:
+            print(f'{case} passed')  # noqa: T201
+
+    return num_failed
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -16,7 +16,9 @@ using namespace std;
 
 OpenSeesConcreteShearWalls::OpenSeesConcreteShearWalls()
     : filenameBIM(0), filenameSAM(0), filenameEVENT(0), filenameEDP(0),
-      filenameTCL(0), filenameUQ(0), analysisType(-1), numSteps(0), dT(0.0), nStory(0)
+      filenameTCL(0), filenameUQ(0), analysisType(-1), numSteps(0), dT(0.0), nStory(0),
+      gridMinX(0.0), gridMinY(0.0), gridCellX(1.0), gridCellY(1.0), gridNumX(0), gridNumY(0),
+      maxAbsCrd(0.0)
 {
 }
 
@@ -399,6 +401,7 @@ int OpenSeesConcreteShearWalls::processNodes(ofstream &s)
 
   json_t *geometry = json_object_get(rootSAM, "geometry");
   nodes = json_object_get(geometry, "nodes");
+  indexNodes();
 
   NDM = 0;
   NDF = 0;
@@ -1131,7 +1134,7 @@ int OpenSeesConcreteShearWalls::processEvent(ofstream &s,
   double startPoint[2];
   double endPoint[2];
 
-  int nodesOnline[10000] = {-1};
+  std::vector<int> nodesOnline;
 
   string patternName, patternType, timeSeriesName, loadType, positionType;
   json_t *positions, *position, *dofs, *scales;
@@ -1259,7 +1262,7 @@ int OpenSeesConcreteShearWalls::processEvent(ofstream &s,
         {
           printf("Nodes on line, 1st: %d \n", nodesOnline[0]);
 
-          for (int nodeIndex = 0; nodeIndex < 10000; nodeIndex++)
+          for (int nodeIndex = 0; nodeIndex < numNodesOnLine; nodeIndex++)
           {
             if (nodesOnline[nodeIndex] > 0)
             {
@@ -1332,25 +1335,115 @@ int OpenSeesConcreteShearWalls::processEvent(ofstream &s,
   return 0;
 }
 
-int OpenSeesConcreteShearWalls::getNode(int cline, int floor)
+void OpenSeesConcreteShearWalls::indexNodes()
 {
+  size_t numNodes = json_array_size(nodes);
+
+  nodeTags.assign(numNodes, 0);
+  nodeX.assign(numNodes, 0.0);
+  nodeY.assign(numNodes, 0.0);
+  nodeHasCrd.assign(numNodes, false);
+  nodeIndex.clear();
+  nodeIndex.reserve(numNodes);
+
+  double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+  maxAbsCrd = 0.0;
+
+  for (size_t i = 0; i < numNodes; i++)
+  {
+    json_t *node = json_array_get(nodes, i);
+    json_t *crd = json_object_get(node, "crd");
+
+    nodeTags[i] = json_integer_value(json_object_get(node, "name"));
+    nodeX[i] = json_number_value(json_array_get(crd, 0));
+    nodeY[i] = json_number_value(json_array_get(crd, 1));
+    nodeHasCrd[i] = (crd != NULL);
+    nodeIndex.emplace(nodeTags[i], (int)i);
+
+    if (i == 0 || nodeX[i] < minX)
+      minX = nodeX[i];
+    if (i == 0 || nodeX[i] > maxX)
+      maxX = nodeX[i];
+    if (i == 0 || nodeY[i] < minY)
+      minY = nodeY[i];
+    if (i == 0 || nodeY[i] > maxY)
+      maxY = nodeY[i];
+    maxAbsCrd = std::max(maxAbsCrd, std::max(fabs(nodeX[i]), fabs(nodeY[i])));
+  }
 
+  // nodes with coordinates sorted by elevation, ties kept in array order
+  nodesByElevation.clear();
+  for (size_t i = 0; i < numNodes; i++)
+    if (nodeHasCrd[i])
+      nodesByElevation.push_back((int)i);
+  std::stable_sort(nodesByElevation.begin(), nodesByElevation.end(),
+                   [this](int a, int b) { return nodeY[a] < nodeY[b]; });
+
+  // grid sized to hold about two nodes per cell
+  double width = maxX - minX;
+  double height = maxY - minY;
+  gridMinX = minX;
+  gridMinY = minY;
+  gridNumX = 1;
+  gridNumY = 1;
+  if (numNodes > 0)
+  {
+    double cellSize = 0.0;
+    if (width > 0.0 && height > 0.0)
+      cellSize = sqrt(2.0 * width * height / numNodes);
+    else
+      cellSize = 2.0 * std::max(width, height) / numNodes;
+
+    if (cellSize > 0.0)
+    {
+      gridNumX = (int)std::min(std::max(ceil(width / cellSize), 1.0), 4096.0);
+      gridNumY = (int)std::min(std::max(ceil(height / cellSize), 1.0), 4096.0);
+    }
+  }
+  gridCellX = (width > 0.0) ? width / gridNumX : 1.0;
+  gridCellY = (height > 0.0) ? height / gridNumY : 1.0;
+
+  std::vector<int> nodeCell(numNodes);
+  cellStart.assign((size_t)gridNumX * gridNumY + 1, 0);
+  for (size_t i = 0; i < numNodes; i++)
+  {
+    int cellX = std::min(std::max((int)((nodeX[i] - gridMinX) / gridCellX), 0), gridNumX - 1);
+    int cellY = std::min(std::max((int)((nodeY[i] - gridMinY) / gridCellY), 0), gridNumY - 1);
+    nodeCell[i] = cellY * gridNumX + cellX;
+    cellStart[nodeCell[i] + 1]++;
+  }
+  for (size_t c = 1; c < cellStart.size(); c++)
+    cellStart[c] += cellStart[c - 1];
+
+  cellNodes.assign(numNodes, 0);
+  std::vector<int> cellFill(cellStart.begin(), cellStart.end() - 1);
+  for (size_t i = 0; i < numNodes; i++)
+    cellNodes[cellFill[nodeCell[i]]++] = (int)i;
+
+  // node of each cline and floor of the mapping
+  nodeMapping.clear();
   int numMapObjects = json_array_size(mapping);
+  nodeMapping.reserve(numMapObjects);
   for (int i = 0; i < numMapObjects; i++)
   {
     json_t *mapObject = json_array_get(mapping, i);
-    int c = json_integer_value(json_object_get(mapObject, "cline"));
-    if (c == cline)
-    {
-      int f = json_integer_value(json_object_get(mapObject, "floor"));
-      if (f == floor)
-        return json_integer_value(json_object_get(mapObject, "node"));
-    }
+    long long c = json_integer_value(json_object_get(mapObject, "cline"));
+    int f = json_integer_value(json_object_get(mapObject, "floor"));
+    int node = json_integer_value(json_object_get(mapObject, "node"));
+    nodeMapping.emplace((c << 32) | (unsigned int)f, node);
   }
+}
+
+int OpenSeesConcreteShearWalls::getNode(int cline, int floor)
+{
+  auto it = nodeMapping.find(((long long)cline << 32) | (unsigned int)floor);
+  if (it != nodeMapping.end())
+    return it->second;
+
   return -1;
 }
 
-int OpenSeesConcreteShearWalls::findNodesOnStraigntLine(double pt1[], double pt2[], int nodesOnline[])
+int OpenSeesConcreteShearWalls::findNodesOnStraigntLine(double pt1[], double pt2[], std::vector<int> &nodesOnline)
 {
   printf("Try to find nodes defined by (x1=%f y1=%f) and (x2=%f y2=%f)\n", pt1[0], pt1[1], pt2[0], pt2[1]);
 
@@ -1359,19 +1452,71 @@ int OpenSeesConcreteShearWalls::findNodesOnStraigntLine(double pt1[], double pt2
   double x2 = pt2[0];
   double y2 = pt2[1];
 
-  int nodeName;
+  //
+  // a node on the line lies within the ellipse of points whose distances to pt1 and pt2
+  // add up to at most their distance plus the tolerance, so only the grid cells within
+  // the half width of that ellipse of the line are searched. the tolerance is widened
+  // to cover the rounding of the single precision test below
+  //
 
-  int index, count;
-  //int nodesOnline[10000]={-1};
-  float x, y;
-  json_t *node;
-  json_t *crd;
-  count = 0;
-  json_array_foreach(nodes, index, node)
+  std::vector<int> candidates;
+  double tolerance = 0.001 + 1.0e-5 * (1.0 + std::max(maxAbsCrd, std::max(fabs(x1) + fabs(x2), fabs(y1) + fabs(y2))));
+  double length = sqrt(pow(x1 - x2, 2.0) + pow(y1 - y2, 2.0));
+  double margin = sqrt(tolerance * (2.0 * length + tolerance)) + tolerance;
+
+  if (std::isfinite(margin) && !cellNodes.empty())
   {
-    crd = (json_object_get(node, "crd"));
-    x = json_number_value(json_array_get(crd, 0));
-    y = json_number_value(json_array_get(crd, 1));
+    double minY = std::min(y1, y2) - margin;
+    double maxY = std::max(y1, y2) + margin;
+    int firstRow = std::min(std::max((int)floor((minY - gridMinY) / gridCellY), 0), gridNumY - 1);
+    int lastRow = std::min(std::max((int)floor((maxY - gridMinY) / gridCellY), 0), gridNumY - 1);
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+      // x range of the line over the elevations within the margin of the row
+      double rowMinY = std::max(minY, gridMinY + row * gridCellY - margin);
+      double rowMaxY = std::min(maxY, gridMinY + (row + 1) * gridCellY + margin);
+      double t1 = 0.0, t2 = 1.0;
+      if (y1 != y2)
+      {
+        t1 = (rowMinY - y1) / (y2 - y1);
+        t2 = (rowMaxY - y1) / (y2 - y1);
+        if (t1 > t2)
+          std::swap(t1, t2);
+        t1 = std::max(t1, 0.0);
+        t2 = std::min(t2, 1.0);
+        if (t1 > t2)
+          continue;
+      }
+      double xa = x1 + t1 * (x2 - x1);
+      double xb = x1 + t2 * (x2 - x1);
+      double minX = std::min(xa, xb) - margin;
+      double maxX = std::max(xa, xb) + margin;
+      int firstCol = std::min(std::max((int)floor((minX - gridMinX) / gridCellX), 0), gridNumX - 1);
+      int lastCol = std::min(std::max((int)floor((maxX - gridMinX) / gridCellX), 0), gridNumX - 1);
+
+      for (int col = firstCol; col <= lastCol; col++)
+      {
+        int cell = row * gridNumX + col;
+        for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++)
+          candidates.push_back(cellNodes[k]);
+      }
+    }
+
+    // nodes are reported in the order of the nodes array
+    std::sort(candidates.begin(), candidates.end());
+  }
+  else
+  {
+    for (size_t i = 0; i < nodeTags.size(); i++)
+      candidates.push_back((int)i);
+  }
+
+  nodesOnline.clear();
+  for (int i : candidates)
+  {
+    float x = nodeX[i];
+    float y = nodeY[i];
 
     float dAB = sqrt(pow(x1 - x2, 2.0) + pow(y1 - y2, 2.0)); // distance between pt1 and pt2
     float dAC = sqrt(pow(x1 - x, 2.0) + pow(y1 - y, 2.0));   // distance between pt1 and pt2
@@ -1379,32 +1524,22 @@ int OpenSeesConcreteShearWalls::findNodesOnStraigntLine(double pt1[], double pt2
 
     if (abs(dAC + dBC - dAB) < 0.001) // the tolarence could be smaller
     {
-      nodeName = json_integer_value(json_object_get(node, "name"));
+      int nodeName = nodeTags[i];
       printf("Node found: %d (x=%f y=%f) \n", nodeName, x, y);
-      nodesOnline[count] = nodeName;
-      count++;
+      nodesOnline.push_back(nodeName);
     }
   }
-  return count;
+  return nodesOnline.size();
 }
 
 int OpenSeesConcreteShearWalls::getNodeCrdByTag(int nodeTag, double pt[])
 {
-  json_t *node;
-  json_t *crd;
-  int index;
-  int nodeName;
-
-  json_array_foreach(nodes, index, node)
+  auto it = nodeIndex.find(nodeTag);
+  if (it != nodeIndex.end())
   {
-    nodeName = json_integer_value(json_object_get(node, "name"));
-    if (nodeName == nodeTag)
-    {
-      crd = (json_object_get(node, "crd"));
-      pt[0] = json_number_value(json_array_get(crd, 0));
-      pt[1] = json_number_value(json_array_get(crd, 1));
-      return 1;
-    }
+    pt[0] = nodeX[it->second];
+    pt[1] = nodeY[it->second];
+    return 1;
   }
 
   return -1;
@@ -1412,24 +1547,23 @@ int OpenSeesConcreteShearWalls::getNodeCrdByTag(int nodeTag, double pt[])
 
 std::vector<int> OpenSeesConcreteShearWalls::getNodesAtElevation(double elevation)
 {
-	std::vector<int> floorNodes;
+	std::vector<int> floorIndices;
 
-	json_t* nodeJson;
-	size_t index = 0;
-	json_array_foreach(nodes, index, nodeJson)
+	auto first = std::lower_bound(nodesByElevation.begin(), nodesByElevation.end(), elevation - 1e-3,
+		[this](int i, double value) { return nodeY[i] < value; });
+
+	for (auto it = first; it != nodesByElevation.end() && nodeY[*it] <= elevation + 1e-3; it++)
 	{
-		json_t* coordinates = json_object_get(nodeJson, "crd");
-		if (NULL == coordinates)
-			continue;
+		if (fabs(nodeY[*it] - elevation) < 1e-3)
+			floorIndices.push_back(*it);
+	}
 
-		json_t* elevationJson = json_array_get(coordinates, 1);
-		double nodeElevation = json_number_value(elevationJson);
+	// nodes are returned in the order of the nodes array
+	std::sort(floorIndices.begin(), floorIndices.end());
 
-		if (fabs(nodeElevation - elevation) < 1e-3)
-		{
-			floorNodes.push_back(json_integer_value(json_object_get(nodeJson, "name")));
-		}
-	}
+	std::vector<int> floorNodes;
+	for (int i : floorIndices)
+		floorNodes.push_back(nodeTags[i]);
 
 	return floorNodes;
 }
@@ -2,6 +2,7 @@
 #define OpenSeesConcreteShearWalls_H
 class json_t;
 #include <fstream>
+#include <unordered_map>
 #include <vector>
 
 
@@ -43,7 +44,7 @@ class OpenSeesConcreteShearWalls {
 		   int &numSeries);
 
   int getNode(int cline, int floor);
-  int findNodesOnStraigntLine(double pt1[], double pt2[], int nodesOnline[]);
+  int findNodesOnStraigntLine(double pt1[], double pt2[], std::vector<int> &nodesOnline);
   int getNodeCrdByTag(int nodeTag, double pt[]);
 
  private:
@@ -76,6 +77,28 @@ class OpenSeesConcreteShearWalls {
 
   std::vector<int> getNodesAtElevation(double elevation);
   void processFloorsMasses(ofstream &s);
+
+  // index the nodes and the node mapping once so the node queries don't scan the json arrays
+  void indexNodes();
+
+  // tags and coordinates of the nodes in the order of the nodes array
+  std::vector<int> nodeTags;
+  std::vector<double> nodeX, nodeY;
+  std::vector<bool> nodeHasCrd;
+
+  // index of each node tag and node of each (cline, floor), the first entry wins
+  std::unordered_map<int, int> nodeIndex;
+  std::unordered_map<long long, int> nodeMapping;
+
+  // node indices sorted by elevation, for the floor queries
+  std::vector<int> nodesByElevation;
+
+  // uniform grid of buckets over the nodes, for the line queries, cell c holds the
+  // node indices cellStart[c] to cellStart[c+1]-1 of cellNodes
+  double gridMinX, gridMinY, gridCellX, gridCellY;
+  int gridNumX, gridNumY;
+  std::vector<int> cellStart, cellNodes;
+  double maxAbsCrd;
 };
 
 #endif // OPENSEES_PREPROCESSOR_H
@@ -0,0 +1,207 @@
+// Benchmark of the node queries of the shear wall preprocessor
+//
+// For each wall size a concrete wall meshed with a regular grid of quads is written to a temporary folder:
+// its BIM floors, the SAM nodes and node mapping, an EVENT with line loads along rows, columns, diagonals
+// and random segments of the mesh, point loads and a uniform acceleration, and an EDP. Every
+// mainPreprocessor given is run on it and the wall time per run is reported. Pass builds from before and
+// after a change to compare them, the logs they print, which list the nodes found on every loaded line,
+// are checked to be identical to the one of the first preprocessor, a run printing another log is
+// reported as an error.
+//
+// Usage: ShearWallBenchmark [Google Benchmark options] <path to mainPreprocessor> [more ...]
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+// Google Benchmark
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    struct Wall
+    {
+        int numX;      // nodes along the width
+        int numY;      // nodes along the height
+        int numLines;  // loaded lines
+    };
+
+    void WriteFile(const std::string &fileName, const std::string &text)
+    {
+        std::ofstream out(fileName);
+        out << text;
+    }
+
+    std::string Position(int cline, int floor)
+    {
+        return "{\"cline\":\"" + std::to_string(cline) + "\",\"floor\":\"" + std::to_string(floor) + "\"}";
+    }
+
+    // Writes BIM, SAM, EVENT and EDP files of a 10 m wide wall meshed with wall.numX by wall.numY nodes
+    void WriteInputs(const std::string &dir, const Wall &wall)
+    {
+        const int nx = wall.numX, ny = wall.numY;
+        const double dx = 10.0 / (nx - 1), dy = 0.75 * ny / (ny - 1);
+        auto tag = [nx](int i, int j) { return j * nx + i + 1; };
+
+        std::ostringstream nodes, mapping, elements, floors;
+        for (int j = 0; j < ny; j++)
+        {
+            for (int i = 0; i < nx; i++)
+            {
+                std::string separator = (tag(i, j) > 1) ? "," : "";
+                nodes << separator << "{\"name\":" << tag(i, j) << ",\"crd\":[" << i * dx << "," << j * dy
+                      << "],\"ndf\":2}";
+                mapping << separator << "{\"cline\":" << i + 1 << ",\"floor\":" << j + 1 << ",\"node\":" << tag(i, j)
+                        << "}";
+                if (i < nx - 1 && j < ny - 1)
+                    elements << (elements.tellp() > 0 ? "," : "") << "{\"name\":" << j * (nx - 1) + i + 1
+                             << ",\"type\":\"FourNodeQuad\",\"nodes\":[" << tag(i, j) << "," << tag(i + 1, j) << ","
+                             << tag(i + 1, j + 1) << "," << tag(i, j + 1) << "],\"material\":1}";
+            }
+            floors << (j > 0 ? "," : "") << "{\"elevation\":" << j * dy << "}";
+        }
+        // a node without coordinates
+        nodes << ",{\"name\":" << nx * ny + 1 << ",\"ndf\":2}";
+
+        WriteFile(dir + "/SAM.json",
+                  "{\"Structural Analysis Model\":{\"geometry\":{\"nodes\":[" + nodes.str() + "],\"elements\":[" +
+                  elements.str() + "]},\"nodeMapping\":[" + mapping.str() + "],\"properties\":{\"uniaxialMaterials\":"
+                  "[{\"type\":\"Steel01\",\"name\":2,\"E\":2e5,\"fy\":400,\"b\":0.01}],\"ndMaterials\":"
+                  "[{\"type\":\"PlaneStressRebar\",\"name\":1,\"material\":2,\"angle\":0}]}}}");
+        WriteFile(dir + "/BIM.json", "{\"StructuralInformation\":{\"layout\":{\"floors\":[" + floors.str() +
+                                     "]}},\"GI\":{\"area\":10.0}}");
+
+        // rows, columns, the diagonal and random segments of the mesh
+        std::mt19937 generator(1);
+        auto randomCline = [&]() { return std::uniform_int_distribution<int>(1, nx)(generator); };
+        auto randomFloor = [&]() { return std::uniform_int_distribution<int>(1, ny)(generator); };
+        std::ostringstream lines, points;
+        for (int k = 0; k < wall.numLines; k++)
+        {
+            std::string start, end;
+            if (k % 4 == 0)
+            {
+                int floor = randomFloor();
+                start = Position(1, floor), end = Position(nx, floor);
+            }
+            else if (k % 4 == 1)
+            {
+                int cline = randomCline();
+                start = Position(cline, 1), end = Position(cline, ny);
+            }
+            else if (k % 4 == 2)
+                start = Position(1, 1), end = Position(nx, nx <= ny ? nx : ny);
+            else
+            {
+                start = Position(randomCline(), randomFloor());
+                end = Position(randomCline(), randomFloor());
+            }
+            lines << (k > 0 ? "," : "") << "{\"startPoint\":" << start << ",\"endPoint\":" << end
+                  << ",\"dofs\":[\"1\",\"2\"],\"scales\":[1.0,2.0]}";
+        }
+        for (int k = 0; k < 50; k++)
+        {
+            std::string position = Position(randomCline(), randomFloor());
+            points << (k > 0 ? "," : "") << position.substr(0, position.size() - 1)
+                   << ",\"dofs\":[\"1\"],\"scales\":[3.0]}";
+        }
+
+        WriteFile(dir + "/EVENT.json",
+                  "{\"Events\":[{\"name\":\"ev1\",\"type\":\"Seismic\",\"numSteps\":10,\"dT\":0.01,\"timeSeries\":"
+                  "[{\"type\":\"Value\",\"name\":\"ts\",\"dT\":0.01,\"data\":[0,0.1,0.2,0.3,0.4,0.5,0.6,0.7,0.8,0.9]}],"
+                  "\"pattern\":[{\"type\":\"LineForce\",\"timeSeries\":\"ts\",\"positions\":[" + lines.str() + "]},"
+                  "{\"type\":\"PointForce\",\"timeSeries\":\"ts\",\"positions\":[" + points.str() + "]},"
+                  "{\"type\":\"UniformAcceleration\",\"timeSeries\":\"ts\",\"dof\":1}]}]}");
+        WriteFile(dir + "/EDP.json", "{\"EngineeringDemandParameters\":[{\"name\":\"ev1\",\"responses\":"
+                                     "[{\"type\":\"max_abs_acceleration\",\"cline\":1,\"floor\":2}]}]}");
+    }
+
+    // Runs the preprocessor once in dir, returns false if it failed
+    bool Run(const std::string &preprocessor, const std::string &dir, const std::string &log)
+    {
+        std::string command = "cd \"" + dir + "\" && \"" + preprocessor +
+                              "\" BIM.json SAM.json EVENT.json EDP.json wall.tcl > " + log + " 2>&1";
+        return std::system(command.c_str()) == 0;
+    }
+
+    std::string ReadFile(const std::string &fileName)
+    {
+        std::ifstream in(fileName, std::ios::binary);
+        std::ostringstream text;
+        text << in.rdbuf();
+        return text.str();
+    }
+
+    int numFailed = 0;
+
+    // Benchmark preprocessor number index on the wall in dir
+    void preprocess(benchmark::State &state, const std::string &preprocessor, int index, const std::string &dir,
+                    const Wall &wall)
+    {
+        std::string log = "run" + std::to_string(index + 1) + ".log";
+        for (auto _ : state)
+        {
+            if (!Run(preprocessor, dir, log))
+            {
+                state.SkipWithError((preprocessor + " failed, see " + log + " in " + dir).c_str());
+                numFailed++;
+                return;
+            }
+        }
+        state.counters["nodes"] = wall.numX * wall.numY;
+        state.counters["lines"] = wall.numLines;
+
+        // the log of the first preprocessor is the reference, unless it was filtered out
+        std::string reference = dir + "/run1.log";
+        if (index > 0 && std::filesystem::exists(reference) && ReadFile(dir + "/" + log) != ReadFile(reference))
+        {
+            state.SkipWithError((log + " differs from run1.log").c_str());
+            numFailed++;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (argc < 2)
+    {
+        std::cerr << "Usage: ShearWallBenchmark [Google Benchmark options] <path to mainPreprocessor> "
+                     "[more mainPreprocessors ...]\n";
+        return 1;
+    }
+
+    std::vector<std::string> preprocessors;
+    for (int i = 1; i < argc; i++)
+        preprocessors.push_back(std::filesystem::absolute(argv[i]).string());
+
+    const std::vector<Wall> walls = {{11, 51, 20}, {21, 101, 50}, {51, 401, 200}};
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "ShearWallBenchmark";
+    std::filesystem::remove_all(root);
+
+    for (const Wall &wall : walls)
+    {
+        std::string name = std::to_string(wall.numX) + "x" + std::to_string(wall.numY);
+        std::string dir = (root / name).string();
+        std::filesystem::create_directories(dir);
+        WriteInputs(dir, wall);
+
+        for (size_t p = 0; p < preprocessors.size(); p++)
+        {
+            std::string benchmarkName = "preprocess/" + name + "/run" + std::to_string(p + 1);
+            benchmark::RegisterBenchmark(benchmarkName.c_str(), preprocess, preprocessors[p], int(p), dir, wall)
+                ->Unit(benchmark::kMillisecond)
+                ->UseRealTime();
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    std::filesystem::remove_all(root);
+    return numFailed;
+}
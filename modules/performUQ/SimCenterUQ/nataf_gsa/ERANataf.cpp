@@ -1035,7 +1035,32 @@ void ERANataf::simulateAppBatchSurrogate(string workflowDriver,
 	//
 	//vector<vector<double>> gvals(inp.nmc, std::vector<double>(inp.nqoi, 0));
 
-	gvals = simulateAppOnce(0, inp.workDir, copyDir, inp.nrv + inp.nco + inp.nre, inp.nst, inp.nqoi, inp.rvNames, x, xstr, workflowDriver, osType, runType);
+	int nrvNum = inp.nrv + inp.nco + inp.nre;
+	bool evaluatedInProcess = false;
+#ifdef NATIVE_GP_SURROGATE
+	// The model is evaluated in process when it can be, saving the start of python and the loading of the model,
+	// otherwise (and for samples that need the original model) by gpPredict.py through the workflow driver. Off by
+	// default (NATAF_GSA_NATIVE_GP_SURROGATE) until test/runGpSurrogateTest.py has passed against gpPredict.py with GPy
+	if (!surrogate.isLoaded) {
+		surrogate.loadModel(inp.jsonFilePath, copyDir);
+	}
+
+	vector<string> numNames(inp.rvNames.begin(), inp.rvNames.begin() + nrvNum);
+	evaluatedInProcess = surrogate.isLoaded && surrogate.evaluate(inp.workDir + "/workdir.1", 1, numNames, x, gvals);
+	if (evaluatedInProcess) {
+		if (procno == 0) std::cout << "surrogate evaluated in process" << "\n\n";
+		if ((nmc > 0) && ((int)gvals[0].size() != inp.nqoi)) {
+			//*ERROR*
+			std::string errMsg = "Error reading FEM results: the number of outputs in results.out (" + std::to_string(gvals[0].size()) + ") does not match the number of QoIs specified (" + std::to_string(inp.nqoi) + ")";
+			theErrorFile.write(errMsg);
+		}
+	} else {
+		if (procno == 0) std::cout << "surrogate evaluated by the workflow driver: " << surrogate.message << "\n\n";
+	}
+#endif
+	if (!evaluatedInProcess) {
+		gvals = simulateAppOnce(0, inp.workDir, copyDir, nrvNum, inp.nst, inp.nqoi, inp.rvNames, x, xstr, workflowDriver, osType, runType);
+	}
 	   	  
 	//X = x;
 	//Xstr = xstr;
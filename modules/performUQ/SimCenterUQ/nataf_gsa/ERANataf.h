@@ -49,6 +49,9 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "jsonInput.h"
 #include "Eigen/Dense"
 #include "writeErrors.h"
+#ifdef NATIVE_GP_SURROGATE
+#include "gpSurrogate.h"
+#endif
 #include <algorithm>
 #include <random>
 //#define MPI
@@ -83,6 +86,9 @@ public:
 	//vector<vector<string>> Xstr;
 	//vector<vector<double>> G;
 	Eigen::MatrixXd RhozMat, RhozInv;
+#ifdef NATIVE_GP_SURROGATE
+	gpSurrogate surrogate; // loaded by the first evaluation of a SurrogateGP model
+#endif
 
 	vector<vector<double>> X2U(int nmc, vector<vector<double>> x);
 	vector<vector<double>> U2X(int nmc, vector<vector<double>> u);
@@ -0,0 +1,140 @@
+// Throughput benchmark of the in-process surrogate evaluator of nataf_gsa
+//
+// A Matern 5/2 surrogate model with random training data is written to a temporary folder and loaded
+// once. The samples are then predicted in one batch, and one sample at a time, which is how a model
+// evaluated per sample would be used. The load time and the samples per second of both are reported,
+// with the largest difference between their predictions.
+//
+// Usage: GpSurrogateBenchmark [training samples] [samples] [inputs] [outputs]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <nlohmann/json.hpp>
+#include "gpSurrogate.h"
+
+using json = nlohmann::json;
+
+namespace
+{
+    double SecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Writes the surrogate model and the input json naming it, returns the path of the input json
+    std::string WriteModel(const std::string &dir, int numTrain, int numInputs, int numOutputs)
+    {
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+
+        json sur;
+        sur["doStochastic"] = std::vector<bool>(numOutputs, false);
+        sur["doNormalization"] = false;
+        sur["doLogtransform"] = false;
+        sur["doLinear"] = false;
+        sur["doMultiFidelity"] = false;
+        sur["kernName"] = "Matern 5/2";
+        sur["xdim"] = numInputs;
+        sur["ydim"] = numOutputs;
+        sur["highFidelityInfo"]["valSamp"] = numTrain;
+
+        std::vector<std::vector<double>> x(numInputs, std::vector<double>(numTrain));
+        for (int nx = 0; nx < numInputs; nx++)
+        {
+            std::string name = "x" + std::to_string(nx + 1);
+            sur["xlabels"].push_back(name);
+            for (int i = 0; i < numTrain; i++)
+                x[nx][i] = uniform(generator);
+            sur["xExact"][name] = x[nx];
+        }
+
+        json edps = json::array();
+        for (int ny = 0; ny < numOutputs; ny++)
+        {
+            std::string name = "g" + std::to_string(ny + 1);
+            sur["ylabels"].push_back(name);
+            std::vector<double> y(numTrain);
+            for (int i = 0; i < numTrain; i++)
+            {
+                y[i] = 0.1 * uniform(generator);
+                for (int nx = 0; nx < numInputs; nx++)
+                    y[i] += std::sin((nx + ny + 1) * x[nx][i]);
+            }
+            sur["yExact"][name] = y;
+            sur["modelInfo"][name]["Mat52.variance"] = {1.0};
+            sur["modelInfo"][name]["Mat52.lengthscale"] = std::vector<double>(numInputs, 0.8);
+            sur["modelInfo"][name]["Gaussian_noise.variance"] = {1.0e-3};
+            edps.push_back({{"name", name}, {"length", 1}});
+        }
+        std::ofstream(dir + "/surrogate.json") << sur;
+
+        json inp;
+        inp["Applications"]["FEM"]["Application"] = "SurrogateGP";
+        inp["Applications"]["FEM"]["ApplicationData"]["mainScript"] = "surrogate.json";
+        inp["FEM"]["predictionOption"] = "median";
+        inp["EDP"] = edps;
+        std::ofstream(dir + "/scInput.json") << inp;
+
+        return dir + "/scInput.json";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int numTrain = (argc > 1) ? std::atoi(argv[1]) : 500;
+    int numSamples = (argc > 2) ? std::atoi(argv[2]) : 10000;
+    int numInputs = (argc > 3) ? std::atoi(argv[3]) : 5;
+    int numOutputs = (argc > 4) ? std::atoi(argv[4]) : 3;
+
+    std::string dir = (std::filesystem::temp_directory_path() / "GpSurrogateBenchmark").string();
+    std::filesystem::create_directories(dir);
+    std::string inputJson = WriteModel(dir, numTrain, numInputs, numOutputs);
+
+    gpSurrogate surrogate;
+    auto start = std::chrono::steady_clock::now();
+    if (!surrogate.loadModel(inputJson, dir))
+    {
+        std::cerr << "GpSurrogateBenchmark: " << surrogate.message << "\n";
+        return 1;
+    }
+    double loadTime = SecondsSince(start);
+
+    std::mt19937 generator(2);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    Eigen::MatrixXd x(numSamples, numInputs);
+    for (int i = 0; i < numSamples; i++)
+        for (int nx = 0; nx < numInputs; nx++)
+            x(i, nx) = uniform(generator);
+
+    Eigen::MatrixXd batchMean, batchVar;
+    start = std::chrono::steady_clock::now();
+    surrogate.predictLatent(x, batchMean, batchVar);
+    double batchTime = SecondsSince(start);
+
+    Eigen::MatrixXd oneMean(numSamples, numOutputs), oneVar(numSamples, numOutputs), mean, var;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numSamples; i++)
+    {
+        surrogate.predictLatent(x.row(i), mean, var);
+        oneMean.row(i) = mean;
+        oneVar.row(i) = var;
+    }
+    double oneTime = SecondsSince(start);
+
+    double maxDiff = std::max((batchMean - oneMean).cwiseAbs().maxCoeff(), (batchVar - oneVar).cwiseAbs().maxCoeff());
+
+    std::cout << numTrain << " training samples, " << numInputs << " inputs, " << numOutputs << " outputs\n";
+    std::cout << "load:      " << loadTime << " s\n";
+    std::cout << "batch:     " << numSamples / batchTime << " samples/s\n";
+    std::cout << "one by one " << numSamples / oneTime << " samples/s\n";
+    std::cout << "max difference " << maxDiff << "\n";
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
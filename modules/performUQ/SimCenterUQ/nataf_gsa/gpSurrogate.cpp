@@ -0,0 +1,643 @@
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+/**
+ *  @date    10/2026
+ *  @section DESCRIPTION
+ *  In-process evaluation of the Gaussian process surrogate models trained by surrogateBuild.py
+ */
+
+#include "gpSurrogate.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+using json = nlohmann::json;
+
+namespace {
+
+	// Samples are predicted in blocks so that the cross-kernel matrix of a block stays small
+	const int blockSize = 1024;
+
+	// Jitter GPy adds to the diagonal of the training kernel matrix
+	const double gpyJitter = 1.0e-8;
+
+	// scipy.stats.norm.ppf(0.05) and norm.ppf(0.95)
+	const double z05 = -1.6448536269514729;
+	const double z95 = 1.6448536269514722;
+
+	//
+	// Normal random numbers of numpy's legacy RandomState, which gpPredict.py seeds with np.random.seed:
+	// MT19937 seeded with init_genrand and the polar method, which keeps the second value of each pair
+	//
+
+	class legacyNormal
+	{
+	public:
+		legacyNormal(unsigned long seed) : generator((std::mt19937::result_type) (seed & 0xffffffffUL)), hasGauss(false), gauss(0) {}
+
+		double next()
+		{
+			if (hasGauss) {
+				hasGauss = false;
+				return gauss;
+			}
+			double x1, x2, r2;
+			do {
+				x1 = 2.0 * uniform() - 1.0;
+				x2 = 2.0 * uniform() - 1.0;
+				r2 = x1 * x1 + x2 * x2;
+			} while (r2 >= 1.0 || r2 == 0.0);
+			double f = std::sqrt(-2.0 * std::log(r2) / r2);
+			gauss = f * x1;
+			hasGauss = true;
+			return f * x2;
+		}
+
+	private:
+		double uniform()
+		{
+			unsigned long a = generator() >> 5, b = generator() >> 6;
+			return (a * 67108864.0 + b) / 9007199254740992.0;
+		}
+
+		std::mt19937 generator;
+		bool hasGauss;
+		double gauss;
+	};
+
+	// printf formatting of a value as python formats it, which prints nan and inf without a sign or digits
+	string formatValue(const char* format, double value)
+	{
+		if (std::isnan(value))
+			return "nan";
+		if (std::isinf(value))
+			return value > 0 ? "inf" : "-inf";
+		char buffer[64];
+		snprintf(buffer, sizeof(buffer), format, value);
+		return buffer;
+	}
+
+	// np.nan_to_num, applied by gpPredict.py to an output column only if it contains a nan
+	void nanToNum(Eigen::Ref<Eigen::VectorXd> values)
+	{
+		if (!values.hasNaN())
+			return;
+		for (Eigen::Index i = 0; i < values.size(); i++) {
+			if (std::isnan(values(i)))
+				values(i) = 0.0;
+			else if (std::isinf(values(i)))
+				values(i) = values(i) > 0 ? DBL_MAX : -DBL_MAX;
+		}
+	}
+
+	// values of a GPy parameter, saved as a list
+	vector<double> paramValues(const json& param)
+	{
+		vector<double> values;
+		if (param.is_array()) {
+			for (auto& val : param)
+				values.push_back(val.get<double>());
+		} else {
+			values.push_back(param.get<double>());
+		}
+		return values;
+	}
+
+}
+
+gpSurrogate::gpSurrogate(void) : isLoaded(false), xdim(0), ydim(0), kernType(rbfKernel), doLogtransform(false), doLinear(false),
+	varThres(0.02), seed(42) {}
+
+gpSurrogate::~gpSurrogate() {}
+
+bool gpSurrogate::loadModel(string inputJsonPath, string templateDir)
+{
+	isLoaded = false;
+	models.clear();
+
+	// a json entry that is missing or of another type than gpPredict.py expects leaves the model to it
+	try {
+		isLoaded = readModel(inputJsonPath, templateDir);
+	} catch (json::exception& e) {
+		message = string("unexpected surrogate model or input json, ") + e.what();
+		isLoaded = false;
+	}
+	if (!isLoaded)
+		models.clear();
+	return isLoaded;
+}
+
+bool gpSurrogate::readModel(string inputJsonPath, string templateDir)
+{
+	std::ifstream inputFile(inputJsonPath);
+	json inp = json::parse(inputFile, nullptr, false);
+	if (inp.is_discarded()) {
+		message = "could not read " + inputJsonPath;
+		return false;
+	}
+
+	//
+	// surrogate model file and prediction options of the FEM application
+	//
+
+	json femData = inp["Applications"]["FEM"].value("ApplicationData", json::object());
+	if (!femData.contains("mainScript") || !femData["mainScript"].is_string()) {
+		message = "the surrogate model file is not given";
+		return false;
+	}
+	string surrogatePath = templateDir + "/" + femData["mainScript"].get<string>();
+
+	json femOptions = inp.value("FEM", json::object());
+	varThres = femOptions.value("varThres", 0.02);
+	femOption = femOptions.value("femOption", "continue");
+	predictionOption = femOptions.value("predictionOption", "random");
+	std::transform(predictionOption.begin(), predictionOption.end(), predictionOption.begin(), ::tolower);
+
+	json seedValue = femOptions.value("gpSeed", json());
+	if (seedValue.is_null()) {
+		seedValue = 42;
+		if (inp["UQ"]["samplingMethodData"].contains("seed"))
+			seedValue = inp["UQ"]["samplingMethodData"]["seed"];
+	}
+	if (seedValue.is_number()) {
+		seed = (long long) seedValue.get<double>();
+	} else if (seedValue.is_string()) {
+		char* end;
+		string seedString = seedValue.get<string>();
+		seed = std::strtoll(seedString.c_str(), &end, 10);
+		if (seedString.empty() || *end != '\0') {
+			message = "the seed " + seedString + " is not an integer";
+			return false;
+		}
+	} else {
+		message = "the seed is not an integer";
+		return false;
+	}
+
+	//
+	// the surrogate model
+	//
+
+	std::ifstream surrogateFile(surrogatePath);
+	json sur = json::parse(surrogateFile, nullptr, false);
+	if (sur.is_discarded()) {
+		message = "could not read the surrogate model " + surrogatePath;
+		return false;
+	}
+
+	if (sur.value("isEEUQ", false) || sur.value("isWEUQ", false) || sur.value("isHydroUQ", false)) {
+		message = "models of the EE-UQ, WE-UQ and Hydro-UQ workflows are evaluated by gpPredict.py";
+		return false;
+	}
+	if (sur.contains("intensityMeasureInfo") && !sur["intensityMeasureInfo"].is_null()) {
+		message = "models with intensity measure inputs are evaluated by gpPredict.py";
+		return false;
+	}
+	if (sur.value("doMultiFidelity", false)) {
+		message = "multi-fidelity models are evaluated by gpPredict.py";
+		return false;
+	}
+	for (auto& stochastic : sur["doStochastic"]) {
+		if (stochastic.get<bool>()) {
+			message = "models with heteroscedastic noise are evaluated by gpPredict.py";
+			return false;
+		}
+	}
+	json hfInfo = sur["highFidelityInfo"];
+	if (hfInfo.contains("constIdx") && hfInfo["constIdx"].is_array() && hfInfo["constIdx"].size() > 0) {
+		message = "models with constant outputs are evaluated by gpPredict.py";
+		return false;
+	}
+
+	string kernel = sur["kernName"];
+	if (kernel == "Radial Basis") {
+		kernName = "rbf";
+		kernType = rbfKernel;
+	} else if (kernel == "Exponential") {
+		kernName = "Exponential";
+		kernType = exponentialKernel;
+	} else if (kernel == "Matern 3/2") {
+		kernName = "Mat32";
+		kernType = matern32Kernel;
+	} else if (kernel == "Matern 5/2") {
+		kernName = "Mat52";
+		kernType = matern52Kernel;
+	} else {
+		message = "unknown kernel " + kernel;
+		return false;
+	}
+
+	doLogtransform = sur["doLogtransform"];
+	doLinear = sur.value("doLinear", false);
+	xlabels = sur["xlabels"].get<vector<string>>();
+	ylabels = sur["ylabels"].get<vector<string>>();
+	xdim = xlabels.size();
+	ydim = ylabels.size();
+	int nsamp = hfInfo["valSamp"];
+
+	Eigen::MatrixXd X(nsamp, xdim);
+	for (int nx = 0; nx < xdim; nx++) {
+		vector<double> xExact = sur["xExact"][xlabels[nx]];
+		if ((int)xExact.size() != nsamp) {
+			message = "the number of training samples of " + xlabels[nx] + " is not " + std::to_string(nsamp);
+			return false;
+		}
+		X.col(nx) = Eigen::Map<Eigen::VectorXd>(xExact.data(), nsamp);
+	}
+
+	//
+	// EDPs of the workflow, picked from the outputs of the model
+	//
+
+	gIdx.clear();
+	gNames.clear();
+	for (auto& edp : inp["EDP"]) {
+		string edpName = edp["name"];
+		int length = edp["length"];
+		for (int i = 0; i < length; i++) {
+			string name = (length == 1) ? edpName : edpName + "_" + std::to_string(i + 1);
+			auto found = std::find(ylabels.begin(), ylabels.end(), name);
+			if (found == ylabels.end()) {
+				message = "qoi " + edpName + " is not an output of the surrogate model";
+				return false;
+			}
+			gIdx.push_back(found - ylabels.begin());
+			gNames.push_back(name);
+		}
+	}
+
+	//
+	// factorize the kernel matrix of the training samples of each output once
+	//
+
+	for (int ny = 0; ny < ydim; ny++) {
+		outputModel model;
+		json info = sur["modelInfo"][ylabels[ny]];
+
+		string varName = kernName + ".variance", lenName = kernName + ".lengthscale", noiseName = "Gaussian_noise.variance";
+		for (auto& par : info.items()) {
+			if (par.key() != varName && par.key() != lenName && par.key() != noiseName) {
+				message = "unknown parameter " + par.key() + " of the surrogate model";
+				return false;
+			}
+		}
+		if (!info.contains(varName) || !info.contains(lenName) || !info.contains(noiseName)) {
+			message = "missing parameters of the surrogate model of " + ylabels[ny];
+			return false;
+		}
+
+		model.variance = paramValues(info[varName])[0];
+		double noise = paramValues(info[noiseName])[0];
+		vector<double> lengthscale = paramValues(info[lenName]);
+		if (lengthscale.size() == 1)
+			lengthscale.resize(xdim, lengthscale[0]);
+		model.invLengthscale = Eigen::Map<Eigen::VectorXd>(lengthscale.data(), xdim).cwiseInverse();
+
+		vector<double> yExact = sur["yExact"][ylabels[ny]];
+		if ((int)yExact.size() != nsamp) {
+			message = "the number of training samples of " + ylabels[ny] + " is not " + std::to_string(nsamp);
+			return false;
+		}
+		Eigen::VectorXd y = Eigen::Map<Eigen::VectorXd>(yExact.data(), nsamp);
+		if (doLogtransform)
+			y = y.array().log();
+
+		model.linIntercept = 0;
+		if (doLinear) {
+			json lin = sur["modelInfo"][ylabels[ny] + "_Lin"];
+			vector<double> coef = paramValues(lin["coef"]);
+			if ((int)coef.size() != xdim) {
+				message = "the linear trend of " + ylabels[ny] + " does not match the inputs";
+				return false;
+			}
+			model.linCoef = Eigen::Map<Eigen::VectorXd>(coef.data(), xdim);
+			model.linIntercept = paramValues(lin["intercept"])[0];
+			y.array() -= (X * model.linCoef).array() + model.linIntercept;
+		}
+
+		// GPy's Standardize normalizer
+		model.yMean = y.mean();
+		model.dataVar = (y.array() - model.yMean).square().mean();
+		model.yStd = std::sqrt(model.dataVar);
+		model.nugget = noise * model.dataVar;
+		Eigen::VectorXd yNorm = (y.array() - model.yMean) / model.yStd;
+
+		model.scaledX = X * model.invLengthscale.asDiagonal();
+		model.scaledXsq = model.scaledX.rowwise().squaredNorm();
+
+		Eigen::MatrixXd R2 = (-2.0 * model.scaledX * model.scaledX.transpose()).colwise() + model.scaledXsq;
+		R2.rowwise() += model.scaledXsq.transpose();
+		applyKernel(R2, model.variance);
+		Eigen::MatrixXd& K = R2;
+		K.diagonal().array() += noise + gpyJitter;
+
+		// like GPy's jitchol, add jitter only if the factorization fails
+		Eigen::LLT<Eigen::MatrixXd> llt(K);
+		double jitter = K.diagonal().mean() * 1.0e-6;
+		for (int ntry = 0; (llt.info() != Eigen::Success) && (ntry < 5); ntry++) {
+			Eigen::MatrixXd Kjit = K;
+			Kjit.diagonal().array() += jitter;
+			llt.compute(Kjit);
+			jitter *= 10;
+		}
+		if (llt.info() != Eigen::Success) {
+			message = "the kernel matrix of " + ylabels[ny] + " is not positive definite";
+			return false;
+		}
+		model.L = llt.matrixL();
+		model.alpha = llt.solve(yNorm);
+
+		models.push_back(model);
+	}
+
+	message = "";
+	return true;
+}
+
+void gpSurrogate::applyKernel(Eigen::MatrixXd& R2, double variance) const
+{
+	// GPy's stationary kernels of the scaled distance r, applied in place to the squared distances
+	Eigen::ArrayXXd r2 = R2.array().max(0.0);
+	if (kernType == rbfKernel) {
+		R2 = variance * (-0.5 * r2).exp();
+		return;
+	}
+	Eigen::ArrayXXd r = r2.sqrt();
+	if (kernType == exponentialKernel)
+		R2 = variance * (-r).exp();
+	else if (kernType == matern32Kernel)
+		R2 = variance * (1.0 + std::sqrt(3.0) * r) * (-std::sqrt(3.0) * r).exp();
+	else
+		R2 = variance * (1.0 + std::sqrt(5.0) * r + 5.0 / 3.0 * r2) * (-std::sqrt(5.0) * r).exp();
+}
+
+void gpSurrogate::predictLatent(const Eigen::MatrixXd& x, Eigen::MatrixXd& mean, Eigen::MatrixXd& var) const
+{
+	int nsamp = x.rows();
+	mean.resize(nsamp, ydim);
+	var.resize(nsamp, ydim);
+
+	for (int ny = 0; ny < ydim; ny++) {
+		const outputModel& model = models[ny];
+		for (int first = 0; first < nsamp; first += blockSize) {
+			int nb = std::min(blockSize, nsamp - first);
+
+			// squared scaled distances to the training samples, |x|^2 + |t|^2 - 2 x t' for the whole block
+			Eigen::MatrixXd xs = x.middleRows(first, nb) * model.invLengthscale.asDiagonal();
+			Eigen::MatrixXd R2 = (-2.0 * xs * model.scaledX.transpose()).colwise() + xs.rowwise().squaredNorm();
+			R2.rowwise() += model.scaledXsq.transpose();
+			applyKernel(R2, model.variance);
+			const Eigen::MatrixXd& Ks = R2;
+
+			// noiseless posterior of the normalized outputs
+			Eigen::VectorXd mu = Ks * model.alpha;
+			Eigen::MatrixXd V = model.L.triangularView<Eigen::Lower>().solve(Ks.transpose());
+			Eigen::VectorXd v = (model.variance - V.colwise().squaredNorm().transpose().array()).max(1.0e-15);
+
+			mean.col(ny).segment(first, nb) = mu.array() * model.yStd + model.yMean;
+			var.col(ny).segment(first, nb) = v * model.dataVar;
+			if (doLinear)
+				mean.col(ny).segment(first, nb).array() += (x.middleRows(first, nb) * model.linCoef).array() + model.linIntercept;
+		}
+	}
+}
+
+bool gpSurrogate::evaluate(string runDir, int sampNum, const vector<string>& names, const vector<vector<double>>& xvals, vector<vector<double>>& gvals)
+{
+	int nsamp = xvals.size();
+
+	//
+	// inputs of the model, and the other variables that are only written to the tab file
+	//
+
+	vector<int> inputIdx(xdim, -1), dummyIdx;
+	vector<string> dummyNames;
+	for (int j = 0; j < (int)names.size(); j++) {
+		auto found = std::find(xlabels.begin(), xlabels.end(), names[j]);
+		if (found == xlabels.end()) {
+			dummyIdx.push_back(j);
+			dummyNames.push_back(names[j]);
+		} else {
+			inputIdx[found - xlabels.begin()] = j;
+		}
+	}
+	for (int nx = 0; nx < xdim; nx++) {
+		if (inputIdx[nx] < 0) {
+			message = "input " + xlabels[nx] + " of the surrogate model is not a random variable";
+			return false;
+		}
+	}
+
+	// the values as gpPredict.py reads them from params.in
+	auto paramsValue = [](double value) {
+		char buffer[64];
+		snprintf(buffer, sizeof(buffer), "%.15e", value);
+		return std::atof(buffer);
+	};
+
+	Eigen::MatrixXd X(nsamp, xdim), dummyX(nsamp, dummyIdx.size());
+	for (int ns = 0; ns < nsamp; ns++) {
+		for (int nx = 0; nx < xdim; nx++)
+			X(ns, nx) = paramsValue(xvals[ns][inputIdx[nx]]);
+		for (int nd = 0; nd < (int)dummyIdx.size(); nd++)
+			dummyX(ns, nd) = paramsValue(xvals[ns][dummyIdx[nd]]);
+	}
+
+	//
+	// predict all samples, and draw the random predictions in the order of gpPredict.py
+	//
+
+	Eigen::MatrixXd mu, var;
+	predictLatent(X, mu, var);
+
+	Eigen::MatrixXd varM(nsamp, ydim), median(nsamp, ydim), predVar(nsamp, ydim), predVarM(nsamp, ydim), samp(nsamp, ydim);
+	Eigen::MatrixXd q1(nsamp, ydim), q3(nsamp, ydim), q1m(nsamp, ydim), q3m(nsamp, ydim);
+
+	legacyNormal normal(seed + sampNum);
+	for (int ny = 0; ny < ydim; ny++) {
+		for (int ns = 0; ns < nsamp; ns++) {
+			double m = mu(ns, ny), v = var(ns, ny), vm = v + models[ny].nugget;
+			double s = m + std::sqrt(vm) * normal.next();
+			varM(ns, ny) = vm;
+			if (doLogtransform) {
+				median(ns, ny) = std::exp(m);
+				predVar(ns, ny) = std::exp(2 * m + v) * (std::exp(v) - 1);
+				predVarM(ns, ny) = std::exp(2 * m + vm) * (std::exp(vm) - 1);
+				samp(ns, ny) = std::exp(s);
+				q1(ns, ny) = std::exp(m + std::sqrt(v) * z05);
+				q3(ns, ny) = std::exp(m + std::sqrt(v) * z95);
+				q1m(ns, ny) = std::exp(m + std::sqrt(vm) * z05);
+				q3m(ns, ny) = std::exp(m + std::sqrt(vm) * z95);
+			} else {
+				median(ns, ny) = m;
+				predVar(ns, ny) = v;
+				predVarM(ns, ny) = vm;
+				samp(ns, ny) = s;
+				q1(ns, ny) = m + std::sqrt(v) * z05;
+				q3(ns, ny) = m + std::sqrt(v) * z95;
+				q1m(ns, ny) = m + std::sqrt(vm) * z05;
+				q3m(ns, ny) = m + std::sqrt(vm) * z95;
+			}
+		}
+		nanToNum(samp.col(ny));
+		nanToNum(predVar.col(ny));
+		nanToNum(predVarM.col(ny));
+	}
+
+	//
+	// accuracy of each sample, the largest prediction variance relative to the data variance
+	//
+
+	vector<double> maxRatio(nsamp);
+	vector<int> maxIdx(nsamp);
+	vector<bool> isAccurate(nsamp);
+	for (int ns = 0; ns < nsamp; ns++) {
+		maxRatio[ns] = varM(ns, 0) / models[0].dataVar;
+		maxIdx[ns] = 0;
+		for (int ny = 1; ny < ydim && !std::isnan(maxRatio[ns]); ny++) {
+			double ratio = varM(ns, ny) / models[ny].dataVar;
+			if (ratio > maxRatio[ns] || std::isnan(ratio)) {
+				maxRatio[ns] = ratio;
+				maxIdx[ns] = ny;
+			}
+		}
+		isAccurate[ns] = maxRatio[ns] < varThres;
+		if (!isAccurate[ns] && (femOption == "doSimulation" || femOption == "giveError")) {
+			message = "sample " + std::to_string(sampNum + ns) + " is not accurate and femOption is " + femOption;
+			return false;
+		}
+	}
+
+	//
+	// results.out, the log and the tab files
+	//
+
+	bool useMedian = (predictionOption.rfind("median", 0) == 0);
+	bool useRandom = (predictionOption.rfind("rand", 0) == 0);
+	string folderName = std::filesystem::path(runDir).filename().string();
+	string folderStem = folderName.substr(0, folderName.find('.'));
+
+	std::filesystem::create_directories(runDir);
+	string parentDir = std::filesystem::path(runDir).parent_path().string();
+	std::ofstream errFile(parentDir + "/surrogate.err");
+	errFile.close();
+
+	std::ofstream logFile(runDir + "/surrogateLog.log", std::ios::app);
+	std::ofstream resultsFile(runDir + "/results.out");
+	int ng = gIdx.size();
+	gvals.assign(nsamp, vector<double>(ng, 0.0));
+	Eigen::MatrixXd ypred = Eigen::MatrixXd::Zero(nsamp, ng);
+	for (int ns = 0; ns < nsamp; ns++) {
+		char ratio[64];
+		snprintf(ratio, sizeof(ratio), "%.2f", maxRatio[ns] * 100);
+		string errLevel = "Prediction error level of output " + std::to_string(maxIdx[ns] + 1) + " is " + (std::isnan(maxRatio[ns]) ? string("nan") : string(ratio)) + "%";
+		string msg0 = folderStem + "." + std::to_string(sampNum + ns) + " : ";
+
+		bool usePrediction = true;
+		if (!isAccurate[ns]) {
+			char thres[64];
+			snprintf(thres, sizeof(thres), "%.2f", varThres * 100);
+			if (femOption == "continue")
+				logFile << msg0 << errLevel << ", which is greater than threshold=" << thres << "%  - CONTINUE [Warning: results may not be accurate]\n";
+			else
+				usePrediction = false;
+		} else {
+			logFile << msg0 << errLevel << "\n";
+		}
+
+		if (usePrediction) {
+			for (int i = 0; i < ng; i++) {
+				if (useMedian)
+					ypred(ns, i) = median(ns, gIdx[i]);
+				else if (useRandom)
+					ypred(ns, i) = samp(ns, gIdx[i]);
+			}
+		}
+
+		// the values are read back from results.out by the workflow, keep them as they are written
+		for (int i = 0; i < ng; i++) {
+			string val = formatValue("%.5e", ypred(ns, i));
+			resultsFile << (i > 0 ? " " : "") << val;
+			gvals[ns][i] = std::atof(val.c_str());
+		}
+		resultsFile << "\n";
+	}
+	resultsFile.close();
+	logFile.close();
+
+	if (sampNum == 1) {
+		std::ofstream headerFile(parentDir + "/surrogateTabHeader.out");
+		headerFile << "%eval_id interface ";
+		for (auto& name : xlabels)
+			headerFile << name << " ";
+		for (auto& name : dummyNames)
+			headerFile << name << " ";
+		for (string suffix : { "", ".median", ".q5", ".q95", ".var", ".q5_w_mnoise", ".q95_w_mnoise", ".var_w_mnoise" }) {
+			for (auto& name : gNames)
+				headerFile << name << suffix << " ";
+		}
+		headerFile << "\n";
+		headerFile.close();
+	}
+
+	std::ofstream tabFile(parentDir + "/surrogateTab.out", std::ios::app);
+	for (int ns = 0; ns < nsamp; ns++) {
+		tabFile << sampNum + ns << " NO_ID ";
+		string rvList;
+		for (int nx = 0; nx < xdim; nx++)
+			rvList += formatValue("%e", X(ns, nx)) + " ";
+		for (int nd = 0; nd < dummyX.cols(); nd++)
+			rvList += formatValue("%e", dummyX(ns, nd)) + " ";
+		tabFile << rvList;
+		for (auto values : { &ypred, &median, &q1, &q3, &predVar, &q1m, &q3m, &predVarM }) {
+			for (int i = 0; i < ng; i++) {
+				double value = (values == &ypred) ? ypred(ns, i) : (*values)(ns, gIdx[i]);
+				tabFile << formatValue("%e", value) << " ";
+			}
+		}
+		tabFile << "\n";
+	}
+	tabFile.close();
+
+	return true;
+}
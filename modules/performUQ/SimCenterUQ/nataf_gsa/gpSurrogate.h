@@ -0,0 +1,119 @@
+#ifndef GP_SURROGATE_H
+#define GP_SURROGATE_H
+
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+/**
+ *  @date    10/2026
+ *  @section DESCRIPTION
+ *  In-process evaluation of the Gaussian process surrogate models trained by surrogateBuild.py,
+ *  reproducing the predictions of performFEM/surrogateGP/gpPredict.py without starting python
+ */
+
+#include <string>
+#include <vector>
+#include <random>
+#include "Eigen/Dense"
+
+using std::string;
+using std::vector;
+
+class gpSurrogate
+{
+public:
+	gpSurrogate(void);
+	~gpSurrogate();
+
+	// Reads the surrogate model file and the prediction options of the input json once. Returns false,
+	// with the reason in message, if the model uses features only gpPredict.py supports (stochastic or
+	// multi-fidelity models, intensity measure inputs, EE/WE/Hydro-UQ workflows).
+	bool loadModel(string inputJsonPath, string templateDir);
+
+	// Predicts the noiseless mean and variance of the GP of each output (log and linear trend included,
+	// as gpPredict.py computes them before back transformation) for samples x [nsamp x xdim], ordered as
+	// the xlabels of the model. The cross-kernel matrix of a block of samples is formed at once.
+	void predictLatent(const Eigen::MatrixXd& x, Eigen::MatrixXd& mean, Eigen::MatrixXd& var) const;
+
+	// Evaluates the samples of the variables named in names, as they would be written to params.in, and
+	// writes results.out and surrogateLog.log to runDir and the surrogateTab files to its parent directory
+	// like gpPredict.py does. sampNum is the number of the first sample (that of the workdir). Returns
+	// false, before writing anything, if a sample has to be simulated or has to stop the analysis, so that
+	// the caller can hand the batch to gpPredict.py.
+	bool evaluate(string runDir, int sampNum, const vector<string>& names, const vector<vector<double>>& xvals, vector<vector<double>>& gvals);
+
+	bool isLoaded;
+	string message;
+
+	int xdim, ydim;
+	vector<string> xlabels, ylabels;
+
+private:
+	struct outputModel
+	{
+		Eigen::VectorXd invLengthscale;   // 1/lengthscale of each input
+		double variance;                  // kernel variance
+		Eigen::MatrixXd L;                // cholesky factor of K + noise I of the training samples
+		Eigen::VectorXd alpha;            // (K + noise I)^-1 y of the normalized training outputs
+		Eigen::MatrixXd scaledX;          // training inputs divided by the lengthscales
+		Eigen::VectorXd scaledXsq;        // squared norms of the rows of scaledX
+		double yMean, yStd;               // normalization of the training outputs
+		double nugget;                    // measurement noise variance in the output space
+		double dataVar;                   // variance of the training outputs
+		Eigen::VectorXd linCoef;          // linear trend, if any
+		double linIntercept;
+	};
+
+	enum kernelType { rbfKernel, exponentialKernel, matern32Kernel, matern52Kernel };
+
+	bool readModel(string inputJsonPath, string templateDir);
+	void applyKernel(Eigen::MatrixXd& R2, double variance) const;
+
+	string kernName;
+	kernelType kernType;
+	bool doLogtransform, doLinear;
+	vector<outputModel> models;
+
+	// prediction options of the FEM entry of the input json
+	double varThres;
+	string femOption, predictionOption;
+	long long seed;
+	vector<int> gIdx;
+	vector<string> gNames;
+};
+
+#endif // GP_SURROGATE_H
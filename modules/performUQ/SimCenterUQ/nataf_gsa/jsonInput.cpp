@@ -73,6 +73,7 @@ jsonInput::jsonInput(string workDir, string inpFile, int procno)
 	if (jsonPath.is_relative()){
 		jsonPath  = workDir + "/templatedir/" + inpFile;
 	}
+	jsonFilePath = jsonPath.u8string();
 
 	std::ifstream myfile(jsonPath.make_preferred());
 	if (!myfile.is_open()) {
@@ -69,6 +69,7 @@ public:
 	virtual ~jsonInput(void);
 
 	string workDir;
+	string jsonFilePath;
 	string uqType, uqMethod;
 
 	int nmc, nrv, nco, nre, nst, nreg, nqoi, rseed, ngr, nPilot;
@@ -0,0 +1,68 @@
+// Evaluates a surrogate model with the in-process evaluator of nataf_gsa, in the way the workflow driver
+// runs gpPredict.py, so that runGpSurrogateTest.py can compare the files both of them write.
+//
+// Usage: gpSurrogateCheck params.in inputFile.json
+//
+// Run it in a workdir.N folder holding params.in, the input json and the surrogate model named in the
+// input json. Exits with 2 if the model has to be evaluated by gpPredict.py.
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "../gpSurrogate.h"
+
+int main(int argc, char** argv)
+{
+	if (argc < 3) {
+		std::cerr << "Usage: gpSurrogateCheck params.in inputFile.json\n";
+		return 1;
+	}
+
+	// numeric variables of params.in, as gpPredict.py reads them
+	std::ifstream paramsFile(argv[1]);
+	int nrv = 0;
+	paramsFile >> nrv;
+	std::string line;
+	std::getline(paramsFile, line);
+
+	vector<string> names;
+	vector<vector<double>> columns;
+	for (int i = 0; i < nrv && std::getline(paramsFile, line); i++) {
+		std::istringstream values(line);
+		string name, value;
+		values >> name;
+		vector<double> column;
+		while (values >> value) {
+			char* end;
+			double val = std::strtod(value.c_str(), &end);
+			if (*end != '\0')
+				break;
+			column.push_back(val);
+		}
+		if (column.empty())
+			continue;
+		names.push_back(name);
+		columns.push_back(column);
+	}
+
+	int nsamp = columns.empty() ? 0 : columns[0].size();
+	vector<vector<double>> xvals(nsamp, vector<double>(names.size()));
+	for (int ns = 0; ns < nsamp; ns++)
+		for (size_t j = 0; j < names.size(); j++)
+			xvals[ns][j] = columns[j][ns];
+
+	string runDir = std::filesystem::current_path().string();
+	string folderName = std::filesystem::path(runDir).filename().string();
+	int sampNum = std::atoi(folderName.substr(folderName.rfind('.') + 1).c_str());
+
+	gpSurrogate surrogate;
+	vector<vector<double>> gvals;
+	if (!surrogate.loadModel(argv[2], runDir) || !surrogate.evaluate(runDir, sampNum, names, xvals, gvals)) {
+		std::cerr << "gpSurrogateCheck: " << surrogate.message << "\n";
+		return 2;
+	}
+
+	return 0;
+}
@@ -0,0 +1,227 @@
+"""Accuracy test of the in-process surrogate evaluator of nataf_gsa.
+
+Surrogate models of every kernel, with and without log transform and linear
+trend, are evaluated by gpPredict.py and by gpSurrogateCheck in the same
+kind of workdir. The results.out, surrogateTab.out, surrogateTabHeader.out and
+surrogateLog.log files of both have to agree, numbers to the printed digits.
+
+Usage:
+    python runGpSurrogateTest.py <path to gpSurrogateCheck> [path to gpPredict.py]
+"""  # noqa: INP001
+
+import json
+import math
+import random
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+test_dir = Path(__file__).resolve().parent
+gp_predict_default = (
+    test_dir.parents[3] / 'performFEM' / 'surrogateGP' / 'gpPredict.py'
+)
+
+kernels = {
+    'Radial Basis': 'rbf',
+    'Exponential': 'Exponential',
+    'Matern 3/2': 'Mat32',
+    'Matern 5/2': 'Mat52',
+}
+
+# outputs of the model, the EDPs of the workflow are g1 and g of length 2
+xlabels = ['x1', 'x2', 'x3']
+ylabels = ['g1', 'g_1', 'g_2']
+
+
+def write_case(case_dir, kernel, do_log, do_linear, prediction_option, num_samples):
+    """Write the surrogate model, input json and params.in of a test case."""
+    rng = random.Random(f'{kernel} {do_log} {do_linear}')
+    num_train = 40
+
+    x_exact = {x: [rng.uniform(-1.0, 2.0) for _ in range(num_train)] for x in xlabels}
+    y_exact = {}
+    model_info = {}
+    for ny, y in enumerate(ylabels):
+        values = []
+        for i in range(num_train):
+            x1, x2, x3 = (x_exact[x][i] for x in xlabels)
+            values.append(
+                math.exp(0.3 * x1 - 0.2 * x2 * x3 + 0.1 * ny) + 0.2 * math.sin(3 * x1)
+            )
+        if not do_log:
+            values = [v - 1.0 for v in values]
+        y_exact[y] = values
+
+        name = kernels[kernel]
+        model_info[y] = {
+            f'{name}.variance': [0.8 + 0.1 * ny],
+            f'{name}.lengthscale': [0.7, 1.3 + 0.2 * ny, 2.1],
+            'Gaussian_noise.variance': [1.0e-3 * (ny + 1)],
+        }
+        model_info[y + '_Var'] = 0
+        if do_linear:
+            model_info[y + '_Lin'] = {
+                'predictorList': [],
+                'coef': [0.05, -0.02 * ny, 0.01],
+                'intercept': 0.1,
+            }
+
+    surrogate = {
+        'doStochastic': [False] * len(ylabels),
+        'doNormalization': False,
+        'doLogtransform': do_log,
+        'doLinear': do_linear,
+        'doMultiFidelity': False,
+        'kernName': kernel,
+        'xdim': len(xlabels),
+        'ydim': len(ylabels),
+        'xlabels': xlabels,
+        'ylabels': ylabels,
+        'xExact': x_exact,
+        'yExact': y_exact,
+        'highFidelityInfo': {'valSamp': num_train},
+        'modelInfo': model_info,
+    }
+    with open(case_dir / 'surrogate.json', 'w') as f:  # noqa: PTH123
+        json.dump(surrogate, f)
+
+    inp = {
+        'Applications': {
+            'FEM': {
+                'Application': 'SurrogateGP',
+                'ApplicationData': {
+                    'mainScript': 'surrogate.json',
+                    'postprocessScript': '',
+                },
+            }
+        },
+        'FEM': {
+            'varThres': 0.02,
+            'femOption': 'continue',
+            'predictionOption': prediction_option,
+            'gpSeed': 7,
+        },
+        'EDP': [{'name': 'g1', 'length': 1}, {'name': 'g', 'length': 2}],
+        'UQ': {'samplingMethodData': {'seed': 3}},
+    }
+    with open(case_dir / 'scInput.json', 'w') as f:  # noqa: PTH123
+        json.dump(inp, f)
+
+    # samples inside and outside of the training domain, and a variable the model does not use
+    with open(case_dir / 'params.in', 'w') as f:  # noqa: PTH123
+        f.write(f'{len(xlabels) + 1}\n')
+        for x in ['x2', 'c1', 'x1', 'x3']:
+            values = [rng.uniform(-2.0, 3.0) for _ in range(num_samples)]
+            f.write(x + ' ' + ' '.join(f'{v:.15e}' for v in values) + '\n')
+
+
+def read_numbers(path):
+    """Return the lines of a file split into fields."""
+    rows = []
+    with open(path) as f:  # noqa: PTH123
+        for line in f:
+            rows.append(line.split())
+    return rows
+
+
+def compare_numbers(rows, expected_rows, name):
+    """Return a description of the first difference between two files of numbers."""
+    if len(rows) != len(expected_rows):
+        return f'{name}: {len(rows)} rows != {len(expected_rows)}'
+    for i, (row, expected_row) in enumerate(zip(rows, expected_rows)):
+        if len(row) != len(expected_row):
+            return f'{name} row {i}: {len(row)} columns != {len(expected_row)}'
+        for j, (value, expected) in enumerate(zip(row, expected_row)):
+            if value == expected:
+                continue
+            try:
+                a, b = float(value), float(expected)
+            except ValueError:
+                return f'{name} row {i} column {j}: {value} != {expected}'
+            # the files hold 6 significant digits, allow the last one to round differently
+            if not math.isclose(a, b, rel_tol=2.0e-5, abs_tol=1.0e-300):
+                return f'{name} row {i} column {j}: {value} != {expected}'
+    return None
+
+
+def run_case(check_path, gp_predict_path, work_dir, case):
+    """Evaluate a case with gpPredict.py and gpSurrogateCheck and compare their files."""
+    runs = {}
+    for run in ('python', 'native'):
+        run_dir = work_dir / run / 'workdir.1'
+        run_dir.mkdir(parents=True)
+        write_case(run_dir, *case)
+        if run == 'python':
+            command = [
+                sys.executable,
+                str(gp_predict_path),
+                'params.in',
+                'surrogate.json',
+                'scInput.json',
+            ]
+        else:
+            command = [str(check_path), 'params.in', 'scInput.json']
+        result = subprocess.run(  # noqa: S603
+            command, cwd=run_dir, capture_output=True, text=True, check=False
+        )
+        if result.returncode != 0:
+            return [f'{run}: exit code {result.returncode}\n{result.stderr}']
+        runs[run] = run_dir
+
+    failures = []
+    python_dir, native_dir = runs['python'], runs['native']
+    for name, directory in (
+        ('results.out', '.'),
+        ('surrogateTab.out', '..'),
+    ):
+        difference = compare_numbers(
+            read_numbers(native_dir / directory / name),
+            read_numbers(python_dir / directory / name),
+            name,
+        )
+        if difference:
+            failures.append(difference)
+
+    for name, directory in (
+        ('surrogateTabHeader.out', '..'),
+        ('surrogateLog.log', '.'),
+    ):
+        native = (native_dir / directory / name).read_text()
+        expected = (python_dir / directory / name).read_text()
+        if native != expected:
+            failures.append(f'{name}: {native!r} != {expected!r}')
+
+    return failures
+
+
+def main(args):
+    """Run all cases, return the number of failures."""
+    if not args:
+        print(__doc__)  # noqa: T201
+        return 1
+
+    check_path = Path(args[0]).resolve()
+    gp_predict_path = Path(args[1]).resolve() if len(args) > 1 else gp_predict_default
+
+    num_failed = 0
+    for kernel in kernels:
+        for do_log, do_linear in ((False, False), (True, False), (False, True), (True, True)):
+            for prediction_option in ('median', 'random'):
+                case = (kernel, do_log, do_linear, prediction_option, 25)
+                case_name = f'{kernel}, log={do_log}, linear={do_linear}, {prediction_option}'
+                with tempfile.TemporaryDirectory() as work_dir:
+                    failures = run_case(check_path, gp_predict_path, Path(work_dir), case)
+
+                if failures:
+                    num_failed += 1
+                    for failure in failures:
+                        print(f'{case_name} FAILED {failure}')  # noqa: T201
+                else:
+                    print(f'{case_name} passed')  # noqa: T201
+
+    return num_failed
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -21,7 +21,7 @@ int main(int argc, const char **argv)
   const char *filenameEDP = argv[1];
   const char *filenameOUT = argv[2];
   
-  std::ofstream fOut(filenameOUT);
+  std::ostringstream fOut;
 
   json_error_t error;
   json_t *root = json_load_file(filenameEDP, 0, &error);
@@ -78,7 +78,20 @@ int main(int argc, const char **argv)
 
   printf("NUM_EDP= %d\n",numEDP);
 
-  fOut.close();
+  //
+  // an analysis that wrote results.out itself, e.g. OpenSeesPostprocessor
+  // reading a response buffer, leaves the EDP file without values, its
+  // results.out is then kept
+
+  std::ifstream existingOut(filenameOUT, std::ios::binary | std::ios::ate);
+  if (numEDP == 0 && existingOut.is_open() && existingOut.tellg() > 0) {
+    printf("no EDP values in %s, keeping %s\n", filenameEDP, filenameOUT);
+  } else {
+    existingOut.close();
+    std::ofstream fOutFile(filenameOUT);
+    fOutFile << fOut.str();
+    fOutFile.close();
+  }
 
   //
   // process result files
@@ -0,0 +1,133 @@
+// Benchmark of simCenterSub with and without the index of a precompiled template
+//
+// For each number of RVs an OpenSees template like the one createOpenSeesDriver writes is created in a
+// temporary folder, with its index and a params.in of random values. simCenterSub is run on it with the
+// index and without it, where every line of the template is searched for every RV. The wall time per
+// sample of both is reported, and an indexed output that differs from the line by line one is reported
+// as an error.
+//
+// Usage: TemplateSubBenchmark [Google Benchmark options] <path to simCenterSub>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+// Google Benchmark
+#include <benchmark/benchmark.h>
+#include "simCenterSubIndex.h"
+
+namespace
+{
+    // Writes the template, its index and params.in for numRVs RVs
+    void WriteInputs(const std::string &dir, int numRVs)
+    {
+        std::mt19937 generator(numRVs);
+        std::uniform_real_distribution<double> uniform(0.5, 2.0);
+
+        std::ofstream templateFile(dir + "/SimCenterInput.RV", std::ios::binary);
+        std::ofstream params(dir + "/params.in");
+        std::vector<simCenterSubPlaceholder> placeholders;
+
+        params << numRVs << "\n";
+        for (int i = 0; i < numRVs; i++)
+        {
+            std::string rvName = "rv" + std::to_string(i + 1);
+            templateFile << "pset " << rvName << " ";
+            std::string placeholder = "\"RV." + rvName + "\"";
+            placeholders.push_back({(std::size_t)templateFile.tellp(), placeholder.length(), rvName});
+            templateFile << placeholder << "\n";
+            params << rvName << " " << std::scientific << std::setprecision(15) << uniform(generator) << "\n";
+        }
+        templateFile << "\n set listQoI \"1-PFA-0-1 1-PFD-1-1 \"\n\n\n source model.tcl\n";
+
+        std::size_t templateSize = templateFile.tellp();
+        templateFile.close();
+        writeSimCenterSubIndex(dir + "/SimCenterInput.RV.idx", templateSize, placeholders);
+    }
+
+    // Runs simCenterSub once in dir, returns false if it failed
+    bool Run(const std::string &simCenterSub, const std::string &dir, const std::string &output, bool useIndex)
+    {
+        std::string command = "cd \"" + dir + "\" && \"" + simCenterSub + "\" params.in SimCenterInput.RV " + output;
+        if (useIndex)
+            command += " SimCenterInput.RV.idx";
+        return std::system(command.c_str()) == 0;
+    }
+
+    std::string ReadFile(const std::string &fileName)
+    {
+        std::ifstream in(fileName, std::ios::binary);
+        std::ostringstream text;
+        text << in.rdbuf();
+        return text.str();
+    }
+
+    std::string simCenterSub;
+    std::filesystem::path root;
+    int numFailed = 0;
+
+    // Returns the folder of the inputs for numRVs RVs, writing them the first time
+    std::string Inputs(int numRVs)
+    {
+        std::filesystem::path dir = root / std::to_string(numRVs);
+        if (!std::filesystem::exists(dir / "params.in"))
+        {
+            std::filesystem::create_directories(dir);
+            WriteInputs(dir.string(), numRVs);
+        }
+        return dir.string();
+    }
+
+    // Benchmark simCenterSub for the input number of RVs, with or without the index
+    void substitute(benchmark::State &state, bool useIndex)
+    {
+        std::string dir = Inputs(int(state.range(0)));
+        std::string output = useIndex ? "indexed.tcl" : "lines.tcl";
+        for (auto _ : state)
+        {
+            if (!Run(simCenterSub, dir, output, useIndex))
+            {
+                state.SkipWithError((simCenterSub + " failed in " + dir).c_str());
+                numFailed++;
+                return;
+            }
+        }
+
+        // the line by line output is the reference, unless it was filtered out
+        std::string reference = dir + "/lines.tcl";
+        if (useIndex && std::filesystem::exists(reference) && ReadFile(dir + "/" + output) != ReadFile(reference))
+        {
+            state.SkipWithError("indexed.tcl differs from lines.tcl");
+            numFailed++;
+        }
+    }
+}
+
+BENCHMARK_CAPTURE(substitute, lines, false)
+    ->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(substitute, indexed, true)
+    ->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (argc != 2)
+    {
+        std::cerr << "Usage: TemplateSubBenchmark [Google Benchmark options] <path to simCenterSub>\n";
+        return 1;
+    }
+
+    simCenterSub = std::filesystem::absolute(argv[1]).string();
+    root = std::filesystem::temp_directory_path() / "TemplateSubBenchmark";
+    std::filesystem::remove_all(root);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    std::filesystem::remove_all(root);
+    return numFailed;
+}
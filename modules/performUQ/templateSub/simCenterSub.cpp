@@ -5,6 +5,8 @@
 #include <deque>
 #include <iterator>
 #include <string>
+#include <unordered_map>
+#include "simCenterSubIndex.h"
 
 using std::deque;
 using std::vector;
@@ -31,8 +33,85 @@ std::string replaceAllOccurrences(std::string str, const std::string& from, cons
     return str;
 }
 
+//
+// substitution with the index of a precompiled template: the template is written as it is, with the
+// placeholders of the index replaced by the RV values. returns false, without writing anything, if the
+// index can't be used and the template has to be searched line by line
+//
+
+bool substituteIndexed(const char *paramsFile, const char *templateFile, const char *indexFile, const char *outFile)
+{
+  std::size_t templateSize = 0;
+  vector<simCenterSubPlaceholder> placeholders;
+  if (!readSimCenterSubIndex(indexFile, templateSize, placeholders))
+    return false;
+
+  // the index is only valid for the template it was written for
+  std::ifstream in(templateFile, std::ios::binary);
+  if (!in.is_open())
+    return false;
+  string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (text.size() != templateSize)
+    return false;
+
+  for (const simCenterSubPlaceholder &placeholder : placeholders) {
+    string rvName = "\"RV." + placeholder.rvName + "\"";
+    if (placeholder.length != rvName.length() || text.compare(placeholder.offset, placeholder.length, rvName) != 0)
+      return false;
+  }
+
+  // RV values, a repeated RV takes its last value like in the line by line substitution
+  std::ifstream params(paramsFile);
+  if (!params.is_open())
+    return false;
+
+  std::unordered_map<string, string> values;
+  int numRVs = 0;
+  string line;
+  if (getline(params, line)) {
+    std::istringstream buf(line);
+    buf >> numRVs;
+  }
+  for (int i = 0; i < numRVs && getline(params, line); i++) {
+    std::istringstream buf(line);
+    string rvName, rvValue;
+    if (buf >> rvName >> rvValue)
+      values[rvName] = rvValue;
+  }
+
+  // the fixed segments and the values, written at once
+  string output;
+  output.reserve(text.size() + 24 * placeholders.size());
+  std::size_t pos = 0;
+  for (const simCenterSubPlaceholder &placeholder : placeholders) {
+    output.append(text, pos, placeholder.offset - pos);
+    auto value = values.find(placeholder.rvName);
+    if (value != values.end())
+      output.append(value->second);
+    else
+      output.append(text, placeholder.offset, placeholder.length);
+    pos = placeholder.offset + placeholder.length;
+  }
+  output.append(text, pos, string::npos);
+
+  std::ofstream out(outFile, std::ios::binary);
+  if (!out.is_open()) {
+    std::cerr << "ERROR: simCenterDprepro could not open: " << outFile << "\n";
+    exit(-1);
+  }
+  out.write(output.data(), output.size());
+  return true;
+}
+
 int main(int argc, char **argv)
 {
+  //
+  // with an index of the template (4th argument), substitute the placeholders it records
+  //
+
+  if (argc > 4 && substituteIndexed(argv[1], argv[2], argv[4], argv[3]))
+    exit(0);
+
   //
   // open params, in & out files
   //
@@ -0,0 +1,81 @@
+#ifndef SIMCENTER_SUB_INDEX_H
+#define SIMCENTER_SUB_INDEX_H
+
+/* precompiled templates of simCenterSub
+
+   A driver that writes a template can record where it put each RV placeholder ("RV.name",
+   quotes included) in an index file next to the template. Given the index, simCenterSub writes
+   the input of a sample as the fixed segments of the template between the placeholders and the
+   values of the RVs in one pass, instead of searching every line of the template for every RV.
+
+   ****************** index file example ******
+   simCenterSubIndex 1 38 2
+   9 8 mag
+   28 9 test
+   ********************************************
+   for the template
+     pset mag "RV.mag"
+     pset test "RV.test"
+   the header gives the version, the size of the template in bytes and the number of placeholders,
+   each following line the byte offset and length of a placeholder and the RV it is replaced by
+*/
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct simCenterSubPlaceholder {
+  std::size_t offset;
+  std::size_t length;
+  std::string rvName;
+};
+
+inline bool writeSimCenterSubIndex(const std::string &indexFile,
+                                   std::size_t templateSize,
+                                   const std::vector<simCenterSubPlaceholder> &placeholders)
+{
+  std::ofstream out(indexFile, std::ios::binary);
+  if (!out.is_open())
+    return false;
+
+  out << "simCenterSubIndex 1 " << templateSize << " " << placeholders.size() << "\n";
+  for (const simCenterSubPlaceholder &placeholder : placeholders)
+    out << placeholder.offset << " " << placeholder.length << " " << placeholder.rvName << "\n";
+
+  return out.good();
+}
+
+// reads an index, returns false if it can't be read or its placeholders are not in order and
+// inside the template
+inline bool readSimCenterSubIndex(const std::string &indexFile,
+                                  std::size_t &templateSize,
+                                  std::vector<simCenterSubPlaceholder> &placeholders)
+{
+  std::ifstream in(indexFile, std::ios::binary);
+  if (!in.is_open())
+    return false;
+
+  std::string tag;
+  int version = 0;
+  std::size_t numPlaceholders = 0;
+  if (!(in >> tag >> version >> templateSize >> numPlaceholders) || tag != "simCenterSubIndex" || version != 1)
+    return false;
+
+  placeholders.clear();
+  placeholders.reserve(numPlaceholders);
+  std::size_t end = 0;
+  for (std::size_t i = 0; i < numPlaceholders; i++) {
+    simCenterSubPlaceholder placeholder;
+    if (!(in >> placeholder.offset >> placeholder.length >> placeholder.rvName))
+      return false;
+    if (placeholder.offset < end || placeholder.offset + placeholder.length > templateSize)
+      return false;
+    end = placeholder.offset + placeholder.length;
+    placeholders.push_back(placeholder);
+  }
+
+  return true;
+}
+
+#endif // SIMCENTER_SUB_INDEX_H